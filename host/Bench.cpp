@@ -0,0 +1,365 @@
+// wrenrim-bench: микробенчмарки горячих путей (google-benchmark).
+// Загружает WrenRim/Std на мире из host/World.h и меряет Events.dispatch, передачу оберток
+// в слоты, чтение строк, wrenCall, поиск в Map по строковому ключу и сборку мусора.
+// По умолчанию пишет JSON в stdout; логи идут в stderr, чтобы не портить вывод.
+//
+//   wrenrim-bench --std=src/WrenRim/Std --benchmark_out=bench.json
+
+#include "pch.h"
+#include "World.h"
+#include "Wren/Wrappers/Wrappers.hpp"
+
+#include <benchmark/benchmark.h>
+#include <set>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+import WrenRim.Wren.ScriptRuntime;
+
+namespace
+{
+  // Вспомогательный модуль: пустые методы для wrenCall, Map и мусор для GC
+  constexpr auto bench_source = R"wren(
+import "Events" for Events
+
+class Bench {
+    static noop() {}
+    static noop(a1) {}
+    static noop(a1, a2, a3, a4) {}
+
+    static makeMap(size) {
+        var map = {}
+        for (i in 0...size) map["key%(i)"] = i
+        return map
+    }
+
+    static keysOf(map) { map.keys.toList }
+
+    static lookupAll(map, keys) {
+        var found = 0
+        for (key in keys) {
+            if (map[key] != null) found = found + 1
+        }
+        return found
+    }
+
+    static retain(count) {
+        __live = []
+        for (i in 0...count) __live.add([i, "s%(i)"])
+    }
+
+    static release() { __live = null }
+
+    static churn(count) {
+        for (i in 0...count) [i, "s%(i)"]
+    }
+
+    static listen(event, count, arity) {
+        for (i in 0...count) Events.on(event, Bench.listener(arity))
+    }
+
+    static listener(arity) {
+        if (arity == 0) return Fn.new { }
+        if (arity == 1) return Fn.new { |a1| }
+        if (arity == 2) return Fn.new { |a1, a2| }
+        if (arity == 3) return Fn.new { |a1, a2, a3| }
+        if (arity == 4) return Fn.new { |a1, a2, a3, a4| }
+        if (arity == 5) return Fn.new { |a1, a2, a3, a4, a5| }
+        if (arity == 6) return Fn.new { |a1, a2, a3, a4, a5, a6| }
+        if (arity == 7) return Fn.new { |a1, a2, a3, a4, a5, a6, a7| }
+        return Fn.new { |a1, a2, a3, a4, a5, a6, a7, a8| }
+    }
+}
+)wren";
+
+  /**
+   * @brief Общее окружение: мир, VM со Std и модулем bench, диспетчер событий.
+   */
+  struct bench_env
+  {
+    explicit bench_env(const std::string& std_path) : world(host::world_options{})
+    {
+      vm = wren::script_runtime::create_vm({std_path});
+      if (!wren::script_runtime::load_std(*vm)) throw std::runtime_error("failed to load " + std_path);
+      dispatcher.attach(*vm);
+      vm->runFromSource("bench", bench_source);
+      bench_class = vm->find("bench", "Bench");
+      raw = vm->getVm();
+    }
+
+    ~bench_env()
+    {
+      bench_class.reset();
+      dispatcher.reset();
+      vm.reset();
+    }
+
+    /**
+     * @brief Вызов Bench.<signature> без wrenbind17: хэндл класса в слот 0, аргументы — дальше.
+     */
+    WrenHandle* call_handle(const char* signature) { return wrenMakeCallHandle(raw, signature); }
+
+    void put_class()
+    {
+      wrenEnsureSlots(raw, 9);
+      wrenSetSlotHandle(raw, 0, bench_class.getHandle().getHandle());
+    }
+
+    host::world world;
+    std::unique_ptr<wrenbind17::VM> vm;
+    wren::script_runtime::event_dispatcher dispatcher;
+    wrenbind17::Variable bench_class;
+    WrenVM* raw{nullptr};
+  };
+
+  bench_env* env = nullptr;
+
+  // Events.dispatch
+
+  template<std::size_t Arity>
+  void BM_Dispatch(benchmark::State& state)
+  {
+    const auto listeners = state.range(0);
+    const std::string event_name = "Bench" + std::to_string(Arity) + "x" + std::to_string(listeners);
+    // google-benchmark вызывает функцию несколько раз, слушатели регистрируются один раз на событие
+    static std::set<std::string> registered;
+    if (registered.insert(event_name).second) {
+      env->bench_class.func("listen(_,_,_)")(event_name, static_cast<double>(listeners), static_cast<double>(Arity));
+    }
+
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+      for (auto _ : state) {
+        env->dispatcher.dispatch(event_name, static_cast<double>(Is)...);
+      }
+    }(std::make_index_sequence<Arity>{});
+
+    state.SetItemsProcessed(state.iterations());
+  }
+
+#define WRENRIM_BENCH_DISPATCH(arity) BENCHMARK_TEMPLATE(BM_Dispatch, arity)->Arg(0)->Arg(1)->Arg(10)
+
+  WRENRIM_BENCH_DISPATCH(0);
+  WRENRIM_BENCH_DISPATCH(1);
+  WRENRIM_BENCH_DISPATCH(2);
+  WRENRIM_BENCH_DISPATCH(3);
+  WRENRIM_BENCH_DISPATCH(4);
+  WRENRIM_BENCH_DISPATCH(5);
+  WRENRIM_BENCH_DISPATCH(6);
+  WRENRIM_BENCH_DISPATCH(7);
+  WRENRIM_BENCH_DISPATCH(8);
+
+#undef WRENRIM_BENCH_DISPATCH
+
+  // pushAsConstRef для каждой обертки
+
+  template<typename T>
+  T sample();
+
+  template<>
+  wren::wrappers::actor sample<wren::wrappers::actor>() { return {env->world.player}; }
+
+  template<>
+  wren::wrappers::hit_data sample<wren::wrappers::hit_data>()
+  {
+    static RE::HitData hit;
+    hit.aggressor = env->world.player->GetHandle();
+    hit.target = env->world.characters.front()->GetHandle();
+    hit.weapon = env->world.weapons.front();
+    return {&hit};
+  }
+
+  template<>
+  wren::wrappers::alchemy_item sample<wren::wrappers::alchemy_item>() { return {env->world.potions.front()}; }
+
+  template<>
+  wren::wrappers::active_effect sample<wren::wrappers::active_effect>()
+  {
+    static RE::ActiveEffect effect;
+    effect.effect = env->world.spells.front()->effects.front();
+    effect.target = env->world.player;
+    return {&effect};
+  }
+
+  template<>
+  wren::wrappers::weapon sample<wren::wrappers::weapon>() { return {env->world.weapons.front()}; }
+
+  template<>
+  wren::wrappers::armor sample<wren::wrappers::armor>() { return {env->world.armors.front()}; }
+
+  template<>
+  wren::wrappers::spell sample<wren::wrappers::spell>() { return {env->world.spells.front()}; }
+
+  template<>
+  wren::wrappers::effect sample<wren::wrappers::effect>() { return {env->world.spells.front()->effects.front()->baseEffect}; }
+
+  template<>
+  wren::wrappers::keyword sample<wren::wrappers::keyword>() { return {env->world.keywords.front()}; }
+
+  template<>
+  wren::wrappers::form sample<wren::wrappers::form>() { return {env->world.weapons.front()}; }
+
+  template<>
+  wren::wrappers::setting sample<wren::wrappers::setting>() { return {env->world.settings.front()}; }
+
+  template<>
+  wren::wrappers::gfx_value sample<wren::wrappers::gfx_value>() { return {42.0}; }
+
+  template<typename T>
+  void BM_Push(benchmark::State& state)
+  {
+    const auto value = sample<T>();
+    wrenEnsureSlots(env->raw, 1);
+    for (auto _ : state) {
+      wrenbind17::detail::pushAsConstRef<T>(env->raw, 0, value);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::actor);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::hit_data);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::alchemy_item);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::active_effect);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::weapon);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::armor);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::spell);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::effect);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::keyword);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::form);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::setting);
+  BENCHMARK_TEMPLATE(BM_Push, wren::wrappers::gfx_value);
+
+  // PopHelper<std::string> / <std::string_view>
+
+  template<typename T>
+  void BM_PopString(benchmark::State& state)
+  {
+    const std::string text(static_cast<std::size_t>(state.range(0)), 'x');
+    wrenEnsureSlots(env->raw, 1);
+    wrenSetSlotBytes(env->raw, 0, text.data(), text.size());
+    for (auto _ : state) {
+      auto value = wrenbind17::detail::PopHelper<T>::f(env->raw, 0);
+      benchmark::DoNotOptimize(value);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+  }
+
+  BENCHMARK_TEMPLATE(BM_PopString, std::string)->RangeMultiplier(8)->Range(8, 4096);
+  BENCHMARK_TEMPLATE(BM_PopString, std::string_view)->RangeMultiplier(8)->Range(8, 4096);
+
+  // wrenCall: пустой статический метод с 0, 1 и 4 аргументами
+
+  void BM_WrenCall(benchmark::State& state)
+  {
+    const auto arity = static_cast<int>(state.range(0));
+    const char* signature = arity == 0 ? "noop()" : arity == 1 ? "noop(_)" : "noop(_,_,_,_)";
+    const auto method = env->call_handle(signature);
+    for (auto _ : state) {
+      env->put_class();
+      for (int i = 1; i <= arity; ++i) wrenSetSlotDouble(env->raw, i, i);
+      benchmark::DoNotOptimize(wrenCall(env->raw, method));
+    }
+    wrenReleaseHandle(env->raw, method);
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  BENCHMARK(BM_WrenCall)->Arg(0)->Arg(1)->Arg(4);
+
+  // Поиск в Map по строковым ключам: один wrenCall на весь список ключей
+
+  void BM_MapLookup(benchmark::State& state)
+  {
+    const auto size = state.range(0);
+    const auto make_map = env->call_handle("makeMap(_)");
+    const auto keys_of = env->call_handle("keysOf(_)");
+    const auto lookup_all = env->call_handle("lookupAll(_,_)");
+
+    env->put_class();
+    wrenSetSlotDouble(env->raw, 1, static_cast<double>(size));
+    wrenCall(env->raw, make_map);
+    const auto map = wrenGetSlotHandle(env->raw, 0);
+
+    env->put_class();
+    wrenSetSlotHandle(env->raw, 1, map);
+    wrenCall(env->raw, keys_of);
+    const auto keys = wrenGetSlotHandle(env->raw, 0);
+
+    for (auto _ : state) {
+      env->put_class();
+      wrenSetSlotHandle(env->raw, 1, map);
+      wrenSetSlotHandle(env->raw, 2, keys);
+      wrenCall(env->raw, lookup_all);
+    }
+
+    for (const auto handle : {keys, map, lookup_all, keys_of, make_map}) wrenReleaseHandle(env->raw, handle);
+    state.SetItemsProcessed(state.iterations() * size);
+  }
+
+  BENCHMARK(BM_MapLookup)->RangeMultiplier(16)->Range(16, 4096);
+
+  // GC. В Wren только полная сборка mark-sweep, поэтому вместо частичной сборки меряется
+  // полная сборка двух видов: большая живая куча (стоимость пометки) и много мусора (стоимость очистки)
+
+  void BM_GcLive(benchmark::State& state)
+  {
+    env->bench_class.func("retain(_)")(static_cast<double>(state.range(0)));
+    wrenCollectGarbage(env->raw);
+    for (auto _ : state) {
+      wrenCollectGarbage(env->raw);
+    }
+    env->bench_class.func("release()")();
+    wrenCollectGarbage(env->raw);
+    state.counters["live"] = static_cast<double>(state.range(0));
+  }
+
+  BENCHMARK(BM_GcLive)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+  void BM_GcGarbage(benchmark::State& state)
+  {
+    auto churn = env->bench_class.func("churn(_)");
+    const auto count = static_cast<double>(state.range(0));
+    wrenCollectGarbage(env->raw);
+    for (auto _ : state) {
+      state.PauseTiming();
+      churn(count);
+      state.ResumeTiming();
+      wrenCollectGarbage(env->raw);
+    }
+    state.counters["garbage"] = count;
+  }
+
+  BENCHMARK(BM_GcGarbage)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+}
+
+int main(int argc, char** argv)
+{
+  // JSON по умолчанию, если формат не задан явно
+  std::vector<char*> args(argv, argv + argc);
+  std::string std_path = "src/WrenRim/Std";
+  bool has_format = false;
+  std::erase_if(args, [&](const char* arg) {
+    const std::string_view view = arg;
+    if (view.starts_with("--std=")) {
+      std_path = view.substr(6);
+      return true;
+    }
+    has_format |= view.starts_with("--benchmark_format=");
+    return false;
+  });
+  std::string json_format = "--benchmark_format=json";
+  if (!has_format) args.push_back(json_format.data());
+
+  int count = static_cast<int>(args.size());
+  benchmark::Initialize(&count, args.data());
+  if (benchmark::ReportUnrecognizedArguments(count, args.data())) return 1;
+
+  spdlog::set_default_logger(spdlog::stderr_color_st("wrenrim-bench"));
+  spdlog::set_level(spdlog::level::warn);
+
+  benchmark::AddCustomContext("wrenrim_std", std_path);
+
+  bench_env environment(std_path);
+  env = &environment;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  env = nullptr;
+  return 0;
+}
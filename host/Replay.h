@@ -0,0 +1,293 @@
+#pragma once
+
+// Воспроизведение записи событий (*.wrev) на хосте.
+// По снимкам из записи строятся объекты-заглушки RE, поэтому обертки возвращают записанные значения.
+// Каждый подписчик вызывается отдельно через ReplayProbe, время считается по подписчику и по событию.
+
+#include "pch.h"
+#include "Wren/EventRecorder.hpp"
+#include "Wren/Wrappers/Wrappers.hpp"
+
+#include <deque>
+
+namespace host
+{
+  namespace rec = wren::event_record;
+
+  /**
+   * @brief Объекты-заглушки, восстановленные из снимков записи.
+   */
+  class replay_world
+  {
+  public:
+    RE::Actor* actor(const rec::actor_snapshot& s)
+    {
+      if (!s.handle) return nullptr;
+
+      auto& a = actors_[s.handle];
+      if (!a) {
+        auto base = keep(std::make_unique<RE::TESNPC>(0, RE::FormType::kNPC, "", s.name));
+        if (s.is_player) {
+          auto player = keep(std::make_unique<RE::PlayerCharacter>(s.form_id, base));
+          RE::stub::set_player(player);
+          a = player;
+        }
+        else {
+          a = keep(std::make_unique<RE::Character>(s.form_id, base));
+          RE::stub::register_actor(a);
+        }
+      }
+
+      a->position = {s.position[0], s.position[1], s.position[2]};
+      a->angleZ = s.heading;
+      a->dead = s.dead;
+      a->inCombat = s.in_combat;
+      // Значения AV — как в записи: база = записанное текущее значение, модификаторы сброшены
+      const RE::ActorValue avs[] = {RE::ActorValue::kHealth, RE::ActorValue::kMagicka, RE::ActorValue::kStamina};
+      for (std::size_t i = 0; i < std::size(avs); ++i) {
+        const auto av = std::to_underlying(avs[i]);
+        a->base_values[av] = s.values[i];
+        a->modifiers[av] = {};
+      }
+      wren::wrappers::actor_grid::get_singleton()->update(a);
+      return a;
+    }
+
+    RE::AlchemyItem* alchemy_item(const rec::alchemy_item_snapshot& s)
+    {
+      auto& item = items_[s.form_id];
+      if (!item) {
+        item = form(std::make_unique<RE::AlchemyItem>(s.form_id, RE::FormType::kAlchemyItem, "", s.name));
+        if (s.poison) item->data.flags.set(RE::AlchemyItem::Data::Flag::kPoison);
+        if (s.food) item->data.flags.set(RE::AlchemyItem::Data::Flag::kFoodItem);
+      }
+      return item;
+    }
+
+    RE::ActiveEffect* active_effect(const rec::active_effect_snapshot& s)
+    {
+      auto& effect = effects_.emplace_back();
+      effect.baseEffect = effect_setting(s.base_effect);
+      effect.effectItem.magnitude = s.magnitude;
+
+      auto& active = active_effects_.emplace_back();
+      active.effect = &effect;
+      active.magnitude = s.magnitude;
+      active.duration = s.duration;
+      active.elapsedSeconds = s.elapsed;
+      if (const auto caster = actor(s.caster)) active.caster = caster->GetHandle();
+      if (const auto target = actor(s.target)) active.target = target->AsMagicTarget();
+      return &active;
+    }
+
+    RE::HitData* hit_data(const rec::hit_data_snapshot& s)
+    {
+      auto& hit = hits_.emplace_back();
+      if (const auto aggressor = actor(s.aggressor)) hit.aggressor = aggressor->GetHandle();
+      if (const auto target = actor(s.target)) {
+        hit.target = target->GetHandle();
+        hit.hitPosition = target->GetPosition();
+      }
+      hit.totalDamage = s.total_damage;
+      hit.physicalDamage = s.physical_damage;
+      hit.weapon = weapon(s.weapon);
+      return &hit;
+    }
+
+  private:
+    template<typename T>
+    T* keep(std::unique_ptr<T> object)
+    {
+      const auto ptr = object.get();
+      storage_.emplace_back(std::move(object));
+      return ptr;
+    }
+
+    template<typename T>
+    T* form(std::unique_ptr<T> object)
+    {
+      const auto ptr = keep(std::move(object));
+      RE::stub::register_form(ptr);
+      return ptr;
+    }
+
+    RE::EffectSetting* effect_setting(const RE::FormID form_id)
+    {
+      if (!form_id) return nullptr;
+      auto& setting = effect_settings_[form_id];
+      if (!setting) setting = form(std::make_unique<RE::EffectSetting>(form_id, RE::FormType::kMagicEffect, "", ""));
+      return setting;
+    }
+
+    RE::TESObjectWEAP* weapon(const RE::FormID form_id)
+    {
+      if (!form_id) return nullptr;
+      auto& w = weapons_[form_id];
+      if (!w) w = form(std::make_unique<RE::TESObjectWEAP>(form_id, RE::FormType::kWeapon, "", ""));
+      return w;
+    }
+
+    std::unordered_map<std::uint32_t, RE::Actor*> actors_;
+    std::unordered_map<RE::FormID, RE::AlchemyItem*> items_;
+    std::unordered_map<RE::FormID, RE::EffectSetting*> effect_settings_;
+    std::unordered_map<RE::FormID, RE::TESObjectWEAP*> weapons_;
+    // Скрипты могут сохранить обертку, поэтому эффекты и удары живут до конца воспроизведения
+    std::deque<RE::Effect> effects_;
+    std::deque<RE::ActiveEffect> active_effects_;
+    std::deque<RE::HitData> hits_;
+    std::vector<std::shared_ptr<void>> storage_;
+  };
+
+  struct replay_stats
+  {
+    std::uint64_t count{0};
+    std::uint64_t total_ns{0};
+    std::uint64_t max_ns{0};
+    std::uint64_t errors{0};
+
+    void add(const std::uint64_t ns)
+    {
+      ++count;
+      total_ns += ns;
+      max_ns = std::max(max_ns, ns);
+    }
+  };
+
+  /**
+   * @brief Подает события записи в VM с полной скоростью.
+   */
+  class replayer
+  {
+  public:
+    explicit replayer(wrenbind17::VM& vm) : vm_(vm.getVm())
+    {
+      std::string source = "import \"Events\" for Events\n\nclass ReplayProbe {\n";
+      source += "    static count(event) { Events.listeners(event).count }\n";
+      for (std::size_t arity = 0; arity < call_handles_.size(); ++arity) {
+        std::string params;
+        for (std::size_t i = 1; i <= arity; ++i) params += (i > 1 ? ", a" : "a") + std::to_string(i);
+        source += "    static call(event, i" + (arity ? ", " + params : "") + ") { Events.listeners(event)[i].call(" +
+                  params + ") }\n";
+      }
+      source += "}\n";
+      vm.runFromSource("replay_probe", source);
+
+      probe_ = vm.find("replay_probe", "ReplayProbe");
+      count_handle_ = wrenMakeCallHandle(vm_, "count(_)");
+      for (std::size_t arity = 0; arity < call_handles_.size(); ++arity) {
+        std::string signature = "call(_,_";
+        for (std::size_t i = 0; i < arity; ++i) signature += ",_";
+        call_handles_[arity] = wrenMakeCallHandle(vm_, (signature + ")").c_str());
+      }
+    }
+
+    ~replayer()
+    {
+      wrenReleaseHandle(vm_, count_handle_);
+      for (const auto handle : call_handles_) wrenReleaseHandle(vm_, handle);
+    }
+
+    replayer(const replayer&) = delete;
+    replayer& operator=(const replayer&) = delete;
+
+    /**
+     * @brief Воспроизводит запись. false — файл не читается.
+     */
+    bool run(const std::filesystem::path& path)
+    {
+      std::vector<rec::event> events;
+      if (!rec::read_file(path, names_, events)) {
+        logger::error("Replay: can't read {}", path.string());
+        return false;
+      }
+      logger::info("Replay: {} events, {} event names", events.size(), names_.size());
+
+      std::uint32_t frame = UINT32_MAX;
+      for (const auto& e : events) {
+        if (e.frame != frame) {
+          frame = e.frame;
+          ++frames_;
+          RE::stub::advance_time(1.f / 60.f);
+          wren::wrappers::command_buffer::get_singleton()->flush();
+          wren::wrappers::actor_grid::get_singleton()->on_frame_start();
+          wren::wrappers::actor_handle_cache::get_singleton()->on_frame_start();
+        }
+        if (e.id < names_.size()) dispatch(names_[e.id], e.args);
+      }
+      return true;
+    }
+
+    [[nodiscard]] std::uint32_t frames() const { return frames_; }
+    [[nodiscard]] const std::map<std::string, replay_stats>& events() const { return event_stats_; }
+    [[nodiscard]] const std::map<std::string, replay_stats>& listeners() const { return listener_stats_; }
+
+  private:
+    void dispatch(const std::string& event_name, const std::vector<rec::arg_value>& args)
+    {
+      const auto arity = std::min(args.size(), call_handles_.size() - 1);
+
+      wrenEnsureSlots(vm_, 2);
+      wrenSetSlotHandle(vm_, 0, probe_.getHandle().getHandle());
+      wrenSetSlotString(vm_, 1, event_name.c_str());
+      if (wrenCall(vm_, count_handle_) != WREN_RESULT_SUCCESS) return;
+      const auto count = static_cast<std::size_t>(wrenGetSlotDouble(vm_, 0));
+
+      auto& event = event_stats_[event_name];
+      std::uint64_t event_ns = 0;
+      for (std::size_t i = 0; i < count; ++i) {
+        auto& listener = listener_stats_[event_name + "[" + std::to_string(i) + "]"];
+
+        wrenEnsureSlots(vm_, static_cast<int>(3 + arity));
+        wrenSetSlotHandle(vm_, 0, probe_.getHandle().getHandle());
+        wrenSetSlotString(vm_, 1, event_name.c_str());
+        wrenSetSlotDouble(vm_, 2, static_cast<double>(i));
+        for (std::size_t a = 0; a < arity; ++a) push(static_cast<int>(3 + a), args[a]);
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = wrenCall(vm_, call_handles_[arity]);
+        const auto ns = static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+        listener.add(ns);
+        event_ns += ns;
+        if (result != WREN_RESULT_SUCCESS) {
+          ++listener.errors;
+          ++event.errors;
+        }
+      }
+      event.add(event_ns);
+    }
+
+    void push(const int slot, const rec::arg_value& value)
+    {
+      namespace detail = wrenbind17::detail;
+      std::visit(
+        [&]<typename T>(const T& v) {
+          if constexpr (std::is_same_v<T, std::monostate>) wrenSetSlotNull(vm_, slot);
+          else if constexpr (std::is_same_v<T, double>) wrenSetSlotDouble(vm_, slot, v);
+          else if constexpr (std::is_same_v<T, bool>) wrenSetSlotBool(vm_, slot, v);
+          else if constexpr (std::is_same_v<T, std::string>) wrenSetSlotBytes(vm_, slot, v.data(), v.size());
+          else if constexpr (std::is_same_v<T, rec::actor_snapshot>)
+            detail::pushAsConstRef(vm_, slot, wren::wrappers::actor(world_.actor(v)));
+          else if constexpr (std::is_same_v<T, rec::alchemy_item_snapshot>)
+            detail::pushAsConstRef(vm_, slot, wren::wrappers::alchemy_item(world_.alchemy_item(v)));
+          else if constexpr (std::is_same_v<T, rec::active_effect_snapshot>)
+            detail::pushAsConstRef(vm_, slot, wren::wrappers::active_effect(world_.active_effect(v)));
+          else if constexpr (std::is_same_v<T, rec::hit_data_snapshot>)
+            detail::pushAsConstRef(vm_, slot, wren::wrappers::hit_data(world_.hit_data(v)));
+        },
+        value);
+    }
+
+    WrenVM* vm_;
+    wrenbind17::Variable probe_;
+    WrenHandle* count_handle_{nullptr};
+    // call(event, i) .. call(event, i, a1..a8)
+    std::array<WrenHandle*, 9> call_handles_{};
+    std::vector<std::string> names_;
+    replay_world world_;
+    std::uint32_t frames_{0};
+    std::map<std::string, replay_stats> event_stats_;
+    std::map<std::string, replay_stats> listener_stats_;
+  };
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+// Синтетический мир wrenrim-host: ключевые слова, расы, NPC, актеры, оружие,
+// зелья, эффекты и заклинания. Все формы регистрируются в RE::stub и живут до конца процесса.
+
+#include "pch.h"
+
+#include <random>
+
+namespace host
+{
+  struct world_options
+  {
+    std::uint32_t actors{32};
+    std::uint32_t seed{1};
+    // Сторона квадрата, в котором расставляются актеры (игровые единицы)
+    float area{8192.f};
+  };
+
+  class world
+  {
+  public:
+    explicit world(const world_options& options) : rng_(options.seed)
+    {
+      auto& s = RE::stub::get();
+
+      auto file = make<RE::TESFile>();
+      file->fileName = "Skyrim.esm";
+      file->compileIndex = 0;
+      s.data_handler.files.push_back(file);
+
+      auto plugin = make<RE::TESFile>();
+      plugin->fileName = "WrenRimHost.esp";
+      plugin->compileIndex = 1;
+      s.data_handler.files.push_back(plugin);
+
+      for (const auto name : {"ActorTypeNPC", "ActorTypeUndead", "ActorTypeDaedra", "WeapTypeSword", "WeapTypeBow",
+                              "MagicDamageFire", "MagicDamageFrost", "MagicRestoreHealth", "VendorItemPotion",
+                              "VendorItemPoison"}) {
+        keywords.push_back(form<RE::BGSKeyword>(RE::FormType::kKeyword, name, ""));
+      }
+
+      auto nord = form<RE::TESRace>(RE::FormType::kRace, "NordRace", "Nord");
+      nord->AddKeyword(keyword("ActorTypeNPC"));
+      auto draugr = form<RE::TESRace>(RE::FormType::kRace, "DraugrRace", "Draugr");
+      draugr->AddKeyword(keyword("ActorTypeUndead"));
+      races = {nord, draugr};
+
+      auto sword = form<RE::TESObjectWEAP>(RE::FormType::kWeapon, "IronSword", "Iron Sword");
+      sword->attackDamage = 7;
+      sword->weight = 9.f;
+      sword->value = 25;
+      sword->AddKeyword(keyword("WeapTypeSword"));
+      auto bow = form<RE::TESObjectWEAP>(RE::FormType::kWeapon, "HuntingBow", "Hunting Bow");
+      bow->attackDamage = 7;
+      bow->speed = 0.9375f;
+      bow->weight = 7.f;
+      bow->value = 50;
+      bow->AddKeyword(keyword("WeapTypeBow"));
+      weapons = {sword, bow};
+
+      auto cuirass = form<RE::TESObjectARMO>(RE::FormType::kArmor, "ArmorIronCuirass", "Iron Armor");
+      cuirass->armorRating = 2500;
+      cuirass->armorType = RE::BIPED_MODEL::ArmorType::kHeavyArmor;
+      cuirass->weight = 30.f;
+      cuirass->value = 125;
+      armors = {cuirass};
+
+      auto fire = magic_effect("FireDamageFFAimed", "Fire Damage", "MagicDamageFire", RE::ActorValue::kHealth, true);
+      auto frost = magic_effect("FrostDamageFFAimed", "Frost Damage", "MagicDamageFrost", RE::ActorValue::kHealth, true);
+      auto heal = magic_effect("RestoreHealthFFSelf", "Restore Health", "MagicRestoreHealth", RE::ActorValue::kHealth, false);
+
+      spells = {spell("Firebolt", "Firebolt", fire, 25.f, 41.f), spell("IceSpike", "Ice Spike", frost, 25.f, 48.f),
+                spell("Healing", "Healing", heal, 10.f, 20.f)};
+
+      auto health_potion = form<RE::AlchemyItem>(RE::FormType::kAlchemyItem, "RestoreHealth01", "Potion of Minor Healing");
+      health_potion->effects.push_back(effect(heal, 25.f, 0, 0.f));
+      health_potion->AddKeyword(keyword("VendorItemPotion"));
+      auto poison = form<RE::AlchemyItem>(RE::FormType::kAlchemyItem, "DamageHealth01", "Weak Poison");
+      poison->data.flags.set(RE::AlchemyItem::Data::Flag::kPoison);
+      poison->effects.push_back(effect(fire, 10.f, 0, 0.f));
+      poison->AddKeyword(keyword("VendorItemPoison"));
+      potions = {health_potion, poison};
+
+      for (const auto& [name, value] : {std::pair{"fCombatDistance", 2048.0}, std::pair{"fJumpHeightMin", 76.0}}) {
+        auto setting = make<RE::Setting>();
+        setting->name = name;
+        setting->type = RE::Setting::Type::kFloat;
+        setting->number = value;
+        RE::stub::register_setting(setting);
+        settings.push_back(setting);
+      }
+
+      std::uniform_real_distribution<float> position(-options.area / 2.f, options.area / 2.f);
+
+      auto player_base = form<RE::TESNPC>(RE::FormType::kNPC, "Player", "Prisoner");
+      player_base->race = nord;
+      player = actor<RE::PlayerCharacter>(0x14, player_base);
+      RE::stub::set_player(player);
+
+      for (std::uint32_t i = 0; i < options.actors; ++i) {
+        const auto race = races[i % races.size()];
+        auto base = form<RE::TESNPC>(RE::FormType::kNPC, "HostNPC" + std::to_string(i), race->fullName + " " + std::to_string(i));
+        base->race = race;
+        auto npc = actor<RE::Character>(next_ref_id_++, base);
+        npc->position = {position(rng_), position(rng_), 0.f};
+        npc->inCombat = i % 3 == 0;
+        npc->hostile = race == draugr;
+        RE::stub::register_actor(npc);
+        characters.push_back(npc);
+      }
+    }
+
+    [[nodiscard]] RE::BGSKeyword* keyword(const std::string_view editor_id) const
+    {
+      const auto it = std::ranges::find_if(keywords, [&](const auto kw) { return kw->editorID == editor_id; });
+      return it != keywords.end() ? *it : nullptr;
+    }
+
+    [[nodiscard]] std::mt19937& rng() { return rng_; }
+
+    template<typename T>
+    [[nodiscard]] T* pick(const std::vector<T*>& items)
+    {
+      return items[std::uniform_int_distribution<std::size_t>(0, items.size() - 1)(rng_)];
+    }
+
+    /**
+     * @brief Все актеры мира, игрок первым.
+     */
+    [[nodiscard]] std::vector<RE::Actor*> all_actors() const
+    {
+      std::vector<RE::Actor*> result{player};
+      result.insert(result.end(), characters.begin(), characters.end());
+      return result;
+    }
+
+    std::vector<RE::BGSKeyword*> keywords;
+    std::vector<RE::TESRace*> races;
+    std::vector<RE::TESObjectWEAP*> weapons;
+    std::vector<RE::TESObjectARMO*> armors;
+    std::vector<RE::SpellItem*> spells;
+    std::vector<RE::AlchemyItem*> potions;
+    std::vector<RE::Setting*> settings;
+    RE::PlayerCharacter* player{nullptr};
+    std::vector<RE::Character*> characters;
+
+  private:
+    template<typename T, typename... Args>
+    T* make(Args&&... args)
+    {
+      auto object = std::make_shared<T>(std::forward<Args>(args)...);
+      storage_.push_back(object);
+      return object.get();
+    }
+
+    template<typename T>
+    T* form(const RE::FormType type, std::string editor_id, std::string name)
+    {
+      auto result = make<T>(next_form_id_++, type, std::move(editor_id), std::move(name));
+      RE::stub::register_form(result);
+      return result;
+    }
+
+    template<typename T>
+    T* actor(const RE::FormID form_id, RE::TESNPC* base)
+    {
+      auto result = make<T>(form_id, base);
+      for (const auto av : {RE::ActorValue::kHealth, RE::ActorValue::kMagicka, RE::ActorValue::kStamina}) {
+        result->base_values[std::to_underlying(av)] = 100.f;
+      }
+      return result;
+    }
+
+    RE::EffectSetting* magic_effect(std::string editor_id, std::string name, const std::string_view keyword_id,
+                                    const RE::ActorValue av, const bool hostile)
+    {
+      auto result = form<RE::EffectSetting>(RE::FormType::kMagicEffect, std::move(editor_id), std::move(name));
+      result->data.primaryAV = av;
+      result->data.baseCost = hostile ? 0.7f : 0.35f;
+      if (hostile) {
+        result->data.flags.set(RE::EffectSetting::EffectSettingData::Flag::kHostile,
+                               RE::EffectSetting::EffectSettingData::Flag::kDetrimental);
+        result->data.associatedSkill = static_cast<RE::ActorValue>(20);  // Destruction
+      } else {
+        result->data.flags.set(RE::EffectSetting::EffectSettingData::Flag::kRecover);
+        result->data.associatedSkill = static_cast<RE::ActorValue>(22);  // Restoration
+      }
+      result->AddKeyword(keyword(keyword_id));
+      return result;
+    }
+
+    RE::Effect* effect(RE::EffectSetting* base, const float magnitude, const std::uint32_t duration, const float cost)
+    {
+      auto result = make<RE::Effect>();
+      result->baseEffect = base;
+      result->effectItem.magnitude = magnitude;
+      result->effectItem.duration = duration;
+      result->cost = cost;
+      return result;
+    }
+
+    RE::SpellItem* spell(std::string editor_id, std::string name, RE::EffectSetting* base, const float magnitude,
+                         const float cost)
+    {
+      auto result = form<RE::SpellItem>(RE::FormType::kSpell, std::move(editor_id), std::move(name));
+      result->effects.push_back(effect(base, magnitude, base->IsHostile() ? 0 : 5, cost));
+      return result;
+    }
+
+    std::mt19937 rng_;
+    // Формы 0x01000800+ принадлежат WrenRimHost.esp, ссылки 0xFF000000+ — созданные в игре
+    RE::FormID next_form_id_{0x01000800};
+    RE::FormID next_ref_id_{0xFF000800};
+    std::vector<std::shared_ptr<void>> storage_;
+  };
+}
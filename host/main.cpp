@@ -0,0 +1,474 @@
+// wrenrim-host: запуск WrenRim/Std и модов вне игры.
+// Мир из host/World.h, события подаются так же, как хуки в src/Core/Hooks.cpp:
+// OnUpdate*Start/End для каждого актера каждый кадр, удары, зелья и эффекты с заданной частотой.
+// --record пишет поданные события в файл, --replay воспроизводит такой файл (в том числе записанный в игре).
+// --trace пишет трассировку всех кадров в формате Chrome trace.
+// --profile пишет сэмплы стеков скриптов за весь прогон в формате folded stacks (flame graph).
+// --heap-snapshot пишет снимок кучи Wren после прогона, --heap-diff сравнивает два снимка и выходит.
+// --eval выполняет строку консоли (как в меню SKSE, включая :bench) после прогона; можно повторять.
+
+#include "pch.h"
+#include "Replay.h"
+#include "World.h"
+#include "Wren/Console.hpp"
+#include "Wren/EventRecorder.hpp"
+#include "Wren/HeapSnapshot.hpp"
+#include "Wren/Profiler.hpp"
+#include "Wren/Tracer.hpp"
+#include "Wren/Worker.hpp"
+#include "Wren/Wrappers/Wrappers.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <optional>
+
+import WrenRim.Wren.ScriptRuntime;
+
+namespace
+{
+  using clock = std::chrono::steady_clock;
+
+  struct options
+  {
+    std::string std_path{"src/WrenRim/Std"};
+    std::string mods_path{"src/WrenRim/WrenMods"};
+    std::uint32_t frames{600};
+    float fps{60.f};
+    // Событий в секунду игрового времени
+    float hits{10.f};
+    float potions{1.f};
+    float effects{5.f};
+    bool quiet{false};
+    std::string record_path;
+    std::string replay_path;
+    std::string trace_path;
+    std::string profile_path;
+    std::string heap_snapshot_path;
+    std::vector<std::string> eval_lines;
+    // Пара снимков для --heap-diff
+    std::string heap_diff_before;
+    std::string heap_diff_after;
+    host::world_options world;
+  };
+
+  struct event_stats
+  {
+    std::uint64_t count{0};
+    std::uint64_t total_ns{0};
+    std::uint64_t max_ns{0};
+    std::uint64_t errors{0};
+  };
+
+  // Сумма command_buffer::stats за прогон
+  struct command_stats
+  {
+    std::uint64_t recorded{0};
+    std::uint64_t applied{0};
+    std::uint64_t skipped{0};
+  };
+
+  void print_usage()
+  {
+    std::puts("usage: wrenrim-host [--std DIR] [--mods DIR] [--frames N] [--fps N] [--actors N]\n"
+              "                    [--hits N/s] [--potions N/s] [--effects N/s] [--seed N] [--quiet]\n"
+              "                    [--record FILE.wrev] [--replay FILE.wrev] [--trace FILE.json]\n"
+              "                    [--profile FILE.folded] [--heap-snapshot FILE.json]\n"
+              "                    [--eval LINE]...\n"
+              "       wrenrim-host --heap-diff OLD.json NEW.json");
+  }
+
+  template<typename T>
+  bool parse_number(const std::string_view text, T& out)
+  {
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc() && ptr == text.data() + text.size();
+  }
+
+  bool parse_options(const int argc, char** argv, options& out)
+  {
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view arg = argv[i];
+      if (arg == "--quiet") {
+        out.quiet = true;
+        continue;
+      }
+      if (arg == "--heap-diff") {
+        if (i + 2 >= argc) return false;
+        out.heap_diff_before = argv[++i];
+        out.heap_diff_after = argv[++i];
+        continue;
+      }
+      if (arg == "--help" || arg == "-h" || i + 1 >= argc) return false;
+
+      const std::string_view value = argv[++i];
+      bool ok = true;
+      if (arg == "--std") out.std_path = value;
+      else if (arg == "--mods") out.mods_path = value;
+      else if (arg == "--frames") ok = parse_number(value, out.frames);
+      else if (arg == "--fps") ok = parse_number(value, out.fps) && out.fps > 0.f;
+      else if (arg == "--actors") ok = parse_number(value, out.world.actors);
+      else if (arg == "--hits") ok = parse_number(value, out.hits);
+      else if (arg == "--potions") ok = parse_number(value, out.potions);
+      else if (arg == "--effects") ok = parse_number(value, out.effects);
+      else if (arg == "--seed") ok = parse_number(value, out.world.seed);
+      else if (arg == "--record") out.record_path = value;
+      else if (arg == "--replay") out.replay_path = value;
+      else if (arg == "--trace") out.trace_path = value;
+      else if (arg == "--profile") out.profile_path = value;
+      else if (arg == "--heap-snapshot") out.heap_snapshot_path = value;
+      else if (arg == "--eval") out.eval_lines.emplace_back(value);
+      else ok = false;
+
+      if (!ok) {
+        std::fprintf(stderr, "invalid option: %.*s %.*s\n", static_cast<int>(arg.size()), arg.data(),
+                     static_cast<int>(value.size()), value.data());
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Подает события в Events.dispatch и собирает время по каждому имени события.
+   */
+  class driver
+  {
+  public:
+    driver(host::world& world, wren::script_runtime::event_dispatcher& dispatcher) :
+        world_(world), dispatcher_(dispatcher)
+    {
+    }
+
+    void frame(const float delta, const options& opt)
+    {
+      RE::stub::advance_time(delta);
+      wren::tracing::tracer::get_singleton()->on_frame_start();
+      wren::event_record::recorder::get_singleton()->on_frame_start();
+      const auto commands = wren::wrappers::command_buffer::get_singleton();
+      commands->flush();
+      commands_.recorded += commands->last_stats().recorded;
+      commands_.applied += commands->last_stats().applied;
+      commands_.skipped += commands->last_stats().skipped;
+      wren::wrappers::actor_grid::get_singleton()->on_frame_start();
+      wren::wrappers::actor_handle_cache::get_singleton()->on_frame_start();
+      wren::wrappers::active_effect_index::get_singleton()->on_frame_start();
+
+      // Без бюджета кадра: в хосте доставляются все готовые ответы
+      wren::workers::result r;
+      while (wren::workers::pool::get_singleton()->take(r)) {
+        wren::wrappers::worker w(std::move(r.worker));
+        if (r.error.empty()) dispatch("OnWorkerMessage", w, wren::wrappers::storage_entry{&r.bytes});
+        else dispatch("OnWorkerError", w, r.error);
+      }
+
+      for (const auto a : world_.all_actors()) {
+        wren::wrappers::actor_grid::get_singleton()->update(a);
+        wren::wrappers::actor wren_actor(a);
+        const bool player = a->IsPlayerRef();
+        dispatch(player ? "OnUpdatePlayerStart" : "OnUpdateCharacterStart", wren_actor, delta);
+        dispatch(player ? "OnUpdatePlayerEnd" : "OnUpdateCharacterEnd", wren_actor, delta);
+      }
+
+      for (auto n = due(hits_carry_, opt.hits, delta); n > 0; --n) weapon_hit();
+      for (auto n = due(potions_carry_, opt.potions, delta); n > 0; --n) drink_potion();
+      for (auto n = due(effects_carry_, opt.effects, delta); n > 0; --n) add_effect();
+      expire_effects(delta);
+    }
+
+    [[nodiscard]] const std::map<std::string, event_stats>& stats() const { return stats_; }
+    [[nodiscard]] const command_stats& commands() const { return commands_; }
+
+  private:
+    template<typename... Args>
+    void dispatch(const std::string& event_name, Args&&... args)
+    {
+      if (const auto recorder = wren::event_record::recorder::get_singleton(); recorder->recording()) {
+        recorder->record(event_name, args...);
+      }
+
+      auto& s = stats_[event_name];
+      const auto start = clock::now();
+      try {
+        wren::tracing::zone zone(wren::tracing::category::kDispatch, event_name);
+        dispatcher_.dispatch(event_name, std::forward<Args>(args)...);
+      }
+      catch (const std::exception& e) {
+        ++s.errors;
+        logger::error("Wren Error in {}: {}", event_name, e.what());
+      }
+      const auto ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+      ++s.count;
+      s.total_ns += ns;
+      s.max_ns = std::max(s.max_ns, ns);
+    }
+
+    // Число событий за кадр при заданной частоте; дробная часть переносится на следующий кадр
+    static std::uint32_t due(float& carry, const float rate, const float delta)
+    {
+      carry += rate * delta;
+      const auto n = static_cast<std::uint32_t>(carry);
+      carry -= static_cast<float>(n);
+      return n;
+    }
+
+    RE::Actor* random_actor() { return world_.pick(world_.all_actors()); }
+
+    void weapon_hit()
+    {
+      auto aggressor = random_actor();
+      auto target = random_actor();
+      if (aggressor == target) return;
+
+      RE::HitData hit;
+      hit.aggressor = aggressor->GetHandle();
+      hit.target = target->GetHandle();
+      hit.weapon = world_.pick(world_.weapons);
+      hit.physicalDamage = static_cast<float>(hit.weapon->GetAttackDamage());
+      hit.totalDamage = hit.physicalDamage * std::uniform_real_distribution<float>(0.5f, 2.f)(world_.rng());
+      hit.hitPosition = target->GetPosition();
+
+      wren::wrappers::hit_data wren_hit_data(&hit);
+      dispatch("OnWeaponHitStart", wren_hit_data);
+      target->DamageActorValue(RE::ActorValue::kHealth, hit.totalDamage);
+      dispatch("OnWeaponHitEnd", wren_hit_data);
+    }
+
+    void drink_potion()
+    {
+      auto a = random_actor();
+      wren::wrappers::actor wren_actor(a);
+      wren::wrappers::alchemy_item wren_alchemy_item(world_.pick(world_.potions));
+      const bool player = a->IsPlayerRef();
+      dispatch(player ? "OnDrinkPotionPlayerStart" : "OnDrinkPotionCharacterStart", wren_actor, wren_alchemy_item);
+      dispatch(player ? "OnDrinkPotionPlayerEnd" : "OnDrinkPotionCharacterEnd", wren_actor, wren_alchemy_item);
+    }
+
+    void add_effect()
+    {
+      auto caster = random_actor();
+      auto target = random_actor();
+      const auto spell = world_.pick(world_.spells);
+      const auto effect = spell->effects.front();
+
+      auto active = std::make_unique<RE::ActiveEffect>();
+      active->caster = caster->GetHandle();
+      active->target = target->AsMagicTarget();
+      active->effect = effect;
+      active->magnitude = effect->effectItem.magnitude;
+      active->duration = static_cast<float>(std::max<std::uint32_t>(effect->effectItem.duration, 1));
+
+      const auto magic_target = target->AsMagicTarget();
+      wren::wrappers::active_effect wren_active_effect(active.get());
+      const bool player = target->IsPlayerRef();
+
+      dispatch(player ? "OnEffectAddedPlayerStart" : "OnEffectAddedCharacterStart", wren_active_effect);
+      target->activeEffects.push_back(active.get());
+      wren::wrappers::active_effect_index::get_singleton()->mark_stale(magic_target);
+      dispatch(player ? "OnEffectAddedPlayerEnd" : "OnEffectAddedCharacterEnd", wren_active_effect);
+
+      live_effects_.push_back(std::move(active));
+    }
+
+    void expire_effects(const float delta)
+    {
+      std::erase_if(live_effects_, [&](const std::unique_ptr<RE::ActiveEffect>& effect) {
+        effect->elapsedSeconds += delta;
+        if (effect->elapsedSeconds < effect->duration) return false;
+
+        const auto target = effect->target;
+        std::erase(*target->GetActiveEffectList(), effect.get());
+        wren::wrappers::active_effect_index::get_singleton()->mark_stale(target);
+        return true;
+      });
+    }
+
+    host::world& world_;
+    wren::script_runtime::event_dispatcher& dispatcher_;
+    std::map<std::string, event_stats> stats_;
+    command_stats commands_;
+    std::vector<std::unique_ptr<RE::ActiveEffect>> live_effects_;
+    float hits_carry_{0.f};
+    float potions_carry_{0.f};
+    float effects_carry_{0.f};
+  };
+
+  template<typename Stats>
+  void print_table(const char* title, const std::map<std::string, Stats>& stats)
+  {
+    std::puts("");
+    std::printf("%-32s %10s %8s %12s %10s %10s\n", title, "count", "errors", "total us", "avg us", "max us");
+    for (const auto& [name, s] : stats) {
+      std::printf("%-32s %10llu %8llu %12.1f %10.2f %10.1f\n", name.c_str(), static_cast<unsigned long long>(s.count),
+                  static_cast<unsigned long long>(s.errors), s.total_ns / 1000.0,
+                  s.count ? s.total_ns / 1000.0 / static_cast<double>(s.count) : 0.0, s.max_ns / 1000.0);
+    }
+  }
+
+  void print_heap_diff(const wren::heap_snapshot::snapshot& before, const wren::heap_snapshot::snapshot& after)
+  {
+    std::puts("");
+    std::printf("%-24s %-24s %-24s %12s %14s\n", "module", "owner", "type", "count", "bytes");
+    for (const auto& row : wren::heap_snapshot::diff(before, after)) {
+      std::printf("%-24s %-24s %-24s %+12lld %+14lld\n", row.k.module.c_str(), row.k.owner.c_str(), row.k.type.c_str(),
+                  static_cast<long long>(row.count), static_cast<long long>(row.bytes));
+    }
+
+    const auto a = before.total();
+    const auto b = after.total();
+    std::printf("\ntotal: %+lld objects, %+lld bytes (%llu -> %llu bytes)\n",
+                static_cast<long long>(b.count) - static_cast<long long>(a.count),
+                static_cast<long long>(b.bytes) - static_cast<long long>(a.bytes),
+                static_cast<unsigned long long>(a.bytes), static_cast<unsigned long long>(b.bytes));
+  }
+
+  void print_summary(const driver& d, std::vector<std::uint64_t> frame_ns)
+  {
+    print_table("event", d.stats());
+
+    if (const auto& c = d.commands(); c.recorded) {
+      std::printf("\ncommands: %llu recorded, %llu applied, %llu skipped\n",
+                  static_cast<unsigned long long>(c.recorded), static_cast<unsigned long long>(c.applied),
+                  static_cast<unsigned long long>(c.skipped));
+    }
+
+    if (frame_ns.empty()) return;
+    std::ranges::sort(frame_ns);
+    const auto percentile = [&](const double p) {
+      return frame_ns[std::min(frame_ns.size() - 1, static_cast<std::size_t>(p * static_cast<double>(frame_ns.size())))] / 1000.0;
+    };
+    std::uint64_t total = 0;
+    for (const auto ns : frame_ns) total += ns;
+    std::printf("\nframes %zu: avg %.1f us, p50 %.1f us, p99 %.1f us, max %.1f us\n", frame_ns.size(),
+                total / 1000.0 / static_cast<double>(frame_ns.size()), percentile(0.5), percentile(0.99),
+                frame_ns.back() / 1000.0);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  options opt;
+  if (!parse_options(argc, argv, opt)) {
+    print_usage();
+    return 2;
+  }
+
+  spdlog::set_pattern("[%l] %v");
+  spdlog::set_level(opt.quiet ? spdlog::level::warn : spdlog::level::info);
+
+  if (!opt.heap_diff_before.empty()) {
+    wren::heap_snapshot::snapshot before;
+    wren::heap_snapshot::snapshot after;
+    if (!wren::heap_snapshot::read_json(opt.heap_diff_before, before) ||
+        !wren::heap_snapshot::read_json(opt.heap_diff_after, after)) {
+      logger::error("Can't read heap snapshots {} and {}", opt.heap_diff_before, opt.heap_diff_after);
+      return 1;
+    }
+    print_heap_diff(before, after);
+    return 0;
+  }
+
+  const bool replay = !opt.replay_path.empty();
+  // При воспроизведении мир строится из записи
+  std::optional<host::world> world;
+  if (!replay) world.emplace(opt.world);
+
+  wren::workers::pool::get_singleton()->configure(2, opt.std_path, std::filesystem::path(opt.mods_path) / "Workers");
+  auto vm = wren::script_runtime::create_vm({opt.std_path, opt.mods_path});
+  // Модуль-создатель объектов нужен только снимку кучи
+  if (!opt.heap_snapshot_path.empty()) wrenSetModuleAttribution(vm->getVm(), true);
+  if (!wren::script_runtime::load_std(*vm)) return 1;
+
+  wren::script_runtime::event_dispatcher dispatcher;
+  try {
+    dispatcher.attach(*vm);
+  }
+  catch (const std::exception& e) {
+    logger::error("Events class not found: {}", e.what());
+    return 1;
+  }
+
+  wren::script_runtime::run_mods(*vm, opt.mods_path);
+
+  if (replay) {
+    int code = 0;
+    {
+      host::replayer r(*vm);
+      const auto start = clock::now();
+      if (r.run(opt.replay_path)) {
+        const auto ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        print_table("event", r.events());
+        print_table("listener", r.listeners());
+        std::printf("\nreplayed %u frames in %.1f ms\n", r.frames(), ms);
+      }
+      else {
+        code = 1;
+      }
+    }
+    wren::workers::pool::get_singleton()->terminate_all();
+    dispatcher.reset();
+    vm.reset();
+    return code;
+  }
+
+  const auto recorder = wren::event_record::recorder::get_singleton();
+  if (!opt.record_path.empty() && !recorder->start(opt.record_path)) return 1;
+
+  const auto tracer = wren::tracing::tracer::get_singleton();
+  tracer->name_current_thread("Main");
+  if (!opt.trace_path.empty()) tracer->capture(opt.frames, opt.trace_path);
+
+  // Прогон не ограничен по времени: профайлер выключается вручную после последнего кадра
+  const auto profiler = wren::profiling::profiler::get_singleton();
+  if (!opt.profile_path.empty()) profiler->start(std::chrono::hours(24), opt.profile_path);
+
+  driver d(*world, dispatcher);
+  const float delta = 1.f / opt.fps;
+  std::vector<std::uint64_t> frame_ns;
+  frame_ns.reserve(opt.frames);
+
+  for (std::uint32_t i = 0; i < opt.frames; ++i) {
+    const auto start = clock::now();
+    profiler->on_frame_start(vm->getVm());
+    d.frame(delta, opt);
+    frame_ns.push_back(static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count()));
+  }
+
+  tracer->stop();
+  tracer->wait();
+  profiler->stop(vm->getVm());
+  profiler->wait();
+
+  if (recorder->recording()) {
+    recorder->stop();
+    logger::info("Recorded {} events ({} dropped) to {}", recorder->recorded(), recorder->dropped(), opt.record_path);
+  }
+
+  print_summary(d, std::move(frame_ns));
+
+  if (!opt.eval_lines.empty()) {
+    wren::console::session console;
+    console.attach(*vm);
+    std::puts("");
+    for (const auto& line : opt.eval_lines) {
+      const auto e = console.execute(line);
+      std::printf("> %s\n%s%s\n", e.input.c_str(), e.error ? "error: " : "", e.output.c_str());
+      std::printf("  %s%scompile %.1f us, run %.1f us\n", e.type.c_str(), e.type.empty() ? "" : ", ", e.compile_us,
+                  e.run_us);
+    }
+  }
+
+  if (!opt.heap_snapshot_path.empty()) {
+    const auto heap = wren::heap_snapshot::take(vm->getVm());
+    if (!wren::heap_snapshot::write_json(heap, opt.heap_snapshot_path)) return 1;
+    const auto total = heap.total();
+    std::printf("heap: %llu objects, %llu bytes -> %s\n", static_cast<unsigned long long>(total.count),
+                static_cast<unsigned long long>(total.bytes), opt.heap_snapshot_path.c_str());
+  }
+
+  wren::workers::pool::get_singleton()->terminate_all();
+  dispatcher.reset();
+  vm.reset();
+  return 0;
+}
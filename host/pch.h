@@ -0,0 +1,24 @@
+#pragma once
+
+// pch.h для wrenrim-host: стоит в путях поиска раньше src, поэтому обертки
+// из src/Wren/Wrappers собираются против заглушек из host/stub вместо CommonLibSSE-NG.
+
+#include <RE/Skyrim.h>
+#include <SKSE/SKSE.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <ranges>
+#include <span>
+#include <variant>
+#include <wren.hpp>
+#include <wrenbind17/wrenbind17.hpp>
+
+namespace logger = SKSE::log;
+namespace stl = SKSE::stl;
+using namespace std::literals;
+
+#define DLLEXPORT
+
+#define RELOCATION_OFFSET(se, ae) se
@@ -0,0 +1,1231 @@
+#pragma once
+
+// Заглушка RE для wrenrim-host.
+// Повторяет только ту часть API CommonLibSSE-NG, которую используют обертки в src/Wren/Wrappers,
+// с теми же именами типов и методов. Формы, актеры и меню живут в памяти и создаются
+// хостом через функции RE::stub; раскладка в памяти с игрой не совпадает.
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <SKSE/SKSE.h>
+
+namespace RE
+{
+  class Actor;
+  class PlayerCharacter;
+  class SpellItem;
+  class TESForm;
+
+  using FormID = std::uint32_t;
+
+  enum class FormType : std::uint8_t
+  {
+    kNone = 0,
+    kKeyword = 4,
+    kRace = 10,
+    kMagicEffect = 18,
+    kSpell = 22,
+    kArmor = 26,
+    kWeapon = 41,
+    kNPC = 43,
+    kAlchemyItem = 46,
+    kReference = 61,
+    kActorCharacter = 62,
+  };
+
+  enum class ActorValue : std::int32_t
+  {
+    kNone = -1,
+    kHealth = 24,
+    kMagicka = 25,
+    kStamina = 26,
+    kTotal = 164,
+  };
+
+  enum class ACTOR_VALUE_MODIFIER : std::uint32_t
+  {
+    kPermanent = 0,
+    kTemporary = 1,
+    kDamage = 2,
+    kTotal = 3,
+  };
+
+  enum class SOUND_LEVEL : std::uint32_t
+  {
+    kLoud = 0,
+    kNormal = 1,
+    kSilent = 2,
+    kVeryLoud = 3,
+  };
+
+  namespace MagicSystem
+  {
+    enum class CastingType : std::uint32_t
+    {
+      kConstantEffect = 0,
+      kFireAndForget = 1,
+      kConcentration = 2,
+      kScroll = 3,
+    };
+
+    enum class Delivery : std::uint32_t
+    {
+      kSelf = 0,
+      kTouch = 1,
+      kAimed = 2,
+      kTargetActor = 3,
+      kTargetLocation = 4,
+    };
+
+    enum class SpellType : std::uint32_t
+    {
+      kSpell = 0,
+      kDisease = 1,
+      kPower = 2,
+      kLesserPower = 3,
+      kAbility = 4,
+      kPoison = 5,
+      kEnchantment = 6,
+      kPotion = 7,
+      kVoicePower = 11,
+    };
+  }
+
+  namespace EffectArchetypes
+  {
+    enum class ArchetypeID : std::uint32_t
+    {
+      kValueModifier = 0,
+      kScript = 1,
+      kDispel = 2,
+      kCureDisease = 3,
+      kAbsorb = 4,
+      kDualValueModifier = 5,
+      kNone = 0xFFFFFFFF,
+    };
+  }
+
+  // Математика и указатели
+
+  struct NiPoint3
+  {
+    constexpr NiPoint3() noexcept = default;
+    constexpr NiPoint3(const float x, const float y, const float z) noexcept : x(x), y(y), z(z) {}
+
+    NiPoint3 operator-(const NiPoint3& rhs) const { return {x - rhs.x, y - rhs.y, z - rhs.z}; }
+    NiPoint3 operator+(const NiPoint3& rhs) const { return {x + rhs.x, y + rhs.y, z + rhs.z}; }
+    NiPoint3 operator*(const float s) const { return {x * s, y * s, z * s}; }
+
+    NiPoint3& operator/=(const float s)
+    {
+      x /= s;
+      y /= s;
+      z /= s;
+      return *this;
+    }
+
+    [[nodiscard]] float Dot(const NiPoint3& rhs) const { return x * rhs.x + y * rhs.y + z * rhs.z; }
+    [[nodiscard]] float SqrLength() const { return Dot(*this); }
+    [[nodiscard]] float Length() const { return std::sqrt(SqrLength()); }
+
+    float x{0.f};
+    float y{0.f};
+    float z{0.f};
+  };
+
+  // В игре NiPointer считает ссылки; формы хоста живут до конца процесса, поэтому указатель простой
+  template<typename T>
+  class NiPointer
+  {
+  public:
+    NiPointer() = default;
+    NiPointer(T* ptr) : ptr_(ptr) {}
+
+    [[nodiscard]] T* get() const { return ptr_; }
+    void reset() { ptr_ = nullptr; }
+    T* operator->() const { return ptr_; }
+    T& operator*() const { return *ptr_; }
+    explicit operator bool() const { return ptr_ != nullptr; }
+
+  private:
+    T* ptr_{nullptr};
+  };
+
+  template<typename T>
+  class GPtr
+  {
+  public:
+    GPtr() = default;
+    GPtr(T* ptr) : ptr_(ptr) {}
+
+    [[nodiscard]] T* get() const { return ptr_; }
+    void reset() { ptr_ = nullptr; }
+    T* operator->() const { return ptr_; }
+    explicit operator bool() const { return ptr_ != nullptr; }
+
+  private:
+    T* ptr_{nullptr};
+  };
+
+  struct BSReadWriteLock
+  {
+  };
+
+  struct BSReadLockGuard
+  {
+    explicit BSReadLockGuard(BSReadWriteLock&) {}
+  };
+
+  template<typename T>
+  using BSSimpleList = std::vector<T>;
+
+  /**
+   * @brief Хендл ссылки. Значение — индекс в таблице хендлов хоста (0 — пустой хендл).
+   */
+  template<typename T>
+  class BSPointerHandle
+  {
+  public:
+    BSPointerHandle() = default;
+    explicit BSPointerHandle(const std::uint32_t value) : value_(value) {}
+
+    [[nodiscard]] std::uint32_t native_handle() const { return value_; }
+    [[nodiscard]] NiPointer<T> get() const;
+    explicit operator bool() const { return value_ != 0; }
+    bool operator==(const BSPointerHandle&) const = default;
+
+  private:
+    std::uint32_t value_{0};
+  };
+
+  using ActorHandle = BSPointerHandle<Actor>;
+
+  // Формы
+
+  class TESForm
+  {
+  public:
+    TESForm() = default;
+    TESForm(const FormID form_id, const FormType form_type, std::string editor_id, std::string full_name) :
+        formID(form_id), formType(form_type), editorID(std::move(editor_id)), fullName(std::move(full_name))
+    {
+    }
+    virtual ~TESForm() = default;
+
+    [[nodiscard]] FormID GetFormID() const { return formID; }
+    [[nodiscard]] FormType GetFormType() const { return formType; }
+    [[nodiscard]] virtual const char* GetName() const { return fullName.c_str(); }
+    [[nodiscard]] const char* GetFormEditorID() const { return editorID.c_str(); }
+
+    template<typename T>
+    [[nodiscard]] T* As()
+    {
+      return dynamic_cast<T*>(this);
+    }
+
+    template<typename T>
+    [[nodiscard]] const T* As() const
+    {
+      return dynamic_cast<const T*>(this);
+    }
+
+    static TESForm* LookupByID(FormID form_id);
+
+    template<typename T>
+    static T* LookupByID(const FormID form_id)
+    {
+      const auto form = LookupByID(form_id);
+      return form ? form->As<T>() : nullptr;
+    }
+
+    static TESForm* LookupByEditorID(std::string_view editor_id);
+
+    static std::pair<std::unordered_map<FormID, TESForm*>*, std::reference_wrapper<BSReadWriteLock>> GetAllForms();
+
+    FormID formID{0};
+    FormType formType{FormType::kNone};
+    std::string editorID;
+    std::string fullName;
+  };
+
+  class BGSKeyword : public TESForm
+  {
+  public:
+    using TESForm::TESForm;
+  };
+
+  class BGSKeywordForm
+  {
+  public:
+    virtual ~BGSKeywordForm() = default;
+
+    [[nodiscard]] bool HasKeyword(const BGSKeyword* keyword) const
+    {
+      return std::find(keywords, keywords + numKeywords, keyword) != keywords + numKeywords;
+    }
+
+    [[nodiscard]] bool HasKeywordString(const std::string_view editor_id) const
+    {
+      return std::any_of(keywords, keywords + numKeywords, [&](const BGSKeyword* kw) {
+        return kw && kw->editorID == editor_id;
+      });
+    }
+
+    // Как и в игре, массив ключевых слов при добавлении заменяется новым
+    bool AddKeyword(BGSKeyword* keyword)
+    {
+      if (!keyword || HasKeyword(keyword)) return false;
+      auto storage = std::make_shared<std::vector<BGSKeyword*>>(keywords, keywords + numKeywords);
+      storage->push_back(keyword);
+      storage_ = std::move(storage);
+      keywords = storage_->data();
+      numKeywords = static_cast<std::uint32_t>(storage_->size());
+      return true;
+    }
+
+    BGSKeyword** keywords{nullptr};
+    std::uint32_t numKeywords{0};
+
+  private:
+    std::shared_ptr<std::vector<BGSKeyword*>> storage_;
+  };
+
+  class TESRace : public TESForm, public BGSKeywordForm
+  {
+  public:
+    using TESForm::TESForm;
+  };
+
+  class TESNPC : public TESForm, public BGSKeywordForm
+  {
+  public:
+    using TESForm::TESForm;
+
+    TESRace* race{nullptr};
+  };
+
+  class TESObjectWEAP : public TESForm, public BGSKeywordForm
+  {
+  public:
+    using TESForm::TESForm;
+
+    [[nodiscard]] std::uint16_t GetAttackDamage() const { return attackDamage; }
+    [[nodiscard]] float GetReach() const { return reach; }
+    [[nodiscard]] float GetSpeed() const { return speed; }
+    [[nodiscard]] float GetWeight() const { return weight; }
+    [[nodiscard]] std::int32_t GetGoldValue() const { return value; }
+
+    std::uint16_t attackDamage{0};
+    float reach{1.f};
+    float speed{1.f};
+    float weight{0.f};
+    std::int32_t value{0};
+  };
+
+  namespace BIPED_MODEL
+  {
+    enum class ArmorType : std::uint32_t
+    {
+      kLightArmor = 0,
+      kHeavyArmor = 1,
+      kClothing = 2,
+    };
+  }
+
+  class TESObjectARMO : public TESForm, public BGSKeywordForm
+  {
+  public:
+    using TESForm::TESForm;
+
+    [[nodiscard]] float GetWeight() const { return weight; }
+    [[nodiscard]] std::int32_t GetGoldValue() const { return value; }
+    [[nodiscard]] float GetArmorRating() const { return static_cast<float>(armorRating) / 100.f; }
+    [[nodiscard]] BIPED_MODEL::ArmorType GetArmorType() const { return armorType; }
+
+    float weight{0.f};
+    std::int32_t value{0};
+    std::uint32_t armorRating{0};
+    BIPED_MODEL::ArmorType armorType{BIPED_MODEL::ArmorType::kLightArmor};
+  };
+
+  class EffectSetting : public TESForm, public BGSKeywordForm
+  {
+  public:
+    using TESForm::TESForm;
+
+    struct EffectSettingData
+    {
+      enum class Flag : std::uint32_t
+      {
+        kNone = 0,
+        kHostile = 1 << 0,
+        kRecover = 1 << 1,
+        kDetrimental = 1 << 2,
+      };
+
+      SKSE::stl::enumeration<Flag, std::uint32_t> flags;
+      float baseCost{0.f};
+      ActorValue associatedSkill{ActorValue::kNone};
+      std::int32_t minimumSkill{0};
+      std::uint32_t spellmakingArea{0};
+      float spellmakingChargeTime{0.f};
+      float taperCurve{0.f};
+      float taperDuration{0.f};
+      float secondAVWeight{0.f};
+      EffectArchetypes::ArchetypeID archetype{EffectArchetypes::ArchetypeID::kValueModifier};
+      ActorValue primaryAV{ActorValue::kNone};
+      std::int16_t numCounterEffects{0};
+      SpellItem* equipAbility{nullptr};
+      ActorValue resistVariable{ActorValue::kNone};
+      ActorValue secondaryAV{ActorValue::kNone};
+      MagicSystem::CastingType castingType{MagicSystem::CastingType::kFireAndForget};
+      MagicSystem::Delivery delivery{MagicSystem::Delivery::kSelf};
+      float skillUsageMult{0.f};
+      float dualCastScale{0.f};
+      float taperWeight{0.f};
+      SOUND_LEVEL castingSoundLevel{SOUND_LEVEL::kNormal};
+      float aiScore{0.f};
+      float aiDelayTimer{0.f};
+    };
+
+    [[nodiscard]] bool IsHostile() const { return data.flags.any(EffectSettingData::Flag::kHostile); }
+    [[nodiscard]] bool IsDetrimental() const { return data.flags.any(EffectSettingData::Flag::kDetrimental); }
+    [[nodiscard]] EffectArchetypes::ArchetypeID GetArchetype() const { return data.archetype; }
+    [[nodiscard]] ActorValue GetMagickSkill() const { return data.associatedSkill; }
+    [[nodiscard]] std::int32_t GetMinimumSkillLevel() const { return data.minimumSkill; }
+
+    EffectSettingData data;
+  };
+
+  struct Effect
+  {
+    struct EffectItem
+    {
+      float magnitude{0.f};
+      std::uint32_t area{0};
+      std::uint32_t duration{0};
+    };
+
+    EffectItem effectItem;
+    EffectSetting* baseEffect{nullptr};
+    float cost{0.f};
+  };
+
+  class SpellItem : public TESForm, public BGSKeywordForm
+  {
+  public:
+    using TESForm::TESForm;
+
+    struct Data
+    {
+      std::int32_t costOverride{0};
+      MagicSystem::SpellType spellType{MagicSystem::SpellType::kSpell};
+      float chargeTime{0.f};
+      MagicSystem::CastingType castingType{MagicSystem::CastingType::kFireAndForget};
+      MagicSystem::Delivery delivery{MagicSystem::Delivery::kAimed};
+    };
+
+    [[nodiscard]] float GetChargeTime() const { return data.chargeTime; }
+    [[nodiscard]] MagicSystem::SpellType GetSpellType() const { return data.spellType; }
+    [[nodiscard]] MagicSystem::CastingType GetCastingType() const { return data.castingType; }
+    [[nodiscard]] MagicSystem::Delivery GetDelivery() const { return data.delivery; }
+
+    [[nodiscard]] bool IsHostile() const
+    {
+      return std::any_of(effects.begin(), effects.end(), [](const Effect* e) {
+        return e && e->baseEffect && e->baseEffect->IsHostile();
+      });
+    }
+
+    // В игре стоимость зависит от перков и навыка кастера, на хосте — только от эффектов
+    [[nodiscard]] float CalculateMagickaCost(Actor*) const
+    {
+      if (data.costOverride) return static_cast<float>(data.costOverride);
+      float cost = 0.f;
+      for (const auto e : effects) cost += e ? e->cost : 0.f;
+      return cost;
+    }
+
+    Data data;
+    std::vector<Effect*> effects;
+  };
+
+  class AlchemyItem : public TESForm, public BGSKeywordForm
+  {
+  public:
+    using TESForm::TESForm;
+
+    struct Data
+    {
+      enum class Flag : std::uint32_t
+      {
+        kNone = 0,
+        kFoodItem = 1 << 1,
+        kMedicine = 1 << 16,
+        kPoison = 1 << 17,
+      };
+
+      std::int32_t costOverride{0};
+      SKSE::stl::enumeration<Flag, std::uint32_t> flags;
+    };
+
+    [[nodiscard]] bool IsPoison() const { return data.flags.any(Data::Flag::kPoison); }
+    [[nodiscard]] bool IsFood() const { return data.flags.any(Data::Flag::kFoodItem); }
+
+    Data data;
+    std::vector<Effect*> effects;
+  };
+
+  // Актеры
+
+  class ActorValueOwner
+  {
+  public:
+    virtual ~ActorValueOwner() = default;
+
+    [[nodiscard]] virtual float GetActorValue(ActorValue av) = 0;
+    virtual void ModActorValue(ACTOR_VALUE_MODIFIER modifier, ActorValue av, float value) = 0;
+    virtual void RestoreActorValue(ACTOR_VALUE_MODIFIER modifier, ActorValue av, float value) = 0;
+
+    void RestoreActorValue(const ActorValue av, const float value)
+    {
+      RestoreActorValue(ACTOR_VALUE_MODIFIER::kDamage, av, value);
+    }
+
+    void DamageActorValue(const ActorValue av, const float value)
+    {
+      RestoreActorValue(ACTOR_VALUE_MODIFIER::kDamage, av, -value);
+    }
+  };
+
+  class ActiveEffect;
+
+  class MagicTarget
+  {
+  public:
+    virtual ~MagicTarget() = default;
+
+    [[nodiscard]] virtual Actor* GetTargetAsActor() { return nullptr; }
+    [[nodiscard]] virtual BSSimpleList<ActiveEffect*>* GetActiveEffectList() { return nullptr; }
+  };
+
+  class ActiveEffect
+  {
+  public:
+    enum class Flag : std::uint32_t
+    {
+      kNone = 0,
+      kDispelled = 1 << 14,
+      kInactive = 1 << 15,
+    };
+
+    [[nodiscard]] float GetMagnitude() const { return magnitude; }
+
+    ActorHandle caster;
+    MagicTarget* target{nullptr};
+    Effect* effect{nullptr};
+    float elapsedSeconds{0.f};
+    float duration{0.f};
+    float magnitude{0.f};
+    SKSE::stl::enumeration<Flag, std::uint32_t> flags;
+  };
+
+  class TESObjectREFR : public TESForm
+  {
+  public:
+    using TESForm::TESForm;
+
+    [[nodiscard]] NiPoint3 GetPosition() const { return position; }
+    [[nodiscard]] float GetAngleZ() const { return angleZ; }
+    [[nodiscard]] bool IsDeleted() const { return deleted; }
+
+    NiPoint3 position;
+    float angleZ{0.f};
+    bool deleted{false};
+  };
+
+  class Actor : public TESObjectREFR, public MagicTarget, public ActorValueOwner
+  {
+  public:
+    Actor(const FormID form_id, TESNPC* base) :
+        TESObjectREFR(form_id, FormType::kActorCharacter, "", ""), npc(base)
+    {
+    }
+
+    [[nodiscard]] ActorHandle GetHandle() const { return handle; }
+    [[nodiscard]] const char* GetName() const override { return npc ? npc->GetName() : ""; }
+    [[nodiscard]] TESNPC* GetActorBase() const { return npc; }
+    [[nodiscard]] TESRace* GetRace() const { return npc ? npc->race : nullptr; }
+
+    [[nodiscard]] bool HasKeywordString(const std::string_view editor_id) const
+    {
+      return (npc && npc->HasKeywordString(editor_id)) || (GetRace() && GetRace()->HasKeywordString(editor_id));
+    }
+
+    [[nodiscard]] ActorValueOwner* AsActorValueOwner() { return this; }
+    [[nodiscard]] MagicTarget* AsMagicTarget() { return this; }
+
+    [[nodiscard]] bool IsDead() const { return dead; }
+    [[nodiscard]] bool IsInCombat() const { return inCombat; }
+    [[nodiscard]] bool IsPlayerRef() const;
+    [[nodiscard]] bool IsHostileToActor(const Actor* other) const { return other && other != this && hostile; }
+
+    // ActorValueOwner: значение = база + постоянный + временный модификатор + урон (<= 0)
+    [[nodiscard]] float GetActorValue(const ActorValue av) override
+    {
+      const auto i = index_of(av);
+      if (i < 0) return 0.f;
+      return base_values[i] + modifiers[i][0] + modifiers[i][1] + modifiers[i][2];
+    }
+
+    void ModActorValue(const ACTOR_VALUE_MODIFIER modifier, const ActorValue av, const float value) override
+    {
+      const auto i = index_of(av);
+      if (i < 0 || modifier >= ACTOR_VALUE_MODIFIER::kTotal) return;
+      modifiers[i][std::to_underlying(modifier)] += value;
+    }
+
+    void RestoreActorValue(const ACTOR_VALUE_MODIFIER modifier, const ActorValue av, const float value) override
+    {
+      const auto i = index_of(av);
+      if (i < 0 || modifier >= ACTOR_VALUE_MODIFIER::kTotal) return;
+      auto& m = modifiers[i][std::to_underlying(modifier)];
+      m = modifier == ACTOR_VALUE_MODIFIER::kDamage ? std::min(0.f, m + value) : m + value;
+    }
+
+    using ActorValueOwner::RestoreActorValue;
+
+    [[nodiscard]] Actor* GetTargetAsActor() override { return this; }
+    [[nodiscard]] BSSimpleList<ActiveEffect*>* GetActiveEffectList() override { return &activeEffects; }
+
+    TESNPC* npc{nullptr};
+    ActorHandle handle;
+    bool dead{false};
+    bool inCombat{false};
+    bool hostile{false};
+    std::array<float, std::to_underlying(ActorValue::kTotal)> base_values{};
+    std::array<std::array<float, 3>, std::to_underlying(ActorValue::kTotal)> modifiers{};
+    BSSimpleList<ActiveEffect*> activeEffects;
+
+  private:
+    static int index_of(const ActorValue av)
+    {
+      const auto i = std::to_underlying(av);
+      return i >= 0 && i < std::to_underlying(ActorValue::kTotal) ? i : -1;
+    }
+  };
+
+  class Character : public Actor
+  {
+  public:
+    using Actor::Actor;
+  };
+
+  class PlayerCharacter : public Character
+  {
+  public:
+    using Character::Character;
+
+    static PlayerCharacter* GetSingleton();
+  };
+
+  struct HitData
+  {
+    NiPoint3 hitPosition;
+    NiPoint3 hitDirection;
+    ActorHandle aggressor;
+    ActorHandle target;
+    float physicalDamage{0.f};
+    float totalDamage{0.f};
+    TESObjectWEAP* weapon{nullptr};
+  };
+
+  // Имена ActorValue и настройки
+
+  struct ActorValueInfo
+  {
+    const char* enumName{nullptr};
+  };
+
+  class ActorValueList
+  {
+  public:
+    static ActorValueList* GetSingleton();
+
+    static ActorValue LookupActorValueByName(const std::string_view name)
+    {
+      const auto list = GetSingleton();
+      for (std::int32_t i = 0; i < std::to_underlying(ActorValue::kTotal); ++i) {
+        const auto info = list->actorValues[i];
+        if (!info || !info->enumName || name.size() != std::char_traits<char>::length(info->enumName)) continue;
+        if (std::equal(name.begin(), name.end(), info->enumName, [](const char a, const char b) {
+              return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+            })) {
+          return static_cast<ActorValue>(i);
+        }
+      }
+      return ActorValue::kNone;
+    }
+
+    ActorValueInfo* actorValues[std::to_underlying(ActorValue::kTotal)]{};
+  };
+
+  class Setting
+  {
+  public:
+    enum class Type : std::uint32_t
+    {
+      kUnknown = 0,
+      kBool,
+      kFloat,
+      kSignedInteger,
+      kColor,
+      kString,
+      kUnsignedInteger,
+    };
+
+    [[nodiscard]] Type GetType() const { return type; }
+    [[nodiscard]] bool GetBool() const { return number != 0.0; }
+    [[nodiscard]] float GetFloat() const { return static_cast<float>(number); }
+    [[nodiscard]] std::int32_t GetSInt() const { return static_cast<std::int32_t>(number); }
+    [[nodiscard]] std::uint32_t GetUInt() const { return static_cast<std::uint32_t>(number); }
+    [[nodiscard]] const char* GetString() const { return text.c_str(); }
+
+    std::string name;
+    Type type{Type::kUnknown};
+    double number{0.0};
+    std::string text;
+  };
+
+  // Плагины
+
+  class TESFile
+  {
+  public:
+    [[nodiscard]] bool IsLight() const { return smallFileCompileIndex != 0xFFFF; }
+    [[nodiscard]] std::uint8_t GetCompileIndex() const { return compileIndex; }
+    [[nodiscard]] std::uint16_t GetSmallFileCompileIndex() const { return smallFileCompileIndex; }
+
+    std::string fileName;
+    std::uint8_t compileIndex{0xFF};
+    std::uint16_t smallFileCompileIndex{0xFFFF};
+  };
+
+  class TESDataHandler
+  {
+  public:
+    static TESDataHandler* GetSingleton();
+
+    [[nodiscard]] const TESFile* LookupModByName(const std::string_view name) const
+    {
+      for (const auto file : files) {
+        if (file && file->fileName == name) return file;
+      }
+      return nullptr;
+    }
+
+    // Массив собирается из реестра форм хоста при каждом вызове; обертки зовут его один раз при старте
+    template<typename T>
+    std::vector<T*>& GetFormArray();
+
+    BSSimpleList<TESFile*> files;
+  };
+
+  // Scaleform
+
+  /**
+   * @brief Значение Scaleform. Объекты и массивы хранятся в памяти хоста и разделяются
+   * копиями значения, как ссылки на объекты ActionScript.
+   */
+  class GFxValue
+  {
+  public:
+    enum class ValueType : std::uint32_t
+    {
+      kUndefined,
+      kNull,
+      kBoolean,
+      kNumber,
+      kString,
+      kObject,
+      kArray,
+      kDisplayObject,
+    };
+
+    class ObjectVisitor
+    {
+    public:
+      virtual ~ObjectVisitor() = default;
+      virtual void Visit(const char* name, const GFxValue& value) = 0;
+    };
+
+    GFxValue() = default;
+    GFxValue(const double value) : type_(ValueType::kNumber), number_(value) {}
+    GFxValue(const bool value) : type_(ValueType::kBoolean), number_(value ? 1.0 : 0.0) {}
+    GFxValue(const char* value) : GFxValue(std::string_view(value ? value : "")) {}
+    GFxValue(const std::string_view value) :
+        type_(ValueType::kString), string_(std::make_shared<std::string>(value))
+    {
+    }
+    GFxValue(const std::string& value) : GFxValue(std::string_view(value)) {}
+
+    [[nodiscard]] ValueType GetType() const { return type_; }
+    [[nodiscard]] bool IsUndefined() const { return type_ == ValueType::kUndefined; }
+    [[nodiscard]] bool IsNull() const { return type_ == ValueType::kNull; }
+    [[nodiscard]] bool IsBool() const { return type_ == ValueType::kBoolean; }
+    [[nodiscard]] bool IsNumber() const { return type_ == ValueType::kNumber; }
+    [[nodiscard]] bool IsString() const { return type_ == ValueType::kString; }
+    [[nodiscard]] bool IsArray() const { return type_ == ValueType::kArray; }
+    [[nodiscard]] bool IsDisplayObject() const { return type_ == ValueType::kDisplayObject; }
+
+    [[nodiscard]] bool IsObject() const
+    {
+      return type_ == ValueType::kObject || type_ == ValueType::kArray || type_ == ValueType::kDisplayObject;
+    }
+
+    [[nodiscard]] bool GetBool() const { return number_ != 0.0; }
+    [[nodiscard]] double GetNumber() const { return number_; }
+    [[nodiscard]] const char* GetString() const { return string_ ? string_->c_str() : ""; }
+
+    void SetUndefined() { *this = GFxValue(); }
+
+    void SetNull()
+    {
+      *this = GFxValue();
+      type_ = ValueType::kNull;
+    }
+
+    void SetBoolean(const bool value) { *this = GFxValue(value); }
+    void SetNumber(const double value) { *this = GFxValue(value); }
+
+    [[nodiscard]] bool HasMember(const char* name) const { return find_member(name) != nullptr; }
+
+    bool GetMember(const char* name, GFxValue* out) const
+    {
+      const auto member = find_member(name);
+      if (out) *out = member ? *member : GFxValue();
+      return member != nullptr;
+    }
+
+    bool SetMember(const char* name, const GFxValue& value);
+
+    // На хосте у объектов нет функций ActionScript: вызов ничего не делает
+    bool Invoke(const char*, GFxValue* result, const GFxValue*, std::size_t) const
+    {
+      if (result) result->SetUndefined();
+      return false;
+    }
+
+    [[nodiscard]] std::uint32_t GetArraySize() const;
+    bool SetArraySize(std::uint32_t size);
+    bool GetElement(std::uint32_t index, GFxValue* out) const;
+    bool SetElement(std::uint32_t index, const GFxValue& value);
+    bool PushBack(const GFxValue& value);
+
+    bool SetText(const char* text) { return SetMember("text", GFxValue(text)); }
+    bool SetTextHTML(const char* html) { return SetMember("htmlText", GFxValue(html)); }
+
+    void VisitMembers(ObjectVisitor* visitor) const;
+
+    static GFxValue make_object(ValueType type);
+
+  private:
+    struct object_data;
+
+    [[nodiscard]] const GFxValue* find_member(std::string_view name) const;
+
+    ValueType type_{ValueType::kUndefined};
+    double number_{0.0};
+    std::shared_ptr<std::string> string_;
+    std::shared_ptr<object_data> object_;
+  };
+
+  struct GFxValue::object_data
+  {
+    std::vector<std::pair<std::string, GFxValue>> members;
+    std::vector<GFxValue> elements;
+  };
+
+  inline GFxValue GFxValue::make_object(const ValueType type)
+  {
+    GFxValue value;
+    value.type_ = type;
+    value.object_ = std::make_shared<object_data>();
+    return value;
+  }
+
+  inline const GFxValue* GFxValue::find_member(const std::string_view name) const
+  {
+    if (!object_) return nullptr;
+    for (const auto& [key, value] : object_->members) {
+      if (key == name) return &value;
+    }
+    return nullptr;
+  }
+
+  inline bool GFxValue::SetMember(const char* name, const GFxValue& value)
+  {
+    if (!object_ || !name) return false;
+    for (auto& [key, member] : object_->members) {
+      if (key == name) {
+        member = value;
+        return true;
+      }
+    }
+    object_->members.emplace_back(name, value);
+    return true;
+  }
+
+  inline std::uint32_t GFxValue::GetArraySize() const
+  {
+    return IsArray() ? static_cast<std::uint32_t>(object_->elements.size()) : 0;
+  }
+
+  inline bool GFxValue::SetArraySize(const std::uint32_t size)
+  {
+    if (!IsArray()) return false;
+    object_->elements.resize(size);
+    return true;
+  }
+
+  inline bool GFxValue::GetElement(const std::uint32_t index, GFxValue* out) const
+  {
+    const bool found = IsArray() && index < object_->elements.size();
+    if (out) *out = found ? object_->elements[index] : GFxValue();
+    return found;
+  }
+
+  inline bool GFxValue::SetElement(const std::uint32_t index, const GFxValue& value)
+  {
+    if (!IsArray()) return false;
+    if (index >= object_->elements.size()) object_->elements.resize(index + 1);
+    object_->elements[index] = value;
+    return true;
+  }
+
+  inline bool GFxValue::PushBack(const GFxValue& value)
+  {
+    if (!IsArray()) return false;
+    object_->elements.push_back(value);
+    return true;
+  }
+
+  inline void GFxValue::VisitMembers(ObjectVisitor* visitor) const
+  {
+    if (!object_ || !visitor) return;
+    for (const auto& [key, value] : object_->members) visitor->Visit(key.c_str(), value);
+  }
+
+  /**
+   * @brief Movie меню. Переменные — члены объекта _root по пути через точку.
+   */
+  class GFxMovieView
+  {
+  public:
+    enum class SetVarType : std::uint32_t
+    {
+      kNormal,
+      kSticky,
+      kPermanent,
+    };
+
+    GFxMovieView() : root_(GFxValue::make_object(GFxValue::ValueType::kDisplayObject)) {}
+
+    void CreateString(GFxValue* out, const char* value) const { *out = GFxValue(value); }
+    void CreateObject(GFxValue* out) const { *out = GFxValue::make_object(GFxValue::ValueType::kObject); }
+    void CreateArray(GFxValue* out) const { *out = GFxValue::make_object(GFxValue::ValueType::kArray); }
+
+    bool SetVariable(const char* path, const GFxValue& value, SetVarType = SetVarType::kNormal)
+    {
+      GFxValue parent;
+      std::string_view name;
+      if (!resolve_parent(path, parent, name) || name.empty()) return false;
+      return parent.SetMember(std::string(name).c_str(), value);
+    }
+
+    bool GetVariable(GFxValue* out, const char* path) const
+    {
+      GFxValue parent;
+      std::string_view name;
+      if (!resolve_parent(path, parent, name)) return false;
+      if (name.empty()) {
+        *out = parent;
+        return true;
+      }
+      return parent.GetMember(std::string(name).c_str(), out);
+    }
+
+    bool Invoke(const char* path, GFxValue* result, const GFxValue*, std::uint32_t)
+    {
+      ++invokeCount;
+      (void)path;
+      if (result) result->SetUndefined();
+      return false;
+    }
+
+    std::uint64_t invokeCount{0};
+
+  private:
+    // "_root.a.b" и "a.b" -> объект a и имя b; "_root" -> _root и пустое имя
+    bool resolve_parent(const char* path, GFxValue& parent, std::string_view& name) const
+    {
+      std::string_view rest = path ? path : "";
+      if (rest == "_root") {
+        parent = root_;
+        name = {};
+        return true;
+      }
+      if (rest.starts_with("_root.")) rest.remove_prefix(6);
+
+      parent = root_;
+      for (auto dot = rest.find('.'); dot != std::string_view::npos; dot = rest.find('.')) {
+        GFxValue next;
+        if (!parent.GetMember(std::string(rest.substr(0, dot)).c_str(), &next) || !next.IsObject()) return false;
+        parent = next;
+        rest.remove_prefix(dot + 1);
+      }
+      name = rest;
+      return true;
+    }
+
+    GFxValue root_;
+  };
+
+  class UI
+  {
+  public:
+    static UI* GetSingleton();
+
+    [[nodiscard]] bool IsMenuOpen(const std::string_view name) const
+    {
+      return menus.find(std::string(name)) != menus.end();
+    }
+
+    [[nodiscard]] GPtr<GFxMovieView> GetMovieView(const std::string_view name) const
+    {
+      const auto it = menus.find(std::string(name));
+      return it != menus.end() ? GPtr<GFxMovieView>(it->second.get()) : GPtr<GFxMovieView>();
+    }
+
+    std::unordered_map<std::string, std::unique_ptr<GFxMovieView>> menus;
+  };
+
+  // Глобальные функции игры
+
+  void DebugNotification(const char* notification, const char* sound = nullptr, bool cancel_if_shown = true);
+  void DebugMessageBox(const char* message);
+  void PlaySound(const char* editor_id);
+  void ShakeCamera(float strength, const NiPoint3& position, float duration);
+  std::uint32_t GetDurationOfApplicationRunTime();
+  float GetSecondsSinceLastFrame();
+  Setting* GetINISetting(const char* name);
+
+  /**
+   * @brief Состояние игрового мира хоста: реестр форм, таблица хендлов, меню и время.
+   * Хост наполняет его до инициализации движка; обертки видят его через обычный API RE.
+   */
+  namespace stub
+  {
+    struct state
+    {
+      std::unordered_map<FormID, TESForm*> forms;
+      BSReadWriteLock forms_lock;
+      std::vector<Actor*> handles;
+      PlayerCharacter* player{nullptr};
+      TESDataHandler data_handler;
+      ActorValueList actor_values;
+      std::array<ActorValueInfo, std::to_underlying(ActorValue::kTotal)> actor_value_infos;
+      UI ui;
+      std::unordered_map<std::string, Setting*> settings;
+      float frame_delta{1.f / 60.f};
+      std::uint32_t run_time_ms{0};
+      std::uint64_t notifications{0};
+    };
+
+    inline state& get();
+
+    inline void register_form(TESForm* form)
+    {
+      if (form) get().forms[form->GetFormID()] = form;
+    }
+
+    inline void register_actor(Actor* actor)
+    {
+      register_form(actor);
+      auto& handles = get().handles;
+      handles.push_back(actor);
+      actor->handle = ActorHandle(static_cast<std::uint32_t>(handles.size()));
+    }
+
+    // Актер выгружен: хендлы на него больше не разрешаются
+    inline void unregister_actor(Actor* actor)
+    {
+      auto& s = get();
+      if (const auto i = actor->handle.native_handle(); i && i <= s.handles.size()) s.handles[i - 1] = nullptr;
+      s.forms.erase(actor->GetFormID());
+    }
+
+    inline void set_player(PlayerCharacter* player)
+    {
+      register_actor(player);
+      get().player = player;
+    }
+
+    inline void register_setting(Setting* setting)
+    {
+      if (setting) get().settings[setting->name] = setting;
+    }
+
+    inline GFxMovieView* open_menu(const std::string& name)
+    {
+      auto& movie = get().ui.menus[name];
+      if (!movie) movie = std::make_unique<GFxMovieView>();
+      return movie.get();
+    }
+
+    inline void close_menu(const std::string& name)
+    {
+      get().ui.menus.erase(name);
+    }
+
+    inline void advance_time(const float delta)
+    {
+      auto& s = get();
+      s.frame_delta = delta;
+      s.run_time_ms += static_cast<std::uint32_t>(delta * 1000.f);
+    }
+
+    inline constexpr const char* actor_value_names[std::to_underlying(ActorValue::kTotal)] = {
+        "Aggression", "Confidence", "Energy", "Morality", "Mood", "Assistance", "OneHanded", "TwoHanded",
+        "Archery", "Block", "Smithing", "HeavyArmor", "LightArmor", "Pickpocket", "Lockpicking", "Sneak",
+        "Alchemy", "Speech", "Alteration", "Conjuration", "Destruction", "Illusion", "Restoration",
+        "Enchanting", "Health", "Magicka", "Stamina", "HealRate", "MagickaRate", "StaminaRate", "SpeedMult",
+        "InventoryWeight", "CarryWeight", "CriticalChance", "MeleeDamage", "UnarmedDamage", "Mass",
+        "VoicePoints", "VoiceRate", "DamageResist", "PoisonResist", "ResistFire", "ResistShock", "ResistFrost",
+        "ResistMagic", "ResistDisease", "PerceptionCondition", "EnduranceCondition", "LeftAttackCondition",
+        "RightAttackCondition", "LeftMobilityCondition", "RightMobilityCondition", "BrainCondition",
+        "Paralysis", "Invisibility", "NightEye", "DetectLifeRange", "WaterBreathing", "WaterWalking",
+        "IgnoreCrippledLimbs", "Fame", "Infamy", "JumpingBonus", "WardPower", "RightItemCharge", "ArmorPerks",
+        "ShieldPerks", "WardDeflection", "Variable01", "Variable02", "Variable03", "Variable04", "Variable05",
+        "Variable06", "Variable07", "Variable08", "Variable09", "Variable10", "BowSpeedBonus", "FavorActive",
+        "FavorsPerDay", "FavorsPerDayTimer", "LeftItemCharge", "AbsorbChance", "Blindness", "WeaponSpeedMult",
+        "ShoutRecoveryMult", "BowStaggerBonus", "Telekinesis", "FavorPointsBonus", "LastBribedIntimidated",
+        "LastFlattered", "MovementNoiseMult", "BypassVendorStolenCheck", "BypassVendorKeywordCheck",
+        "WaitingForPlayer", "OneHandedModifier", "TwoHandedModifier", "MarksmanModifier", "BlockModifier",
+        "SmithingModifier", "HeavyArmorModifier", "LightArmorModifier", "PickpocketModifier",
+        "LockpickingModifier", "SneakingModifier", "AlchemyModifier", "SpeechcraftModifier",
+        "AlterationModifier", "ConjurationModifier", "DestructionModifier", "IllusionModifier",
+        "RestorationModifier", "EnchantingModifier", "OneHandedSkillAdvance", "TwoHandedSkillAdvance",
+        "MarksmanSkillAdvance", "BlockSkillAdvance", "SmithingSkillAdvance", "HeavyArmorSkillAdvance",
+        "LightArmorSkillAdvance", "PickpocketSkillAdvance", "LockpickingSkillAdvance", "SneakingSkillAdvance",
+        "AlchemySkillAdvance", "SpeechcraftSkillAdvance", "AlterationSkillAdvance", "ConjurationSkillAdvance",
+        "DestructionSkillAdvance", "IllusionSkillAdvance", "RestorationSkillAdvance", "EnchantingSkillAdvance",
+        "LeftWeaponSpeedMultiply", "DragonSouls", "CombatHealthRegenMultiply", "OneHandedPowerModifier",
+        "TwoHandedPowerModifier", "MarksmanPowerModifier", "BlockPowerModifier", "SmithingPowerModifier",
+        "HeavyArmorPowerModifier", "LightArmorPowerModifier", "PickpocketPowerModifier",
+        "LockpickingPowerModifier", "SneakingPowerModifier", "AlchemyPowerModifier", "SpeechcraftPowerModifier",
+        "AlterationPowerModifier", "ConjurationPowerModifier", "DestructionPowerModifier",
+        "IllusionPowerModifier", "RestorationPowerModifier", "EnchantingPowerModifier", "DragonRend",
+        "AttackDamageMult", "HealRateMult", "MagickaRateMult", "StaminaRateMult", "WerewolfPerks",
+        "VampirePerks", "GrabActorOffset", "Grabbed", "DEPRECATED05", "ReflectDamage",
+    };
+
+    inline state& get()
+    {
+      static state s;
+      static const bool initialized = [] {
+        for (std::size_t i = 0; i < s.actor_value_infos.size(); ++i) {
+          s.actor_value_infos[i].enumName = actor_value_names[i];
+          s.actor_values.actorValues[i] = &s.actor_value_infos[i];
+        }
+        return true;
+      }();
+      (void)initialized;
+      return s;
+    }
+  }
+
+  template<typename T>
+  NiPointer<T> BSPointerHandle<T>::get() const
+  {
+    const auto& handles = stub::get().handles;
+    if (!value_ || value_ > handles.size()) return {};
+    return NiPointer<T>(handles[value_ - 1]);
+  }
+
+  inline TESForm* TESForm::LookupByID(const FormID form_id)
+  {
+    const auto& forms = stub::get().forms;
+    const auto it = forms.find(form_id);
+    return it != forms.end() ? it->second : nullptr;
+  }
+
+  inline TESForm* TESForm::LookupByEditorID(const std::string_view editor_id)
+  {
+    for (const auto& [form_id, form] : stub::get().forms) {
+      if (form->editorID == editor_id) return form;
+    }
+    return nullptr;
+  }
+
+  inline std::pair<std::unordered_map<FormID, TESForm*>*, std::reference_wrapper<BSReadWriteLock>> TESForm::GetAllForms()
+  {
+    auto& s = stub::get();
+    return {&s.forms, std::ref(s.forms_lock)};
+  }
+
+  inline bool Actor::IsPlayerRef() const { return this == stub::get().player; }
+
+  inline PlayerCharacter* PlayerCharacter::GetSingleton() { return stub::get().player; }
+  inline ActorValueList* ActorValueList::GetSingleton() { return &stub::get().actor_values; }
+  inline TESDataHandler* TESDataHandler::GetSingleton() { return &stub::get().data_handler; }
+  inline UI* UI::GetSingleton() { return &stub::get().ui; }
+
+  template<typename T>
+  std::vector<T*>& TESDataHandler::GetFormArray()
+  {
+    static std::vector<T*> forms;
+    forms.clear();
+    for (const auto& [form_id, form] : stub::get().forms) {
+      if (const auto t = form->template As<T>()) forms.push_back(t);
+    }
+    std::sort(forms.begin(), forms.end(), [](const T* a, const T* b) { return a->GetFormID() < b->GetFormID(); });
+    return forms;
+  }
+
+  inline void DebugNotification(const char* notification, const char*, bool)
+  {
+    ++stub::get().notifications;
+    SKSE::log::debug("[Notification] {}", notification ? notification : "");
+  }
+
+  inline void DebugMessageBox(const char* message)
+  {
+    ++stub::get().notifications;
+    SKSE::log::debug("[MessageBox] {}", message ? message : "");
+  }
+
+  inline void PlaySound(const char*) {}
+  inline void ShakeCamera(float, const NiPoint3&, float) {}
+
+  inline std::uint32_t GetDurationOfApplicationRunTime() { return stub::get().run_time_ms; }
+  inline float GetSecondsSinceLastFrame() { return stub::get().frame_delta; }
+
+  inline Setting* GetINISetting(const char* name)
+  {
+    const auto& settings = stub::get().settings;
+    const auto it = settings.find(name ? name : "");
+    return it != settings.end() ? it->second : nullptr;
+  }
+}
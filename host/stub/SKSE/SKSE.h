@@ -0,0 +1,172 @@
+#pragma once
+
+// Заглушка SKSE для wrenrim-host: логгер поверх spdlog, stl::enumeration и
+// SerializationInterface, который хранит записи ко-сейва в памяти.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace SKSE
+{
+  namespace log
+  {
+    using spdlog::critical;
+    using spdlog::debug;
+    using spdlog::error;
+    using spdlog::info;
+    using spdlog::trace;
+    using spdlog::warn;
+  }
+
+  namespace stl
+  {
+    /**
+     * @brief Битовые флаги поверх enum, как SKSE::stl::enumeration.
+     */
+    template<typename Enum, typename Underlying = std::underlying_type_t<Enum>>
+    class enumeration
+    {
+    public:
+      using enum_type = Enum;
+      using underlying_type = Underlying;
+
+      constexpr enumeration() noexcept = default;
+      constexpr enumeration(const Enum value) noexcept : impl_(static_cast<Underlying>(value)) {}
+
+      constexpr enumeration& operator=(const Enum value) noexcept
+      {
+        impl_ = static_cast<Underlying>(value);
+        return *this;
+      }
+
+      [[nodiscard]] constexpr Enum get() const noexcept { return static_cast<Enum>(impl_); }
+      [[nodiscard]] constexpr Underlying underlying() const noexcept { return impl_; }
+
+      template<typename... Args>
+      [[nodiscard]] constexpr bool any(const Args... values) const noexcept
+      {
+        return (impl_ & (static_cast<Underlying>(values) | ...)) != 0;
+      }
+
+      template<typename... Args>
+      [[nodiscard]] constexpr bool all(const Args... values) const noexcept
+      {
+        const auto mask = (static_cast<Underlying>(values) | ...);
+        return (impl_ & mask) == mask;
+      }
+
+      template<typename... Args>
+      constexpr enumeration& set(const Args... values) noexcept
+      {
+        impl_ |= (static_cast<Underlying>(values) | ...);
+        return *this;
+      }
+
+      template<typename... Args>
+      constexpr enumeration& reset(const Args... values) noexcept
+      {
+        impl_ &= ~(static_cast<Underlying>(values) | ...);
+        return *this;
+      }
+
+    private:
+      Underlying impl_{0};
+    };
+  }
+
+  /**
+   * @brief Ко-сейв в памяти. Записи, открытые через OpenRecord, читаются обратно
+   * после rewind(); FormID при загрузке переназначаются через remap_form_id.
+   */
+  class SerializationInterface
+  {
+  public:
+    bool OpenRecord(const std::uint32_t type, const std::uint32_t version)
+    {
+      records_.push_back({type, version, {}});
+      return true;
+    }
+
+    bool WriteRecordData(const void* buf, const std::uint32_t length)
+    {
+      if (records_.empty()) return false;
+      const auto bytes = static_cast<const char*>(buf);
+      records_.back().data.insert(records_.back().data.end(), bytes, bytes + length);
+      return true;
+    }
+
+    bool GetNextRecordInfo(std::uint32_t& type, std::uint32_t& version, std::uint32_t& length)
+    {
+      if (next_ >= records_.size()) return false;
+      current_ = next_++;
+      offset_ = 0;
+      const auto& record = records_[current_];
+      type = record.type;
+      version = record.version;
+      length = static_cast<std::uint32_t>(record.data.size());
+      return true;
+    }
+
+    std::uint32_t ReadRecordData(void* buf, const std::uint32_t length)
+    {
+      if (current_ >= records_.size()) return 0;
+      const auto& data = records_[current_].data;
+      const auto count = static_cast<std::uint32_t>(std::min<std::size_t>(length, data.size() - offset_));
+      std::memcpy(buf, data.data() + offset_, count);
+      offset_ += count;
+      return count;
+    }
+
+    bool ResolveFormID(const std::uint32_t old_form_id, std::uint32_t& new_form_id) const
+    {
+      new_form_id = remap_form_id ? remap_form_id(old_form_id) : old_form_id;
+      return new_form_id != 0;
+    }
+
+    /**
+     * @brief Начинает чтение записей с начала.
+     */
+    void rewind()
+    {
+      next_ = 0;
+      current_ = static_cast<std::size_t>(-1);
+      offset_ = 0;
+    }
+
+    void clear()
+    {
+      records_.clear();
+      rewind();
+    }
+
+    [[nodiscard]] std::size_t size_bytes() const
+    {
+      std::size_t total = 0;
+      for (const auto& record : records_) total += record.data.size();
+      return total;
+    }
+
+    // Переназначение FormID при загрузке (порядок плагинов изменился), 0 — форма удалена
+    std::uint32_t (*remap_form_id)(std::uint32_t){nullptr};
+
+  private:
+    struct record
+    {
+      std::uint32_t type{0};
+      std::uint32_t version{0};
+      std::vector<char> data;
+    };
+
+    std::vector<record> records_;
+    std::size_t next_{0};
+    std::size_t current_{static_cast<std::size_t>(-1)};
+    std::size_t offset_{0};
+  };
+}
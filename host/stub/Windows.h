@@ -0,0 +1,9 @@
+#pragma once
+
+// Заглушка WinAPI для wrenrim-host: сторонние DLL (po3_Tweaks) на хосте не загружаются.
+
+using HMODULE = void*;
+using FARPROC = void (*)();
+
+inline HMODULE GetModuleHandle(const char*) { return nullptr; }
+inline FARPROC GetProcAddress(HMODULE, const char*) { return nullptr; }
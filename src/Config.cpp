@@ -40,6 +40,35 @@ namespace config
 
 			// Performance
 			max_frame_time_budget_us = parse_size_t(ini["Performance"]["iMaxFrameTimeBudgetUs"], 2000);
+			worker_threads = parse_size_t(ini["Performance"]["iWorkerThreads"], 2);
+
+			// Logging
+			log_level = ini["Logging"]["sLevel"].empty() ? "info" : ini["Logging"]["sLevel"];
+			log_rate_limit = parse_size_t(ini["Logging"]["iRateLimitPerSecond"], 20);
+			module_log_levels.clear();
+			if (ini.has("LogLevels")) {
+				for (const auto& [module, level] : ini["LogLevels"]) {
+					module_log_levels.emplace(module, level);
+				}
+			}
+
+			// Debug
+			record_events = parse_bool(ini["Debug"]["bRecordEvents"], false);
+			if (const auto& record_path = ini["Debug"]["sRecordPath"]; !record_path.empty()) {
+				event_record_path = record_path;
+			}
+			trace_frames = parse_size_t(ini["Debug"]["iTraceFrames"], 300);
+			if (const auto& trace = ini["Debug"]["sTracePath"]; !trace.empty()) {
+				trace_path = trace;
+			}
+			profile_seconds = parse_size_t(ini["Debug"]["iProfileSeconds"], 10);
+			if (const auto& profile = ini["Debug"]["sProfilePath"]; !profile.empty()) {
+				profile_path = profile;
+			}
+			heap_attribution = parse_bool(ini["Debug"]["bHeapAttribution"], false);
+			if (const auto& heap = ini["Debug"]["sHeapSnapshotDir"]; !heap.empty()) {
+				heap_snapshot_dir = heap;
+			}
 
 			logger::info("Config loaded: Enabled={}, Heap={}MB, Budget={}us",
 				enabled, max_heap_size / (1024 * 1024), max_frame_time_budget_us);
@@ -50,6 +79,18 @@ namespace config
 		[[nodiscard]] size_t get_max_heap_size() const { return max_heap_size; }
 		[[nodiscard]] size_t get_initial_heap_size() const { return initial_heap_size; }
 		[[nodiscard]] size_t get_max_frame_time_budget_us() const { return max_frame_time_budget_us; }
+		[[nodiscard]] size_t get_worker_threads() const { return worker_threads; }
+		[[nodiscard]] const std::string& get_log_level() const { return log_level; }
+		[[nodiscard]] size_t get_log_rate_limit() const { return log_rate_limit; }
+		[[nodiscard]] const std::map<std::string, std::string>& get_module_log_levels() const { return module_log_levels; }
+		[[nodiscard]] bool is_event_recording_enabled() const { return record_events; }
+		[[nodiscard]] const std::string& get_event_record_path() const { return event_record_path; }
+		[[nodiscard]] size_t get_trace_frames() const { return trace_frames; }
+		[[nodiscard]] const std::string& get_trace_path() const { return trace_path; }
+		[[nodiscard]] size_t get_profile_seconds() const { return profile_seconds; }
+		[[nodiscard]] const std::string& get_profile_path() const { return profile_path; }
+		[[nodiscard]] bool is_heap_attribution_enabled() const { return heap_attribution; }
+		[[nodiscard]] const std::string& get_heap_snapshot_dir() const { return heap_snapshot_dir; }
 
 	private:
 		manager() = default;
@@ -64,6 +105,20 @@ namespace config
 		size_t max_heap_size{ 64 * 1024 * 1024 };
 		size_t initial_heap_size{ 8 * 1024 * 1024 };
 		size_t max_frame_time_budget_us{ 2000 };
+		size_t worker_threads{ 2 };
+		std::string log_level{ "info" };
+		size_t log_rate_limit{ 20 };
+		// Имя модуля (файл без расширения, в нижнем регистре) -> уровень
+		std::map<std::string, std::string> module_log_levels;
+		bool record_events{ false };
+		std::string event_record_path{ "Data/SKSE/Plugins/WrenRim/events.wrev" };
+		size_t trace_frames{ 300 };
+		std::string trace_path{ "Data/SKSE/Plugins/WrenRim/trace.json" };
+		size_t profile_seconds{ 10 };
+		std::string profile_path{ "Data/SKSE/Plugins/WrenRim/profile.folded" };
+		// Модуль-создатель объектов в снимках кучи; обход стека на каждый новый объект
+		bool heap_attribution{ false };
+		std::string heap_snapshot_dir{ "Data/SKSE/Plugins/WrenRim/Heap" };
 
 		void generate_default(const mINI::INIFile& file, mINI::INIStructure& ini)
 		{
@@ -72,6 +127,17 @@ namespace config
 			ini["Memory"]["iMaxHeapSizeMB"] = "64";
 			ini["Memory"]["iInitialHeapSizeMB"] = "8";
 			ini["Performance"]["iMaxFrameTimeBudgetUs"] = "2000";
+			ini["Performance"]["iWorkerThreads"] = "2";
+			ini["Logging"]["sLevel"] = "info";
+			ini["Logging"]["iRateLimitPerSecond"] = "20";
+			ini["Debug"]["bRecordEvents"] = "false";
+			ini["Debug"]["sRecordPath"] = "Data/SKSE/Plugins/WrenRim/events.wrev";
+			ini["Debug"]["iTraceFrames"] = "300";
+			ini["Debug"]["sTracePath"] = "Data/SKSE/Plugins/WrenRim/trace.json";
+			ini["Debug"]["iProfileSeconds"] = "10";
+			ini["Debug"]["sProfilePath"] = "Data/SKSE/Plugins/WrenRim/profile.folded";
+			ini["Debug"]["bHeapAttribution"] = "false";
+			ini["Debug"]["sHeapSnapshotDir"] = "Data/SKSE/Plugins/WrenRim/Heap";
 			if (!file.generate(ini, true)) {
 				logger::warn("Failed to generate default config file.");
 			}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "pch.h"
+#include <charconv>
+#include <Windows.h>
+
+namespace core::forms
+{
+  /**
+   * @brief Плоская хеш-таблица со строковыми ключами без учета регистра.
+   * Открытая адресация с линейным пробированием, хеш ключа хранится в слоте,
+   * поэтому при поиске строки сравниваются только при совпадении хешей.
+   * Ключи не копируются: строки должны жить дольше таблицы.
+   */
+  template<typename V>
+  class flat_string_map
+  {
+  public:
+    static uint64_t hash(std::string_view key)
+    {
+      uint64_t h = 14695981039346656037ull;
+      for (const auto c : key) {
+        h ^= static_cast<uint8_t>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+        h *= 1099511628211ull;
+      }
+      // 0 зарезервирован под пустой слот
+      return h ? h : 1;
+    }
+
+    static bool iequals(std::string_view lhs, std::string_view rhs)
+    {
+      if (lhs.size() != rhs.size()) return false;
+      for (std::size_t i = 0; i < lhs.size(); ++i) {
+        auto a = lhs[i];
+        auto b = rhs[i];
+        if (a >= 'A' && a <= 'Z') a += 'a' - 'A';
+        if (b >= 'A' && b <= 'Z') b += 'a' - 'A';
+        if (a != b) return false;
+      }
+      return true;
+    }
+
+    /**
+     * @brief Резервирует место под count ключей (загрузка не выше 50%).
+     */
+    void reserve(std::size_t count)
+    {
+      std::size_t capacity = 16;
+      while (capacity < count * 2) capacity <<= 1;
+      if (capacity > slots_.size()) rehash(capacity);
+    }
+
+    /**
+     * @brief Добавляет ключ, если его еще нет.
+     * @return true, если ключ добавлен.
+     */
+    bool insert(std::string_view key, V value)
+    {
+      if ((size_ + 1) * 2 > slots_.size()) rehash(slots_.empty() ? 16 : slots_.size() * 2);
+
+      const auto h = hash(key);
+      const auto mask = slots_.size() - 1;
+      for (auto i = h & mask;; i = (i + 1) & mask) {
+        auto& slot = slots_[i];
+        if (!slot.hash) {
+          slot = {h, key, std::move(value)};
+          ++size_;
+          return true;
+        }
+        if (slot.hash == h && iequals(slot.key, key)) return false;
+      }
+    }
+
+    /**
+     * @brief Ищет значение по ключу.
+     * @return Указатель на значение или nullptr.
+     */
+    [[nodiscard]] const V* find(std::string_view key) const
+    {
+      if (slots_.empty()) return nullptr;
+
+      const auto h = hash(key);
+      const auto mask = slots_.size() - 1;
+      for (auto i = h & mask;; i = (i + 1) & mask) {
+        const auto& slot = slots_[i];
+        if (!slot.hash) return nullptr;
+        if (slot.hash == h && iequals(slot.key, key)) return &slot.value;
+      }
+    }
+
+    [[nodiscard]] std::size_t size() const { return size_; }
+
+  private:
+    struct slot
+    {
+      uint64_t hash{0};
+      std::string_view key;
+      V value{};
+    };
+
+    void rehash(std::size_t capacity)
+    {
+      std::vector<slot> old = std::move(slots_);
+      slots_.assign(capacity, slot{});
+      const auto mask = capacity - 1;
+      for (auto& s : old) {
+        if (!s.hash) continue;
+        auto i = s.hash & mask;
+        while (slots_[i].hash) i = (i + 1) & mask;
+        slots_[i] = std::move(s);
+      }
+    }
+
+    std::vector<slot> slots_;
+    std::size_t size_{0};
+  };
+
+  /**
+   * @brief Индекс форм, строится один раз после загрузки данных (kDataLoaded).
+   * EditorID -> TESForm* и имя плагина -> TESFile* для разбора строк вида "0xABC~Plugin.esp".
+   * Формы, созданные после построения индекса, ищутся обычными средствами движка.
+   */
+  class form_index
+  {
+  public:
+    /**
+     * @brief Возвращает индекс, при первом обращении строит его.
+     */
+    static form_index* get_singleton()
+    {
+      static form_index singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Получает EditorID формы (из движка или через po3_Tweaks).
+     * Единственная реализация: core::utility::get_editor_id и обертки Wren вызывают ее.
+     * @param form Форма.
+     * @return EditorID или пустая строка. Указатель принадлежит движку/po3_Tweaks.
+     */
+    static const char* editor_id_of(const RE::TESForm* form)
+    {
+      using get_form_editor_id_t = const char* (*)(std::uint32_t);
+      static auto tweaks_get_editor_id = [] {
+        const auto tweaks = GetModuleHandle("po3_Tweaks");
+        return tweaks ? reinterpret_cast<get_form_editor_id_t>(GetProcAddress(tweaks, "GetFormEditorID")) : nullptr;
+      }();
+
+      if (!form) return "";
+
+      const auto editor_id = form->GetFormEditorID();
+      if (editor_id && *editor_id) return editor_id;
+
+      if (tweaks_get_editor_id) {
+        const auto tweaks_id = tweaks_get_editor_id(form->GetFormID());
+        if (tweaks_id) return tweaks_id;
+      }
+      return "";
+    }
+
+    /**
+     * @brief Ищет форму по EditorID.
+     * @param editor_id EditorID (без учета регистра).
+     * @return Форма или nullptr.
+     */
+    [[nodiscard]] RE::TESForm* by_editor_id(std::string_view editor_id) const
+    {
+      if (const auto form = editor_ids_.find(editor_id)) return *form;
+      return RE::TESForm::LookupByEditorID(editor_id);
+    }
+
+    /**
+     * @brief Ищет форму по EditorID с приведением типа.
+     */
+    template<typename T>
+    [[nodiscard]] T* by_editor_id(std::string_view editor_id) const
+    {
+      const auto form = by_editor_id(editor_id);
+      return form ? form->As<T>() : nullptr;
+    }
+
+    /**
+     * @brief Разбирает строку вида "0xABC~Plugin.esp" в полный FormID.
+     * @param plugin_id Локальный FormID (hex) и имя плагина через '~'.
+     * @return FormID или 0, если строка некорректна или плагин не загружен.
+     */
+    [[nodiscard]] RE::FormID form_id_by_plugin_id(std::string_view plugin_id) const
+    {
+      const auto delimiter = plugin_id.find('~');
+      if (delimiter == std::string_view::npos) return 0;
+
+      auto hex = plugin_id.substr(0, delimiter);
+      const auto plugin = plugin_id.substr(delimiter + 1);
+      if (hex.starts_with("0x") || hex.starts_with("0X")) hex.remove_prefix(2);
+
+      RE::FormID local_id = 0;
+      const auto [end, ec] = std::from_chars(hex.data(), hex.data() + hex.size(), local_id, 16);
+      if (ec != std::errc() || end != hex.data() + hex.size()) return 0;
+
+      const RE::TESFile* file = nullptr;
+      if (const auto indexed = plugins_.find(plugin)) {
+        file = *indexed;
+      } else if (const auto data_handler = RE::TESDataHandler::GetSingleton()) {
+        file = data_handler->LookupModByName(plugin);
+      }
+      if (!file) return 0;
+
+      if (file->IsLight()) {
+        return 0xFE000000 | (static_cast<RE::FormID>(file->GetSmallFileCompileIndex()) << 12) | (local_id & 0xFFF);
+      }
+      return (static_cast<RE::FormID>(file->GetCompileIndex()) << 24) | (local_id & 0xFFFFFF);
+    }
+
+    /**
+     * @brief Количество проиндексированных EditorID.
+     */
+    [[nodiscard]] std::size_t editor_id_count() const { return editor_ids_.size(); }
+
+  private:
+    form_index() { build(); }
+
+    void build()
+    {
+      if (const auto data_handler = RE::TESDataHandler::GetSingleton()) {
+        for (const auto file : data_handler->files) {
+          if (file && file->compileIndex != 0xFF) {
+            plugins_.insert(file->fileName, file);
+          }
+        }
+      }
+
+      const auto& [forms, lock] = RE::TESForm::GetAllForms();
+      if (!forms) return;
+
+      RE::BSReadLockGuard locker{lock};
+      editor_ids_.reserve(forms->size());
+      for (const auto& [form_id, form] : *forms) {
+        const auto editor_id = editor_id_of(form);
+        if (*editor_id) {
+          editor_ids_.insert(editor_id, form);
+        }
+      }
+
+      logger::info("Form index built: {} EditorIDs, {} plugins", editor_ids_.size(), plugins_.size());
+    }
+
+    flat_string_map<RE::TESForm*> editor_ids_;
+    flat_string_map<const RE::TESFile*> plugins_;
+  };
+}
@@ -46,6 +46,8 @@ namespace core::hooks
         return on_update_character_original(character, delta);
       }
 
+      wren::wrappers::actor_grid::get_singleton()->update(character);
+
       wren::wrappers::actor wren_actor(character);
 
       wren::script_engine::engine::get_singleton()->dispatch("OnUpdateCharacterStart", wren_actor, last_player_delta);
@@ -65,6 +67,8 @@ namespace core::hooks
         return on_update_player_character_original(character, delta);
       }
 
+      wren::wrappers::actor_grid::get_singleton()->update(character);
+
       wren::wrappers::actor wren_actor(character);
 
       wren::script_engine::engine::get_singleton()->dispatch("OnUpdatePlayerStart", wren_actor,
@@ -179,6 +183,7 @@ namespace core::hooks
     static constexpr auto addr_vtable_actor_owner_character = RE::Character::VTABLE[4];
     static constexpr auto addr_vtable_actor_owner_player_character = RE::PlayerCharacter::VTABLE[4];
     static constexpr auto offset_vtable_effect_added = RELOCATION_OFFSET(0x08, 0x08);
+    static constexpr auto offset_vtable_effect_removed = RELOCATION_OFFSET(0x09, 0x09);
 
     static auto on_effect_added_character(RE::MagicTarget* magic_target, RE::ActiveEffect* active_effect) -> void
     {
@@ -191,6 +196,7 @@ namespace core::hooks
       wren::script_engine::engine::get_singleton()->dispatch("OnEffectAddedCharacterStart", wren_active_effect);
 
       on_effect_added_character_original(magic_target, active_effect);
+      wren::wrappers::active_effect_index::get_singleton()->mark_stale(magic_target);
 
       wren::script_engine::engine::get_singleton()->dispatch("OnEffectAddedCharacterEnd", wren_active_effect);
     }
@@ -207,13 +213,30 @@ namespace core::hooks
       wren::script_engine::engine::get_singleton()->dispatch("OnEffectAddedPlayerStart", wren_active_effect);
 
       on_effect_added_player_character_original(magic_target, active_effect);
+      wren::wrappers::active_effect_index::get_singleton()->mark_stale(magic_target);
 
       wren::script_engine::engine::get_singleton()->dispatch("OnEffectAddedPlayerEnd", wren_active_effect);
     }
 
+    static auto on_effect_removed_character(RE::MagicTarget* magic_target, RE::ActiveEffect* active_effect) -> void
+    {
+      on_effect_removed_character_original(magic_target, active_effect);
+      wren::wrappers::active_effect_index::get_singleton()->mark_stale(magic_target);
+    }
+
+    static auto on_effect_removed_player_character(RE::MagicTarget* magic_target,
+                                                   RE::ActiveEffect* active_effect) -> void
+    {
+      on_effect_removed_player_character_original(magic_target, active_effect);
+      wren::wrappers::active_effect_index::get_singleton()->mark_stale(magic_target);
+    }
+
     static inline REL::Relocation<decltype(on_effect_added_character)> on_effect_added_character_original;
     static inline REL::Relocation<decltype(on_effect_added_player_character)>
     on_effect_added_player_character_original;
+    static inline REL::Relocation<decltype(on_effect_removed_character)> on_effect_removed_character_original;
+    static inline REL::Relocation<decltype(on_effect_removed_player_character)>
+    on_effect_removed_player_character_original;
 
     static auto install_hook() -> void
     {
@@ -225,6 +248,14 @@ namespace core::hooks
                   offset_vtable_effect_added,
                   on_effect_added_player_character,
                   on_effect_added_player_character_original, "on_effect_added_player_character");
+      write_vfunc(REL::Relocation<>{addr_vtable_actor_owner_character},
+                  offset_vtable_effect_removed,
+                  on_effect_removed_character,
+                  on_effect_removed_character_original, "on_effect_removed_character");
+      write_vfunc(REL::Relocation<>{addr_vtable_actor_owner_player_character},
+                  offset_vtable_effect_removed,
+                  on_effect_removed_player_character,
+                  on_effect_removed_player_character_original, "on_effect_removed_player_character");
     }
   };
 
@@ -4,8 +4,14 @@
 #include "spdlog/sinks/basic_file_sink.h"
 #include "spdlog/pattern_formatter.h"
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 export module WrenRim.Core.LoggerSetup;
 
+import WrenRim.Config;
+
 namespace core::logger_setup
 {
   class formatter_flag : public spdlog::custom_flag_formatter
@@ -13,6 +19,9 @@ namespace core::logger_setup
   public:
     void format(const spdlog::details::log_msg& msg, const std::tm&, spdlog::memory_buf_t& dest) override
     {
+      // Служебные записи без места вызова выравнивать не по чему
+      if (msg.source.empty()) return;
+
       size_t longestFileName = "DamageResistSystemSettingsTest.ixx"s.size();
       size_t maxDigitsInLineNumber = 5;
       size_t digitsInLineNumber = std::to_string(msg.source.line).size();
@@ -32,6 +41,324 @@ namespace core::logger_setup
     }
   };
 
+  /**
+   * @brief Запись журнала в очереди: сообщение уже отформатировано вызывающим потоком.
+   */
+  struct log_entry
+  {
+    spdlog::level::level_enum level{spdlog::level::info};
+    spdlog::log_clock::time_point time;
+    size_t thread_id{0};
+    spdlog::source_loc source;
+    std::string payload;
+  };
+
+  /**
+   * @brief Ограниченная очередь без блокировок, много писателей и один читатель (схема Вьюкова).
+   * Если очередь полна, запись отклоняется — вызывающий поток никогда не ждет.
+   * Строки в ячейках переиспользуются, после первого круга запись обычно обходится без выделения памяти.
+   */
+  class log_queue
+  {
+  public:
+    explicit log_queue(const size_t capacity) :
+        cells_(std::make_unique<cell[]>(std::bit_ceil(capacity))), mask_(std::bit_ceil(capacity) - 1)
+    {
+      for (size_t i = 0; i <= mask_; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    template<typename Fill>
+    bool try_push(Fill&& fill)
+    {
+      auto pos = enqueue_.load(std::memory_order_relaxed);
+      for (;;) {
+        auto& c = cells_[pos & mask_];
+        const auto seq = c.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+          if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            fill(c.entry);
+            c.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if (diff < 0) {
+          return false;
+        }
+        else {
+          pos = enqueue_.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    template<typename Consume>
+    bool try_pop(Consume&& consume)
+    {
+      const auto pos = dequeue_;
+      auto& c = cells_[pos & mask_];
+      if (c.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+      consume(c.entry);
+      dequeue_ = pos + 1;
+      c.sequence.store(pos + mask_ + 1, std::memory_order_release);
+      return true;
+    }
+
+  private:
+    struct cell
+    {
+      std::atomic<size_t> sequence{0};
+      log_entry entry;
+    };
+
+    std::unique_ptr<cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueue_{0};
+    // Только поток записи
+    alignas(64) size_t dequeue_{0};
+  };
+
+  /**
+   * @brief Уровни журнала по модулям: имя модуля — имя исходного файла без расширения в нижнем регистре
+   * (scriptengine, hooks, scriptruntime для System.print из скриптов).
+   */
+  struct module_levels
+  {
+    spdlog::level::level_enum fallback{spdlog::level::info};
+    std::map<std::string, spdlog::level::level_enum, std::less<>> levels;
+
+    [[nodiscard]] spdlog::level::level_enum find(const char* filename) const
+    {
+      if (levels.empty() || !filename) return fallback;
+
+      std::string_view name(filename);
+      if (const auto slash = name.find_last_of("\\/"); slash != std::string_view::npos) name.remove_prefix(slash + 1);
+      if (const auto dot = name.find('.'); dot != std::string_view::npos) name = name.substr(0, dot);
+
+      std::string lower(name);
+      std::ranges::transform(lower, lower.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+      const auto it = levels.find(lower);
+      return it != levels.end() ? it->second : fallback;
+    }
+  };
+
+  /**
+   * @brief Асинхронный sink: вызывающий поток фильтрует сообщение по уровню модуля, ограничивает частоту
+   * по месту вызова и кладет его в очередь, файл пишет отдельный поток.
+   *
+   * Место вызова — файл и строка logger::*. Одинаковые сообщения подряд с одного места схлопываются,
+   * больше rate_limit сообщений в секунду с одного места отбрасываются. Раз в секунду поток записи
+   * пишет, сколько сообщений было схлопнуто и отброшено. Счетчики приблизительные, если одно место
+   * пишут несколько потоков одновременно.
+   */
+  class async_file_sink final : public spdlog::sinks::sink
+  {
+  public:
+    static constexpr size_t site_count = 1024;
+    static constexpr size_t site_probes = 16;
+
+    async_file_sink(std::shared_ptr<spdlog::sinks::sink> target, std::string logger_name, const size_t queue_size) :
+        target_(std::move(target)), logger_name_(std::move(logger_name)), queue_(queue_size),
+        levels_(std::make_shared<const module_levels>())
+    {
+      writer_ = std::jthread([this](const std::stop_token& stop) { write_loop(stop); });
+    }
+
+    // jthread останавливает поток записи, остаток очереди попадает в файл
+    ~async_file_sink() override = default;
+
+    void log(const spdlog::details::log_msg& msg) override
+    {
+      auto& site = find_site(msg.source);
+      if (msg.level < site_level(site, msg.source)) return;
+      if (!admit(site, msg)) return;
+
+      const bool pushed = queue_.try_push([&](log_entry& e) {
+        e.level = msg.level;
+        e.time = msg.time;
+        e.thread_id = msg.thread_id;
+        e.source = msg.source;
+        e.payload.assign(msg.payload.data(), msg.payload.size());
+      });
+      if (!pushed) dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Сброс на диск делает поток записи после каждой пачки
+    void flush() override {}
+
+    void set_pattern(const std::string& pattern) override
+    {
+      std::scoped_lock lock(target_lock_);
+      target_->set_pattern(pattern);
+    }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override
+    {
+      std::scoped_lock lock(target_lock_);
+      target_->set_formatter(std::move(formatter));
+    }
+
+    void set_levels(const module_levels& levels)
+    {
+      levels_.store(std::make_shared<const module_levels>(levels), std::memory_order_release);
+      levels_generation_.fetch_add(1, std::memory_order_release);
+    }
+
+    void set_rate_limit(const uint32_t per_second) { rate_limit_.store(per_second, std::memory_order_relaxed); }
+
+  private:
+    struct call_site
+    {
+      std::atomic<uint64_t> key{0};
+      // Уровень модуля места вызова, пересчитывается после set_levels
+      std::atomic<uint32_t> levels_generation{0};
+      std::atomic<int> level{spdlog::level::trace};
+      std::atomic<int64_t> window{0};
+      std::atomic<uint32_t> in_window{0};
+      std::atomic<uint64_t> last_hash{0};
+      std::atomic<uint32_t> repeated{0};
+      std::atomic<uint32_t> suppressed{0};
+      spdlog::source_loc source;
+      std::atomic<bool> ready{false};
+    };
+
+    static uint64_t site_key(const spdlog::source_loc& source)
+    {
+      const auto ptr = reinterpret_cast<uintptr_t>(source.filename);
+      return (static_cast<uint64_t>(ptr) * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(source.line)) | 1;
+    }
+
+    call_site& find_site(const spdlog::source_loc& source)
+    {
+      const auto key = site_key(source);
+      for (size_t i = 0; i < site_probes; ++i) {
+        auto& site = sites_[(key + i) & (site_count - 1)];
+        auto current = site.key.load(std::memory_order_acquire);
+        if (current == key) return site;
+        if (current == 0 && site.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+          site.source = source;
+          site.ready.store(true, std::memory_order_release);
+          return site;
+        }
+        if (current == key) return site;
+      }
+      // Таблица переполнена: общее место без ограничения частоты
+      return overflow_site_;
+    }
+
+    spdlog::level::level_enum site_level(call_site& site, const spdlog::source_loc& source)
+    {
+      const auto generation = levels_generation_.load(std::memory_order_acquire);
+      if (site.levels_generation.load(std::memory_order_acquire) != generation) {
+        site.level.store(levels_.load(std::memory_order_acquire)->find(source.filename), std::memory_order_relaxed);
+        site.levels_generation.store(generation, std::memory_order_release);
+      }
+      return static_cast<spdlog::level::level_enum>(site.level.load(std::memory_order_relaxed));
+    }
+
+    bool admit(call_site& site, const spdlog::details::log_msg& msg)
+    {
+      if (&site == &overflow_site_) return true;
+
+      const auto hash = std::hash<std::string_view>{}(std::string_view(msg.payload.data(), msg.payload.size())) | 1;
+      if (site.last_hash.exchange(hash, std::memory_order_relaxed) == hash) {
+        site.repeated.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      const auto second =
+        std::chrono::duration_cast<std::chrono::seconds>(msg.time.time_since_epoch()).count();
+      if (site.window.exchange(second, std::memory_order_relaxed) != second) {
+        site.in_window.store(0, std::memory_order_relaxed);
+      }
+      const auto limit = rate_limit_.load(std::memory_order_relaxed);
+      if (site.in_window.fetch_add(1, std::memory_order_relaxed) >= limit && limit) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      return true;
+    }
+
+    void write_loop(const std::stop_token& stop)
+    {
+      auto last_report = std::chrono::steady_clock::now();
+      while (!stop.stop_requested()) {
+        const bool wrote = write_pending();
+        if (const auto now = std::chrono::steady_clock::now(); now - last_report >= std::chrono::seconds(1)) {
+          last_report = now;
+          report_suppressed();
+        }
+        if (!wrote) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      write_pending();
+      report_suppressed();
+    }
+
+    bool write_pending()
+    {
+      std::scoped_lock lock(target_lock_);
+      bool wrote = false;
+      while (queue_.try_pop([&](const log_entry& e) {
+        spdlog::details::log_msg msg(e.time, e.source, logger_name_, e.level, e.payload);
+        msg.thread_id = e.thread_id;
+        target_->log(msg);
+      })) {
+        wrote = true;
+      }
+      if (wrote) target_->flush();
+      return wrote;
+    }
+
+    void report_suppressed()
+    {
+      std::scoped_lock lock(target_lock_);
+      bool wrote = false;
+      const auto write = [&](const spdlog::source_loc& source, const std::string& text) {
+        spdlog::details::log_msg msg(source, logger_name_, spdlog::level::info, text);
+        target_->log(msg);
+        wrote = true;
+      };
+
+      for (auto& site : sites_) {
+        if (!site.ready.load(std::memory_order_acquire)) continue;
+        const auto repeated = site.repeated.exchange(0, std::memory_order_relaxed);
+        const auto suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+        if (!repeated && !suppressed) continue;
+        // Следующее такое же сообщение снова попадет в журнал
+        site.last_hash.store(0, std::memory_order_relaxed);
+        std::string text = "(";
+        if (repeated) text += "last message repeated " + std::to_string(repeated) + " times";
+        if (repeated && suppressed) text += ", ";
+        if (suppressed) text += std::to_string(suppressed) + " messages over rate limit";
+        write(site.source, text + ")");
+      }
+      if (const auto dropped = dropped_.exchange(0, std::memory_order_relaxed)) {
+        write({__FILE__, __LINE__, __func__}, "(" + std::to_string(dropped) + " messages dropped, log queue full)");
+      }
+      if (wrote) target_->flush();
+    }
+
+    std::shared_ptr<spdlog::sinks::sink> target_;
+    std::mutex target_lock_;
+    std::string logger_name_;
+    log_queue queue_;
+    std::array<call_site, site_count> sites_;
+    call_site overflow_site_;
+    std::atomic<std::shared_ptr<const module_levels>> levels_;
+    std::atomic<uint32_t> levels_generation_{1};
+    std::atomic<uint32_t> rate_limit_{20};
+    std::atomic<uint64_t> dropped_{0};
+    std::jthread writer_;
+  };
+
+  std::shared_ptr<async_file_sink> async_sink;
+
+  // Неизвестное имя уровня — info, а не off (from_str), чтобы опечатка в конфиге не выключала журнал
+  spdlog::level::level_enum parse_level(const std::string& name)
+  {
+    const auto level = spdlog::level::from_str(name);
+    return level == spdlog::level::off && name != "off" ? spdlog::level::info : level;
+  }
+
   export auto setup_log() -> void
   {
     auto logs_folder = SKSE::log::log_directory();
@@ -40,16 +367,47 @@ namespace core::logger_setup
 
     auto plugin_name = SKSE::PluginDeclaration::GetSingleton()->GetName();
     auto log_file_path = *logs_folder / std::format("{}.log", plugin_name);
-    auto file_logger_ptr = std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_file_path.string(), true);
-    auto logger_ptr = std::make_shared<spdlog::logger>("log", std::move(file_logger_ptr));
-
-    spdlog::set_default_logger(std::move(logger_ptr));
-    spdlog::set_level(spdlog::level::debug);
-    spdlog::flush_on(spdlog::level::trace);
+    // Файл пишет только поток записи async_file_sink
+    auto file_sink_ptr = std::make_shared<spdlog::sinks::basic_file_sink_st>(log_file_path.string(), true);
 
     auto formatter = std::make_unique<spdlog::pattern_formatter>();
     formatter->add_flag<formatter_flag>('*').set_pattern("[%H:%M:%S.%e][%s:%#]%*%v");
-    spdlog::set_formatter(std::move(formatter));
+    file_sink_ptr->set_formatter(std::move(formatter));
     //spdlog::set_pattern("[%H:%M:%S.%e] %16s:%-5# | %v"); // %<x>s: x = # of characters in longest file name//https://github.com/gabime/spdlog/wiki/Custom-formatting
+
+    async_sink = std::make_shared<async_file_sink>(std::move(file_sink_ptr), "log", 8192);
+    auto logger_ptr = std::make_shared<spdlog::logger>("log", async_sink);
+
+    spdlog::set_default_logger(std::move(logger_ptr));
+    spdlog::set_level(spdlog::level::debug);
+    spdlog::flush_on(spdlog::level::off);
+  }
+
+  /**
+   * @brief Применяет уровни и ограничение частоты из конфига (после config::manager::load).
+   */
+  export auto apply_config() -> void
+  {
+    if (!async_sink) return;
+
+    const auto cfg = config::manager::get_singleton();
+    module_levels levels;
+    levels.fallback = cfg->is_logging_enabled() ? parse_level(cfg->get_log_level()) : spdlog::level::off;
+
+    // Логгер отсекает сообщения ниже самого подробного из уровней до форматирования, остальное — sink
+    auto lowest = levels.fallback;
+    if (cfg->is_logging_enabled()) {
+      for (const auto& [module, level] : cfg->get_module_log_levels()) {
+        const auto value = parse_level(level);
+        levels.levels.emplace(module, value);
+        lowest = std::min(lowest, value);
+      }
+    }
+
+    async_sink->set_levels(levels);
+    async_sink->set_rate_limit(static_cast<uint32_t>(cfg->get_log_rate_limit()));
+    spdlog::set_level(lowest);
+    logger::info("Logging: level {}, {} module overrides, {} messages/s per call site",
+                 cfg->get_log_level(), levels.levels.size(), cfg->get_log_rate_limit());
   }
 }
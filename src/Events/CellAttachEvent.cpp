@@ -0,0 +1,47 @@
+module;
+
+#include "pch.h"
+#include "Wren/Wrappers/ActiveEffectIndex.hpp"
+#include "Wren/Wrappers/ActorGrid.hpp"
+#include "Wren/Wrappers/ActorHandleCache.hpp"
+
+export module WrenRim.Events.CellAttachEvent;
+
+namespace events::cell_attach_event {
+
+export struct cell_attach_event_handler final : RE::BSTEventSink<RE::TESCellAttachDetachEvent>
+{
+  static auto get_singleton() -> cell_attach_event_handler*
+  {
+    static cell_attach_event_handler singleton;
+    return std::addressof(singleton);
+  }
+
+  static auto register_handler() -> void
+  {
+    logger::info("Start register cell attach detach handler"sv);
+    if (const auto holder = RE::ScriptEventSourceHolder::GetSingleton()) {
+      holder->AddEventSink<RE::TESCellAttachDetachEvent>(get_singleton());
+      logger::info("Finish register cell attach detach handler"sv);
+    }
+  }
+
+  // При выгрузке актера сбрасываем его записи в кеше хендлов и индексе эффектов и убираем из пространственной сетки
+  auto ProcessEvent(
+      const RE::TESCellAttachDetachEvent* attach_event,
+      RE::BSTEventSource<RE::TESCellAttachDetachEvent>* event_source) -> RE::BSEventNotifyControl override
+  {
+    if (!attach_event || !event_source || attach_event->attached || !attach_event->reference) {
+      return RE::BSEventNotifyControl::kContinue;
+    }
+
+    if (const auto actor = attach_event->reference->As<RE::Actor>()) {
+      const auto handle = actor->GetHandle();
+      wren::wrappers::actor_handle_cache::get_singleton()->invalidate(handle);
+      wren::wrappers::active_effect_index::get_singleton()->invalidate(handle);
+      wren::wrappers::actor_grid::get_singleton()->remove(actor);
+    }
+    return RE::BSEventNotifyControl::kContinue;
+  }
+};
+}
@@ -4,6 +4,7 @@ module;
 
 export module WrenRim.Events;
 
+import WrenRim.Events.CellAttachEvent;
 import WrenRim.Events.MenuEvent;
 
 namespace events
@@ -11,5 +12,6 @@ namespace events
   export auto register_events() -> void
   {
     menu_event::menu_event_handler::register_handler();
+    cell_attach_event::cell_attach_event_handler::register_handler();
   }
 }
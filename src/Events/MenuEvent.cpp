@@ -1,6 +1,7 @@
 module;
 
 #include "pch.h"
+#include "Wren/Wrappers/MovieHandle.hpp"
 
 export module WrenRim.Events.MenuEvent;
 
@@ -34,6 +35,11 @@ export struct menu_event_handler final : RE::BSTEventSink<RE::MenuOpenCloseEvent
       return RE::BSEventNotifyControl::kContinue;
     }
 
+    // Закрытое меню отпускает свой MovieView, кеш должен отпустить его тоже
+    if (!menu_event->opening) {
+      wren::wrappers::movie_view_cache::get_singleton()->invalidate(menu_event->menuName.c_str());
+    }
+
     auto ctx = events_ctx::process_event_menu_ctx{menu_event, event_source, menu_event->menuName, menu_event->opening};
     return RE::BSEventNotifyControl::kContinue;
   }
@@ -2,6 +2,10 @@
 
 #include "pch.h"
 #include "library/SKSEMenuFramework.h"
+#include "Wren/EventRecorder.hpp"
+#include "Wren/HeapSnapshot.hpp"
+#include "Wren/Profiler.hpp"
+#include "Wren/Tracer.hpp"
 
 export module WrenRim.UI.SKSEMenu;
 
@@ -29,6 +33,144 @@ namespace ui::skse_menu
               engine->reload_user_mods();
           }
       }
+
+      auto recorder = wren::event_record::recorder::get_singleton();
+      if (recorder->recording()) {
+          ImGui::Text("Recording events: %llu recorded, %llu dropped",
+                      static_cast<unsigned long long>(recorder->recorded()),
+                      static_cast<unsigned long long>(recorder->dropped()));
+          if (ImGui::Button("Stop Event Recording")) {
+              recorder->stop();
+          }
+      }
+      else if (ImGui::Button("Start Event Recording") && cfg) {
+          recorder->start(cfg->get_event_record_path());
+      }
+
+      // Захват трассировки кадров (Chrome trace JSON)
+      static int trace_frames = cfg ? static_cast<int>(cfg->get_trace_frames()) : 300;
+      auto tracer = wren::tracing::tracer::get_singleton();
+      if (tracer->capturing()) {
+          ImGui::Text("Tracing: frame %u / %u", tracer->frames_captured(), tracer->frames_requested());
+      }
+      else if (tracer->exporting()) {
+          ImGui::Text("Tracing: writing file...");
+      }
+      else {
+          ImGui::InputInt("Trace Frames", &trace_frames);
+          trace_frames = std::clamp(trace_frames, 1, 10000);
+          if (ImGui::Button("Capture Trace") && cfg) {
+              tracer->capture(static_cast<std::uint32_t>(trace_frames), cfg->get_trace_path());
+          }
+      }
+
+      // Сэмплирующий профайлер скриптов (folded stacks для flame graph)
+      static int profile_seconds = cfg ? static_cast<int>(cfg->get_profile_seconds()) : 10;
+      auto profiler = wren::profiling::profiler::get_singleton();
+      if (profiler->profiling()) {
+          ImGui::Text("Profiling: %.1f s left, %llu samples", profiler->seconds_left(),
+                      static_cast<unsigned long long>(profiler->samples()));
+          if (ImGui::Button("Stop Profiling")) {
+              profiler->request_stop();
+          }
+      }
+      else if (profiler->writing()) {
+          ImGui::Text("Profiling: writing file...");
+      }
+      else {
+          ImGui::InputInt("Profile Seconds", &profile_seconds);
+          profile_seconds = std::clamp(profile_seconds, 1, 600);
+          if (ImGui::Button("Start Profiling") && cfg) {
+              profiler->start(std::chrono::seconds(profile_seconds), cfg->get_profile_path());
+          }
+      }
+
+      // Снимок кучи; разница с предыдущим снимком (в том числе до горячей перезагрузки) пишется в лог
+      auto snapshotter = wren::heap_snapshot::snapshotter::get_singleton();
+      if (snapshotter->pending()) {
+          ImGui::Text("Heap snapshot: waiting for next frame...");
+      }
+      else if (ImGui::Button("Heap Snapshot") && cfg) {
+          snapshotter->request(cfg->get_heap_snapshot_dir());
+      }
+      if (snapshotter->taken()) {
+          ImGui::Text("Last snapshot: %s", snapshotter->last_path().c_str());
+      }
+  }
+
+  // Строки, введенные в консоль, для перебора стрелками
+  std::vector<std::string> console_inputs;
+  int console_input_pos = -1;
+
+  int console_input_callback(ImGuiInputTextCallbackData* data)
+  {
+    if (data->EventFlag != ImGuiInputTextFlags_CallbackHistory || console_inputs.empty()) return 0;
+
+    const int count = static_cast<int>(console_inputs.size());
+    if (data->EventKey == ImGuiKey_UpArrow) {
+      console_input_pos = console_input_pos < 0 ? count - 1 : std::max(0, console_input_pos - 1);
+    }
+    else if (data->EventKey == ImGuiKey_DownArrow && console_input_pos >= 0) {
+      console_input_pos = console_input_pos + 1 < count ? console_input_pos + 1 : -1;
+    }
+
+    const auto text = console_input_pos >= 0 ? std::string_view(console_inputs[console_input_pos]) : std::string_view();
+    ImGui::ImGuiInputTextCallbackDataManager::DeleteChars(data, 0, data->BufTextLen);
+    ImGui::ImGuiInputTextCallbackDataManager::InsertChars(data, 0, text.data(), text.data() + text.size());
+    return 0;
+  }
+
+  auto __stdcall render_console() -> void
+  {
+      auto engine = wren::script_engine::engine::get_singleton();
+      auto& console = engine->get_console();
+
+      ImGui::TextDisabled("Expressions and statements run in module \"console\". :bench N expr, :clear");
+
+      const auto history = console.history();
+      static std::size_t last_count = 0;
+      const float footer = ImGui::GetFrameHeightWithSpacing();
+      if (ImGui::BeginChild("##console_history", ImVec2(0, -footer), ImGuiChildFlags_Border)) {
+          for (std::size_t i = 0; i < history.size(); ++i) {
+              const auto& e = history[i];
+              ImGui::PushID(static_cast<int>(i));
+              ImGui::TextUnformatted(("> " + e.input).c_str());
+              if (e.error) {
+                  ImGui::TextColored(ImVec4(1.f, 0.4f, 0.4f, 1.f), "%s", e.output.c_str());
+              }
+              else if (!e.output.empty()) {
+                  ImGui::TextWrapped("%s", e.output.c_str());
+              }
+              if (e.type.empty()) {
+                  ImGui::TextDisabled("compile %.1f us, run %.1f us", e.compile_us, e.run_us);
+              }
+              else {
+                  ImGui::TextDisabled("%s, compile %.1f us, run %.1f us", e.type.c_str(), e.compile_us, e.run_us);
+              }
+              ImGui::PopID();
+          }
+          if (history.size() != last_count) {
+              ImGui::SetScrollHereY(1.0f);
+              last_count = history.size();
+          }
+      }
+      ImGui::EndChild();
+
+      static char input[1024] = {};
+      const bool entered = ImGui::InputText("##console_input", input, sizeof(input),
+                                            ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_CallbackHistory,
+                                            console_input_callback);
+      ImGui::SameLine();
+      if ((entered || ImGui::Button("Run")) && input[0]) {
+          console_inputs.emplace_back(input);
+          console_input_pos = -1;
+          console.submit(input);
+          input[0] = '\0';
+          ImGui::SetKeyboardFocusHere(-1);
+          // Как и горячая перезагрузка выше, меню рисуется в потоке игры: выполняем сразу,
+          // не дожидаясь кадра (пока меню открыто, игра на паузе)
+          engine->process_console();
+      }
   }
 
   export auto register_skse_menu() -> void
@@ -44,5 +186,8 @@ namespace ui::skse_menu
     static constexpr auto config_title = "Config";
     SKSEMenuFramework::AddSectionItem(config_title, render_main);
 
+    static constexpr auto console_title = "Console";
+    SKSEMenuFramework::AddSectionItem(console_title, render_console);
+
   }
 }
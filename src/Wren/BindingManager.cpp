@@ -1,6 +1,7 @@
 module;
 
 #include "pch.h"
+#include "Core/FormIndex.hpp"
 #include "Wren/Wrappers/Wrappers.hpp"
 
 export module WrenRim.Wren.BindingManager;
@@ -9,9 +10,17 @@ export module WrenRim.Wren.BindingManager;
 namespace wren::binding_manager {
 
  export void bind_wrappers(wrenbind17::VM& vm) {
+        // ActorValue name table (ActorValueList is ready after kDataLoaded)
+        wrappers::actor_value_table::get_singleton();
+        // EditorID / plugin index for Form.byEditorId and Form.byPluginId
+        core::forms::form_index::get_singleton();
+        // Dense keyword indices for hasKeyword / hasAnyKeyword / hasAllKeywords
+        wrappers::keyword_bitsets::get_singleton();
+
         // Bind Actor to "Skyrim/Actor"
         auto& mActor = vm.module("Skyrim/Actor");
         wrappers::actor::bind(mActor);
+        wrappers::actor_value_buffer::bind(mActor);
 
         // Bind Potion to "Skyrim/AlchemyItem"
         auto& mAlchemyItem = vm.module("Skyrim/AlchemyItem");
@@ -36,6 +45,7 @@ namespace wren::binding_manager {
         // Bind UI to "Skyrim/UI"
         auto& mUI = vm.module("Skyrim/UI");
         wrappers::ui::bind(mUI);
+        wrappers::movie_handle::bind(mUI);
 
         // Bind GFxValue to "Skyrim/GFxValue"
         auto& mGFxValue = vm.module("Skyrim/GFxValue");
@@ -52,6 +62,7 @@ namespace wren::binding_manager {
         // Bind Game to "Skyrim/Game"
         auto& mGame = vm.module("Skyrim/Game");
         wrappers::game::bind(mGame);
+        wrappers::actor_array::bind(mGame);
 
         // Bind Setting to "Skyrim/Setting"
         auto& mSetting = vm.module("Skyrim/Setting");
@@ -60,6 +71,26 @@ namespace wren::binding_manager {
         // Bind Effect to "Skyrim/Effect"
         auto& mEffect = vm.module("Skyrim/Effect");
         wrappers::effect::bind(mEffect);
+
+        // Bind Form to "Skyrim/Form"
+        auto& mForm = vm.module("Skyrim/Form");
+        wrappers::form::bind(mForm);
+
+        // Bind Commands to "Skyrim/Commands"
+        auto& mCommands = vm.module("Skyrim/Commands");
+        wrappers::commands::bind(mCommands);
+
+        // Bind Storage to "Storage"
+        auto& mStorage = vm.module("Storage");
+        wrappers::storage::bind(mStorage);
+
+        // Bind Trace to "Trace"
+        auto& mTrace = vm.module("Trace");
+        wrappers::trace::bind(mTrace);
+
+        // Bind Worker to "Worker"
+        auto& mWorker = vm.module("Worker");
+        wrappers::worker::bind(mWorker);
     }
 
     export void load_core_modules(wrenbind17::VM& vm) {
@@ -83,6 +114,17 @@ namespace wren::binding_manager {
         vm.runFromModule("Skyrim/Game");
         vm.runFromModule("Skyrim/Setting");
         vm.runFromModule("Skyrim/Effect");
+        vm.runFromModule("Skyrim/Form");
+        vm.runFromModule("Skyrim/Commands");
+
+        // Persistent script state (SKSE co-save)
+        vm.runFromModule("Storage");
+
+        // Script zones for frame traces
+        vm.runFromModule("Trace");
+
+        // Compute VMs on the worker thread pool
+        vm.runFromModule("Worker");
     }
 
 }
@@ -0,0 +1,351 @@
+#pragma once
+
+#include "pch.h"
+
+#include <charconv>
+#include <deque>
+#include <mutex>
+
+// Консоль Wren: выражения и инструкции выполняются в постоянном модуле "console",
+// объявленные там переменные живут до перезагрузки VM.
+// Ввод копится в очереди (submit, из любого потока), выполняет его process() на потоке VM.
+namespace wren::console
+{
+  struct entry
+  {
+    std::string input{};
+    // Значение (repr), текст ошибки или сводка :bench
+    std::string output{};
+    // Класс значения
+    std::string type{};
+    bool error{false};
+    double compile_us{0.0};
+    double run_us{0.0};
+  };
+
+  struct bench_stats
+  {
+    std::uint32_t iterations{0};
+    double mean_us{0.0};
+    double p50_us{0.0};
+    double p99_us{0.0};
+    double min_us{0.0};
+  };
+
+  /**
+   * @brief Среднее и перцентили по замерам одного вызова, в микросекундах.
+   */
+  inline bench_stats summarize(std::vector<double> samples_us)
+  {
+    bench_stats out;
+    if (samples_us.empty()) return out;
+    std::ranges::sort(samples_us);
+    const auto at = [&](const double p) {
+      return samples_us[std::min(samples_us.size() - 1, static_cast<std::size_t>(p * static_cast<double>(samples_us.size())))];
+    };
+    double total = 0.0;
+    for (const auto us : samples_us) total += us;
+    out.iterations = static_cast<std::uint32_t>(samples_us.size());
+    out.mean_us = total / static_cast<double>(samples_us.size());
+    out.p50_us = at(0.5);
+    out.p99_us = at(0.99);
+    out.min_us = samples_us.front();
+    return out;
+  }
+
+  /**
+   * @brief Сессия консоли для одной VM. reset() обязателен до уничтожения VM.
+   *
+   * Строка сначала компилируется как выражение (значение показывается), если не вышло —
+   * как инструкции (var x = ..., import ...). Команды:
+   *   :bench N expr — вызывает скомпилированное выражение N раз, среднее и p99 на вызов;
+   *   :clear — очищает историю.
+   */
+  class session
+  {
+  public:
+    static constexpr const char* module_name = "console";
+    static constexpr std::size_t max_history = 200;
+    static constexpr std::uint32_t max_bench_iterations = 1'000'000;
+    static constexpr std::size_t max_repr = 2048;
+    // Вложенность списков и словарей при выводе значения, как у конвертеров GFx и Storage
+    static constexpr std::size_t max_depth = 32;
+
+    session() = default;
+    ~session() { reset(); }
+    session(const session&) = delete;
+    session& operator=(const session&) = delete;
+
+    void attach(wrenbind17::VM& vm)
+    {
+      reset();
+      vm_ = vm.getVm();
+      call_handle_ = wrenMakeCallHandle(vm_, "call()");
+      call1_handle_ = wrenMakeCallHandle(vm_, "call(_)");
+      // Класс и текст значения одним вызовом; строки в кавычках, чтобы отличать "1" от 1.
+      // Списки и словари обходятся здесь, а не через toString: цикл (l.add(l)) выводится как [...],
+      // глубина и длина текста ограничены, так что огромное или бесконечное значение не вешает игру
+      const auto inspector = R"W(Fn.new {|v|
+  var left = )W" + std::to_string(max_repr) + R"W(
+  var repr = null
+  repr = Fn.new {|v, path|
+    if (left <= 0) return "..."
+    if (!(v is List || v is Map)) {
+      var text = v.toString
+      left = left - text.count
+      return text
+    }
+    if (path.count >= )W" + std::to_string(max_depth) + R"W( || path.any {|p| Object.same(p, v) }) {
+      left = left - 5
+      return v is List ? "[...]" : "{...}"
+    }
+    path.add(v)
+    var parts = []
+    for (e in v) {
+      if (left <= 0) {
+        parts.add("...")
+        break
+      }
+      parts.add(v is List ? repr.call(e, path) : "%(repr.call(e.key, path)): %(repr.call(e.value, path))")
+      left = left - 2
+    }
+    path.removeAt(-1)
+    return v is List ? "[%(parts.join(", "))]" : "{%(parts.join(", "))}"
+  }
+  return [v.type.name, v is String ? "\"%(v)\"" : repr.call(v, [])]
+})W";
+      inspect_ = wrenCompileInModule(vm_, module_name, inspector.c_str(), true, true);
+      if (inspect_) inspect_ = run_for_value(inspect_);
+      if (!inspect_) logger::error("Console: can't create inspector: {}", wrenbind17::getLastError(vm_));
+    }
+
+    void reset()
+    {
+      if (vm_) {
+        for (const auto handle : {call_handle_, call1_handle_, inspect_}) {
+          if (handle) wrenReleaseHandle(vm_, handle);
+        }
+      }
+      call_handle_ = nullptr;
+      call1_handle_ = nullptr;
+      inspect_ = nullptr;
+      vm_ = nullptr;
+    }
+
+    [[nodiscard]] bool attached() const { return vm_ != nullptr; }
+
+    /**
+     * @brief Ставит строку в очередь на выполнение. Можно звать из любого потока.
+     */
+    void submit(std::string line)
+    {
+      std::scoped_lock lock(lock_);
+      pending_.push_back(std::move(line));
+    }
+
+    [[nodiscard]] std::size_t pending() const
+    {
+      std::scoped_lock lock(lock_);
+      return pending_.size();
+    }
+
+    /**
+     * @brief Копия истории для отрисовки.
+     */
+    [[nodiscard]] std::vector<entry> history() const
+    {
+      std::scoped_lock lock(lock_);
+      return {history_.begin(), history_.end()};
+    }
+
+    /**
+     * @brief Выполняет накопленные строки. Только поток VM.
+     */
+    void process()
+    {
+      std::vector<std::string> lines;
+      {
+        std::scoped_lock lock(lock_);
+        if (pending_.empty()) return;
+        lines.assign(std::make_move_iterator(pending_.begin()), std::make_move_iterator(pending_.end()));
+        pending_.clear();
+      }
+      for (const auto& line : lines) {
+        if (line == ":clear") {
+          std::scoped_lock lock(lock_);
+          history_.clear();
+          continue;
+        }
+        auto result = execute(line);
+        std::scoped_lock lock(lock_);
+        history_.push_back(std::move(result));
+        while (history_.size() > max_history) history_.pop_front();
+      }
+    }
+
+    /**
+     * @brief Выполняет строку сразу. Только поток VM.
+     */
+    entry execute(const std::string& line)
+    {
+      entry out{.input = line};
+      if (!vm_) {
+        out.error = true;
+        out.output = "VM is not running";
+        return out;
+      }
+
+      if (line.starts_with(":bench")) {
+        bench(line.substr(6), out);
+        return out;
+      }
+      if (line.starts_with(":")) {
+        out.error = true;
+        out.output = "Unknown command. Commands: :bench N expr, :clear";
+        return out;
+      }
+
+      const auto compile_start = std::chrono::steady_clock::now();
+      WrenHandle* fn = wrenCompileInModule(vm_, module_name, line.c_str(), true, false);
+      const bool is_expression = fn != nullptr;
+      if (!fn) fn = wrenCompileInModule(vm_, module_name, line.c_str(), false, true);
+      out.compile_us = elapsed_us(compile_start);
+      if (!fn) {
+        out.error = true;
+        out.output = trim(wrenbind17::getLastError(vm_));
+        return out;
+      }
+
+      wrenEnsureSlots(vm_, 1);
+      wrenSetSlotHandle(vm_, 0, fn);
+      wrenReleaseHandle(vm_, fn);
+      const auto run_start = std::chrono::steady_clock::now();
+      const auto result = wrenCall(vm_, call_handle_);
+      out.run_us = elapsed_us(run_start);
+      if (result != WREN_RESULT_SUCCESS) {
+        out.error = true;
+        out.output = trim(wrenbind17::getLastError(vm_));
+        return out;
+      }
+
+      if (is_expression) inspect(out);
+      return out;
+    }
+
+  private:
+    static double elapsed_us(const std::chrono::steady_clock::time_point start)
+    {
+      return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static std::string trim(std::string s)
+    {
+      while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.pop_back();
+      return s;
+    }
+
+    /**
+     * @brief Вызывает fn и возвращает хэндл результата; fn освобождается.
+     */
+    WrenHandle* run_for_value(WrenHandle* fn)
+    {
+      wrenEnsureSlots(vm_, 1);
+      wrenSetSlotHandle(vm_, 0, fn);
+      wrenReleaseHandle(vm_, fn);
+      if (wrenCall(vm_, call_handle_) != WREN_RESULT_SUCCESS) return nullptr;
+      return wrenGetSlotHandle(vm_, 0);
+    }
+
+    /**
+     * @brief Класс и текст значения из слота 0.
+     */
+    void inspect(entry& out)
+    {
+      if (!inspect_) return;
+      WrenHandle* value = wrenGetSlotHandle(vm_, 0);
+      wrenEnsureSlots(vm_, 3);
+      wrenSetSlotHandle(vm_, 0, inspect_);
+      wrenSetSlotHandle(vm_, 1, value);
+      wrenReleaseHandle(vm_, value);
+      if (wrenCall(vm_, call1_handle_) != WREN_RESULT_SUCCESS) {
+        out.error = true;
+        out.output = trim(wrenbind17::getLastError(vm_));
+        return;
+      }
+
+      wrenEnsureSlots(vm_, 3);
+      for (int i = 0; i < 2; ++i) {
+        wrenGetListElement(vm_, 0, i, 1 + i);
+        if (wrenGetSlotType(vm_, 1 + i) != WREN_TYPE_STRING) continue;
+        int length = 0;
+        const char* text = wrenGetSlotBytes(vm_, 1 + i, &length);
+        (i == 0 ? out.type : out.output).assign(text, static_cast<std::size_t>(length));
+      }
+      if (out.output.size() > max_repr) {
+        out.output.resize(max_repr);
+        out.output += "...";
+      }
+    }
+
+    void bench(const std::string_view args, entry& out)
+    {
+      std::uint32_t iterations = 0;
+      std::string_view rest = args;
+      while (!rest.empty() && rest.front() == ' ') rest.remove_prefix(1);
+      const auto [ptr, ec] = std::from_chars(rest.data(), rest.data() + rest.size(), iterations);
+      const std::string expression(ptr, rest.data() + rest.size());
+      if (ec != std::errc() || !iterations || expression.find_first_not_of(' ') == std::string::npos) {
+        out.error = true;
+        out.output = "Usage: :bench N expr";
+        return;
+      }
+      iterations = std::min(iterations, max_bench_iterations);
+
+      const auto compile_start = std::chrono::steady_clock::now();
+      WrenHandle* fn = wrenCompileInModule(vm_, module_name, expression.c_str(), true, true);
+      out.compile_us = elapsed_us(compile_start);
+      if (!fn) {
+        out.error = true;
+        out.output = trim(wrenbind17::getLastError(vm_));
+        return;
+      }
+
+      // Скомпилировано один раз; каждый замер — один wrenCall, включая его накладные расходы
+      std::vector<double> samples;
+      samples.reserve(iterations);
+      const auto run_start = std::chrono::steady_clock::now();
+      for (std::uint32_t i = 0; i < iterations; ++i) {
+        wrenEnsureSlots(vm_, 1);
+        wrenSetSlotHandle(vm_, 0, fn);
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = wrenCall(vm_, call_handle_);
+        samples.push_back(elapsed_us(start));
+        if (result != WREN_RESULT_SUCCESS) {
+          wrenReleaseHandle(vm_, fn);
+          out.error = true;
+          out.output = "Iteration " + std::to_string(i + 1) + ": " + trim(wrenbind17::getLastError(vm_));
+          return;
+        }
+      }
+      out.run_us = elapsed_us(run_start);
+      wrenReleaseHandle(vm_, fn);
+      inspect(out);
+
+      const auto stats = summarize(std::move(samples));
+      char summary[160];
+      std::snprintf(summary, sizeof(summary), "%u runs: mean %.3f us, p50 %.3f us, p99 %.3f us, min %.3f us -> ",
+                    stats.iterations, stats.mean_us, stats.p50_us, stats.p99_us, stats.min_us);
+      out.output = summary + out.output;
+    }
+
+    WrenVM* vm_{nullptr};
+    WrenHandle* call_handle_{nullptr};
+    WrenHandle* call1_handle_{nullptr};
+    // Fn, возвращающая [класс, текст] значения
+    WrenHandle* inspect_{nullptr};
+
+    mutable std::mutex lock_;
+    std::vector<std::string> pending_;
+    std::deque<entry> history_;
+  };
+}
@@ -0,0 +1,545 @@
+#pragma once
+
+#include "pch.h"
+#include "Wren/Wrappers/ActiveEffect.hpp"
+#include "Wren/Wrappers/Actor.hpp"
+#include "Wren/Wrappers/AlchemyItem.hpp"
+#include "Wren/Wrappers/HitData.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace wren::event_record
+{
+  /**
+   * @brief Формат файла записи событий (*.wrev), little-endian.
+   *
+   * Заголовок: magic 'WREV', u32 версия. Дальше записи:
+   *   u8 kind_name,  u16 id, u16 длина, байты имени — имя события, идет перед первым его вызовом;
+   *   u8 kind_event, u32 кадр, u16 id, u8 число аргументов, аргументы.
+   * Аргумент — u8 тег и снимок значения на момент вызова (см. write_arg).
+   */
+  // Байты "WREV" в little-endian
+  inline constexpr std::uint32_t magic = 0x56455257;
+  inline constexpr std::uint32_t version = 1;
+
+  enum class record_kind : std::uint8_t
+  {
+    kName = 1,
+    kEvent = 2,
+  };
+
+  enum class arg_tag : std::uint8_t
+  {
+    kNull = 0,
+    kNumber,
+    kBool,
+    kString,
+    kActor,
+    kAlchemyItem,
+    kActiveEffect,
+    kHitData,
+  };
+
+  // Снимки аргументов. При воспроизведении по ним строятся объекты, которые возвращают записанные значения
+
+  struct actor_snapshot
+  {
+    std::uint32_t form_id{0};
+    std::uint32_t handle{0};
+    bool is_player{false};
+    bool dead{false};
+    bool in_combat{false};
+    float position[3]{};
+    float heading{0.f};
+    // Health, Magicka, Stamina
+    float values[3]{};
+    std::string name;
+  };
+
+  struct alchemy_item_snapshot
+  {
+    std::uint32_t form_id{0};
+    bool poison{false};
+    bool food{false};
+    std::string name;
+  };
+
+  struct active_effect_snapshot
+  {
+    std::uint32_t base_effect{0};
+    float magnitude{0.f};
+    float duration{0.f};
+    float elapsed{0.f};
+    actor_snapshot caster;
+    actor_snapshot target;
+  };
+
+  struct hit_data_snapshot
+  {
+    actor_snapshot aggressor;
+    actor_snapshot target;
+    float total_damage{0.f};
+    float physical_damage{0.f};
+    std::uint32_t weapon{0};
+  };
+
+  using arg_value = std::variant<std::monostate, double, bool, std::string, actor_snapshot, alchemy_item_snapshot,
+                                 active_effect_snapshot, hit_data_snapshot>;
+
+  class byte_writer
+  {
+  public:
+    template<typename T>
+    void put(const T value)
+    {
+      static_assert(std::is_trivially_copyable_v<T>);
+      const auto bytes = reinterpret_cast<const char*>(&value);
+      data_.insert(data_.end(), bytes, bytes + sizeof(T));
+    }
+
+    void put_string(const std::string_view text)
+    {
+      const auto length = static_cast<std::uint16_t>(std::min<std::size_t>(text.size(), UINT16_MAX));
+      put(length);
+      data_.insert(data_.end(), text.data(), text.data() + length);
+    }
+
+    [[nodiscard]] const std::vector<char>& data() const { return data_; }
+    void clear() { data_.clear(); }
+
+  private:
+    std::vector<char> data_;
+  };
+
+  class byte_reader
+  {
+  public:
+    explicit byte_reader(const std::span<const char> data) : data_(data) {}
+
+    template<typename T>
+    bool get(T& out)
+    {
+      if (offset_ + sizeof(T) > data_.size()) return false;
+      std::memcpy(&out, data_.data() + offset_, sizeof(T));
+      offset_ += sizeof(T);
+      return true;
+    }
+
+    bool get_string(std::string& out)
+    {
+      std::uint16_t length = 0;
+      if (!get(length) || offset_ + length > data_.size()) return false;
+      out.assign(data_.data() + offset_, length);
+      offset_ += length;
+      return true;
+    }
+
+    [[nodiscard]] bool at_end() const { return offset_ >= data_.size(); }
+
+  private:
+    std::span<const char> data_;
+    std::size_t offset_{0};
+  };
+
+  // Запись снимков
+
+  inline void write_actor(byte_writer& out, RE::Actor* a)
+  {
+    actor_snapshot s;
+    if (a) {
+      s.form_id = a->GetFormID();
+      s.handle = a->GetHandle().native_handle();
+      s.is_player = a->IsPlayerRef();
+      s.dead = a->IsDead();
+      s.in_combat = a->IsInCombat();
+      const auto pos = a->GetPosition();
+      s.position[0] = pos.x;
+      s.position[1] = pos.y;
+      s.position[2] = pos.z;
+      s.heading = a->GetAngleZ();
+      if (const auto owner = a->AsActorValueOwner()) {
+        s.values[0] = owner->GetActorValue(RE::ActorValue::kHealth);
+        s.values[1] = owner->GetActorValue(RE::ActorValue::kMagicka);
+        s.values[2] = owner->GetActorValue(RE::ActorValue::kStamina);
+      }
+      s.name = a->GetName();
+    }
+
+    out.put(s.form_id);
+    out.put(s.handle);
+    out.put(static_cast<std::uint8_t>(s.is_player | s.dead << 1 | s.in_combat << 2));
+    for (const auto v : s.position) out.put(v);
+    out.put(s.heading);
+    for (const auto v : s.values) out.put(v);
+    out.put_string(s.name);
+  }
+
+  /**
+   * @brief Пишет тег и снимок аргумента. Неизвестные типы пишутся как null.
+   */
+  template<typename T>
+  void write_arg(byte_writer& out, const T& value)
+  {
+    using type = std::remove_cvref_t<T>;
+    if constexpr (std::is_same_v<type, bool>) {
+      out.put(arg_tag::kBool);
+      out.put(static_cast<std::uint8_t>(value));
+    }
+    else if constexpr (std::is_arithmetic_v<type>) {
+      out.put(arg_tag::kNumber);
+      out.put(static_cast<double>(value));
+    }
+    else if constexpr (std::is_convertible_v<const type&, std::string_view>) {
+      out.put(arg_tag::kString);
+      out.put_string(std::string_view(value));
+    }
+    else if constexpr (std::is_same_v<type, wrappers::actor>) {
+      out.put(arg_tag::kActor);
+      write_actor(out, value.get());
+    }
+    else if constexpr (std::is_same_v<type, wrappers::alchemy_item>) {
+      out.put(arg_tag::kAlchemyItem);
+      const auto item = value.get();
+      out.put(item ? item->GetFormID() : 0u);
+      const bool poison = item && item->IsPoison();
+      const bool food = item && item->IsFood();
+      out.put(static_cast<std::uint8_t>(poison | food << 1));
+      out.put_string(item ? item->GetName() : "");
+    }
+    else if constexpr (std::is_same_v<type, wrappers::active_effect>) {
+      out.put(arg_tag::kActiveEffect);
+      const auto effect = value.get();
+      const auto base = effect && effect->effect ? effect->effect->baseEffect : nullptr;
+      out.put(base ? base->GetFormID() : 0u);
+      out.put(value.get_magnitude());
+      out.put(value.get_duration());
+      out.put(value.get_elapsed());
+      write_actor(out, value.get_caster().get());
+      write_actor(out, value.get_target().get());
+    }
+    else if constexpr (std::is_same_v<type, wrappers::hit_data>) {
+      out.put(arg_tag::kHitData);
+      const auto hit = value.get();
+      write_actor(out, value.get_attacker().get());
+      write_actor(out, value.get_target().get());
+      out.put(hit ? hit->totalDamage : 0.f);
+      out.put(hit ? hit->physicalDamage : 0.f);
+      out.put(hit && hit->weapon ? hit->weapon->GetFormID() : 0u);
+    }
+    else {
+      out.put(arg_tag::kNull);
+    }
+  }
+
+  // Чтение снимков
+
+  inline bool read_actor(byte_reader& in, actor_snapshot& s)
+  {
+    std::uint8_t flags = 0;
+    if (!in.get(s.form_id) || !in.get(s.handle) || !in.get(flags)) return false;
+    s.is_player = flags & 1;
+    s.dead = flags & 2;
+    s.in_combat = flags & 4;
+    for (auto& v : s.position) {
+      if (!in.get(v)) return false;
+    }
+    if (!in.get(s.heading)) return false;
+    for (auto& v : s.values) {
+      if (!in.get(v)) return false;
+    }
+    return in.get_string(s.name);
+  }
+
+  inline bool read_arg(byte_reader& in, arg_value& out)
+  {
+    arg_tag tag{};
+    if (!in.get(tag)) return false;
+
+    switch (tag) {
+    case arg_tag::kNull:
+      out = std::monostate{};
+      return true;
+    case arg_tag::kNumber: {
+      double v = 0.0;
+      if (!in.get(v)) return false;
+      out = v;
+      return true;
+    }
+    case arg_tag::kBool: {
+      std::uint8_t v = 0;
+      if (!in.get(v)) return false;
+      out = v != 0;
+      return true;
+    }
+    case arg_tag::kString: {
+      std::string v;
+      if (!in.get_string(v)) return false;
+      out = std::move(v);
+      return true;
+    }
+    case arg_tag::kActor: {
+      actor_snapshot v;
+      if (!read_actor(in, v)) return false;
+      out = std::move(v);
+      return true;
+    }
+    case arg_tag::kAlchemyItem: {
+      alchemy_item_snapshot v;
+      std::uint8_t flags = 0;
+      if (!in.get(v.form_id) || !in.get(flags) || !in.get_string(v.name)) return false;
+      v.poison = flags & 1;
+      v.food = flags & 2;
+      out = std::move(v);
+      return true;
+    }
+    case arg_tag::kActiveEffect: {
+      active_effect_snapshot v;
+      if (!in.get(v.base_effect) || !in.get(v.magnitude) || !in.get(v.duration) || !in.get(v.elapsed) ||
+          !read_actor(in, v.caster) || !read_actor(in, v.target)) {
+        return false;
+      }
+      out = std::move(v);
+      return true;
+    }
+    case arg_tag::kHitData: {
+      hit_data_snapshot v;
+      if (!read_actor(in, v.aggressor) || !read_actor(in, v.target) || !in.get(v.total_damage) ||
+          !in.get(v.physical_damage) || !in.get(v.weapon)) {
+        return false;
+      }
+      out = std::move(v);
+      return true;
+    }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Кольцевой буфер байтов без блокировок: один писатель (главный поток), один читатель (поток записи).
+   * Запись либо помещается целиком, либо отклоняется — главный поток никогда не ждет.
+   */
+  class spsc_byte_ring
+  {
+  public:
+    explicit spsc_byte_ring(const std::size_t capacity) : buffer_(std::bit_ceil(capacity)), mask_(buffer_.size() - 1)
+    {
+    }
+
+    bool try_write(const char* data, const std::size_t size)
+    {
+      const auto head = head_.load(std::memory_order_relaxed);
+      const auto tail = tail_.load(std::memory_order_acquire);
+      if (buffer_.size() - (head - tail) < size) return false;
+
+      const auto offset = head & mask_;
+      const auto first = std::min(size, buffer_.size() - offset);
+      std::memcpy(buffer_.data() + offset, data, first);
+      std::memcpy(buffer_.data(), data + first, size - first);
+      head_.store(head + size, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief Забирает все накопленные байты (не больше двух непрерывных кусков) в out.
+     */
+    std::size_t drain(std::vector<char>& out)
+    {
+      const auto tail = tail_.load(std::memory_order_relaxed);
+      const auto head = head_.load(std::memory_order_acquire);
+      const auto size = head - tail;
+      if (!size) return 0;
+
+      const auto offset = tail & mask_;
+      const auto first = std::min(size, buffer_.size() - offset);
+      out.insert(out.end(), buffer_.data() + offset, buffer_.data() + offset + first);
+      out.insert(out.end(), buffer_.data(), buffer_.data() + (size - first));
+      tail_.store(tail + size, std::memory_order_release);
+      return size;
+    }
+
+  private:
+    std::vector<char> buffer_;
+    std::size_t mask_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+  };
+
+  /**
+   * @brief Запись вызовов Events.dispatch в файл (включается явно).
+   * record() вызывается из главного потока: кодирует событие и кладет его в кольцевой буфер,
+   * отдельный поток сбрасывает буфер на диск. Если буфер полон, событие отбрасывается и учитывается в dropped().
+   */
+  class recorder
+  {
+  public:
+    static recorder* get_singleton()
+    {
+      static recorder singleton;
+      return &singleton;
+    }
+
+    bool start(const std::filesystem::path& path, const std::size_t buffer_bytes = 4 * 1024 * 1024)
+    {
+      if (recording()) return false;
+
+      std::ofstream file(path, std::ios::binary | std::ios::trunc);
+      if (!file) {
+        logger::error("Event recorder: can't open {}", path.string());
+        return false;
+      }
+      file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+      file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+
+      ring_ = std::make_unique<spsc_byte_ring>(buffer_bytes);
+      names_.clear();
+      frame_ = 0;
+      recorded_ = 0;
+      dropped_ = 0;
+      recording_.store(true, std::memory_order_release);
+      writer_ = std::jthread([this, file = std::move(file)](const std::stop_token& stop) mutable {
+        write_loop(stop, file);
+      });
+
+      logger::info("Event recorder: recording to {}", path.string());
+      return true;
+    }
+
+    void stop()
+    {
+      if (!recording()) return;
+      recording_.store(false, std::memory_order_release);
+      writer_.request_stop();
+      writer_.join();
+      ring_.reset();
+      logger::info("Event recorder: stopped, {} events recorded, {} dropped", recorded(), dropped());
+    }
+
+    [[nodiscard]] bool recording() const { return recording_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t recorded() const { return recorded_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    void on_frame_start() { ++frame_; }
+
+    template<typename... Args>
+    void record(const std::string& event_name, const Args&... args)
+    {
+      static_assert(sizeof...(Args) <= UINT8_MAX);
+      if (!recording()) return;
+
+      scratch_.clear();
+      auto it = names_.find(event_name);
+      const bool is_new = it == names_.end();
+      if (is_new) {
+        it = names_.emplace(event_name, static_cast<std::uint16_t>(names_.size())).first;
+        scratch_.put(record_kind::kName);
+        scratch_.put(it->second);
+        scratch_.put_string(event_name);
+      }
+
+      scratch_.put(record_kind::kEvent);
+      scratch_.put(frame_);
+      scratch_.put(it->second);
+      scratch_.put(static_cast<std::uint8_t>(sizeof...(Args)));
+      (write_arg(scratch_, args), ...);
+
+      const auto& bytes = scratch_.data();
+      if (ring_->try_write(bytes.data(), bytes.size())) {
+        recorded_.fetch_add(1, std::memory_order_relaxed);
+      }
+      else {
+        // Имя не попало в файл — объявим его заново со следующим событием
+        if (is_new) names_.erase(it);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+  private:
+    recorder() = default;
+    // jthread сам останавливает и дожидается потока записи, остаток буфера попадает в файл
+    ~recorder() = default;
+    recorder(const recorder&) = delete;
+    recorder(recorder&&) = delete;
+    recorder& operator=(const recorder&) = delete;
+    recorder& operator=(recorder&&) = delete;
+
+    void write_loop(const std::stop_token& stop, std::ofstream& file)
+    {
+      std::vector<char> chunk;
+      while (!stop.stop_requested()) {
+        chunk.clear();
+        if (ring_->drain(chunk)) {
+          file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        }
+        else {
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+      }
+      chunk.clear();
+      ring_->drain(chunk);
+      file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    }
+
+    std::atomic<bool> recording_{false};
+    std::unique_ptr<spsc_byte_ring> ring_;
+    std::jthread writer_;
+    std::unordered_map<std::string, std::uint16_t> names_;
+    byte_writer scratch_;
+    std::uint32_t frame_{0};
+    // Читаются из меню SKSE
+    std::atomic<std::uint64_t> recorded_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+  };
+
+  /**
+   * @brief Событие из файла записи.
+   */
+  struct event
+  {
+    std::uint32_t frame{0};
+    std::uint16_t id{0};
+    std::vector<arg_value> args;
+  };
+
+  /**
+   * @brief Читает файл записи целиком. Обрезанный хвост (запись прервана) отбрасывается.
+   */
+  inline bool read_file(const std::filesystem::path& path, std::vector<std::string>& names, std::vector<event>& events)
+  {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    byte_reader in(data);
+    std::uint32_t file_magic = 0;
+    std::uint32_t file_version = 0;
+    if (!in.get(file_magic) || !in.get(file_version) || file_magic != magic || file_version != version) return false;
+
+    while (!in.at_end()) {
+      record_kind kind{};
+      if (!in.get(kind)) break;
+
+      if (kind == record_kind::kName) {
+        std::uint16_t id = 0;
+        std::string name;
+        if (!in.get(id) || !in.get_string(name)) break;
+        if (id >= names.size()) names.resize(id + 1);
+        names[id] = std::move(name);
+        continue;
+      }
+      if (kind != record_kind::kEvent) break;
+
+      event e;
+      std::uint8_t count = 0;
+      if (!in.get(e.frame) || !in.get(e.id) || !in.get(count)) break;
+      e.args.resize(count);
+      bool ok = true;
+      for (auto& arg : e.args) {
+        if (!(ok = read_arg(in, arg))) break;
+      }
+      if (!ok) break;
+      events.push_back(std::move(e));
+    }
+    return true;
+  }
+}
@@ -0,0 +1,324 @@
+#pragma once
+
+#include "pch.h"
+
+#include <atomic>
+#include <ctime>
+#include <mutex>
+#include <optional>
+
+// Снимки кучи Wren: живые объекты по модулю, который их создал, корню, который их держит
+// (модуль, handles, файбер), и типу, плюс объем памяти, выделенный каждым модулем (wrenGetModuleAllocations).
+// Снимки пишутся в JSON по одной записи на строку, так что их можно сравнить и diff'ом,
+// и diff() ниже (меню SKSE, wrenrim-host --heap-diff).
+namespace wren::heap_snapshot
+{
+  struct stats
+  {
+    std::uint64_t count{0};
+    std::uint64_t bytes{0};
+  };
+
+  struct key
+  {
+    // Модуль, код которого создал объект
+    std::string module;
+    // Модуль или группа корней, через которую объект достижим первым
+    std::string owner;
+    std::string type;
+
+    auto operator<=>(const key&) const = default;
+  };
+
+  struct snapshot
+  {
+    std::map<key, stats> retained;
+    // Модуль -> выделено байт и число выделений с загрузки модуля
+    std::map<std::string, stats> allocated;
+
+    [[nodiscard]] stats total() const
+    {
+      stats out;
+      for (const auto& [k, s] : retained) {
+        out.count += s.count;
+        out.bytes += s.bytes;
+      }
+      return out;
+    }
+  };
+
+  struct diff_row
+  {
+    key k;
+    std::int64_t count{0};
+    std::int64_t bytes{0};
+  };
+
+  // Объекты и выделения вне кода модулей (компиляция, вызовы из C++)
+  inline constexpr std::string_view host_module = "<host>";
+
+  /**
+   * @brief Снимает кучу. Запускает сборку мусора; вызывать между вызовами в VM.
+   */
+  inline snapshot take(WrenVM* vm)
+  {
+    snapshot out;
+    wrenGetModuleAllocations(
+      vm,
+      [](void* user_data, const char* module, const std::size_t bytes, const std::size_t count) {
+        auto& s = static_cast<snapshot*>(user_data)->allocated[module ? module : std::string(host_module)];
+        s.bytes += bytes;
+        s.count += count;
+      },
+      &out);
+    wrenHeapSnapshot(
+      vm,
+      [](void* user_data, const char* owner, const char* module, const char* type, const std::size_t bytes) {
+        auto& s = static_cast<snapshot*>(user_data)->retained[{module ? module : std::string(host_module), owner, type}];
+        ++s.count;
+        s.bytes += bytes;
+      },
+      &out);
+    return out;
+  }
+
+  /**
+   * @brief Разница after - before по ключам (модуль, владелец, тип), самые большие изменения по байтам первыми.
+   */
+  inline std::vector<diff_row> diff(const snapshot& before, const snapshot& after)
+  {
+    std::map<key, diff_row> rows;
+    const auto add = [&](const snapshot& s, const std::int64_t sign) {
+      for (const auto& [k, st] : s.retained) {
+        auto& row = rows[k];
+        row.count += sign * static_cast<std::int64_t>(st.count);
+        row.bytes += sign * static_cast<std::int64_t>(st.bytes);
+      }
+    };
+    add(before, -1);
+    add(after, 1);
+
+    std::vector<diff_row> out;
+    for (auto& [k, row] : rows) {
+      if (!row.count && !row.bytes) continue;
+      row.k = k;
+      out.push_back(std::move(row));
+    }
+    std::ranges::sort(out, [](const diff_row& a, const diff_row& b) {
+      return std::abs(a.bytes) != std::abs(b.bytes) ? std::abs(a.bytes) > std::abs(b.bytes)
+                                                    : std::abs(a.count) > std::abs(b.count);
+    });
+    return out;
+  }
+
+  namespace detail
+  {
+    inline void write_string(std::ostream& out, const std::string_view s)
+    {
+      out << '"';
+      for (const char c : s) {
+        if (c == '"' || c == '\\') out << '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out << c;
+      }
+      out << '"';
+    }
+
+    /**
+     * @brief Значение поля "key": из строки, записанной write_json.
+     */
+    inline std::optional<std::string> field(const std::string_view line, const std::string_view key)
+    {
+      const auto pattern = "\"" + std::string(key) + "\":";
+      auto pos = line.find(pattern);
+      if (pos == std::string_view::npos) return std::nullopt;
+      pos += pattern.size();
+
+      std::string value;
+      if (pos < line.size() && line[pos] == '"') {
+        for (++pos; pos < line.size() && line[pos] != '"'; ++pos) {
+          if (line[pos] == '\\' && pos + 1 < line.size()) ++pos;
+          value += line[pos];
+        }
+        return value;
+      }
+      while (pos < line.size() && (std::isdigit(static_cast<unsigned char>(line[pos])) || line[pos] == '-')) {
+        value += line[pos++];
+      }
+      return value;
+    }
+
+    inline std::uint64_t to_u64(const std::optional<std::string>& s)
+    {
+      return s && !s->empty() ? std::stoull(*s) : 0;
+    }
+  }
+
+  inline bool write_json(const snapshot& s, const std::filesystem::path& path)
+  {
+    std::error_code ec;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+
+    const auto total = s.total();
+    out << "{\n\"version\":1,\n\"total\":{\"count\":" << total.count << ",\"bytes\":" << total.bytes << "},\n";
+
+    out << "\"allocated\":[";
+    bool first = true;
+    for (const auto& [module, st] : s.allocated) {
+      out << (first ? "\n" : ",\n") << "{\"name\":";
+      detail::write_string(out, module);
+      out << ",\"count\":" << st.count << ",\"bytes\":" << st.bytes << "}";
+      first = false;
+    }
+
+    out << "\n],\n\"retained\":[";
+    first = true;
+    for (const auto& [k, st] : s.retained) {
+      out << (first ? "\n" : ",\n") << "{\"module\":";
+      detail::write_string(out, k.module);
+      out << ",\"owner\":";
+      detail::write_string(out, k.owner);
+      out << ",\"type\":";
+      detail::write_string(out, k.type);
+      out << ",\"count\":" << st.count << ",\"bytes\":" << st.bytes << "}";
+      first = false;
+    }
+    out << "\n]\n}\n";
+    return static_cast<bool>(out);
+  }
+
+  /**
+   * @brief Читает файл, записанный write_json.
+   */
+  inline bool read_json(const std::filesystem::path& path, snapshot& s)
+  {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.starts_with("{\"name\":")) {
+        auto& st = s.allocated[detail::field(line, "name").value_or("")];
+        st.count = detail::to_u64(detail::field(line, "count"));
+        st.bytes = detail::to_u64(detail::field(line, "bytes"));
+      }
+      else if (line.starts_with("{\"module\":")) {
+        auto& st = s.retained[{detail::field(line, "module").value_or(""), detail::field(line, "owner").value_or(""),
+                               detail::field(line, "type").value_or("")}];
+        st.count = detail::to_u64(detail::field(line, "count"));
+        st.bytes = detail::to_u64(detail::field(line, "bytes"));
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Снимки по запросу из меню SKSE.
+   *
+   * request() только ставит запрос, снимок берется в on_frame_start(vm) на главном потоке.
+   * Предыдущий снимок хранится в памяти и переживает горячую перезагрузку: разница с ним пишется в лог.
+   */
+  class snapshotter
+  {
+  public:
+    static constexpr std::size_t logged_rows = 10;
+
+    static snapshotter* get_singleton()
+    {
+      static snapshotter singleton;
+      return &singleton;
+    }
+
+    void request(const std::filesystem::path& directory)
+    {
+      std::scoped_lock lock(lock_);
+      directory_ = directory;
+      requested_.store(true, std::memory_order_release);
+    }
+
+    [[nodiscard]] bool pending() const { return requested_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint32_t taken() const { return taken_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] std::string last_path() const
+    {
+      std::scoped_lock lock(lock_);
+      return last_path_;
+    }
+
+    void on_frame_start(WrenVM* vm)
+    {
+      if (!vm || !requested_.load(std::memory_order_acquire)) return;
+
+      std::filesystem::path path;
+      {
+        std::scoped_lock lock(lock_);
+        path = directory_ / file_name();
+      }
+      requested_.store(false, std::memory_order_release);
+
+      const auto start = std::chrono::steady_clock::now();
+      auto current = take(vm);
+      const auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+      const auto total = current.total();
+      if (!write_json(current, path)) {
+        logger::error("Heap snapshot: can't write {}", path.string());
+      }
+      else {
+        logger::info("Heap snapshot: {} objects, {} bytes written to {} in {:.1f} ms", total.count, total.bytes,
+                     path.string(), ms);
+      }
+
+      if (previous_) {
+        const auto rows = diff(*previous_, current);
+        const auto before = previous_->total();
+        logger::info("Heap snapshot: {:+} objects, {:+} bytes since previous snapshot",
+                     static_cast<std::int64_t>(total.count) - static_cast<std::int64_t>(before.count),
+                     static_cast<std::int64_t>(total.bytes) - static_cast<std::int64_t>(before.bytes));
+        for (std::size_t i = 0; i < std::min(rows.size(), logged_rows); ++i) {
+          const auto& row = rows[i];
+          logger::info("  {:+10} bytes {:+8} x {} from {} (held by {})", row.bytes, row.count, row.k.type, row.k.module,
+                       row.k.owner);
+        }
+      }
+
+      previous_ = std::move(current);
+      {
+        std::scoped_lock lock(lock_);
+        last_path_ = path.string();
+      }
+      taken_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+  private:
+    snapshotter() = default;
+    ~snapshotter() = default;
+    snapshotter(const snapshotter&) = delete;
+    snapshotter(snapshotter&&) = delete;
+    snapshotter& operator=(const snapshotter&) = delete;
+    snapshotter& operator=(snapshotter&&) = delete;
+
+    std::string file_name() const
+    {
+      const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+      std::tm tm{};
+#if defined(_MSC_VER)
+      localtime_s(&tm, &now);
+#else
+      localtime_r(&now, &tm);
+#endif
+      char stamp[32];
+      std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+      return "heap-" + std::string(stamp) + "-" + std::to_string(taken_.load(std::memory_order_relaxed)) + ".json";
+    }
+
+    mutable std::mutex lock_;
+    std::atomic<bool> requested_{false};
+    std::atomic<std::uint32_t> taken_{0};
+    std::filesystem::path directory_;
+    std::string last_path_;
+    // Только главный поток
+    std::optional<snapshot> previous_;
+  };
+}
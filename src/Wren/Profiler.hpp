@@ -0,0 +1,334 @@
+#pragma once
+
+#include "pch.h"
+#include "Wren/EventRecorder.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+// Сэмплирующий профайлер скриптов. Интерпретатор (wrenSetSampling) раз в sample_interval
+// вызовов методов и итераций циклов отдает управление в on_sample(), который снимает стек
+// текущего файбера. Стеки сворачиваются в отдельном потоке и пишутся в формате folded stacks
+// ("a;b;c count"), который понимают flamegraph.pl, speedscope и inferno.
+namespace wren::profiling
+{
+  /**
+   * @brief Профилирование на N секунд из меню SKSE.
+   *
+   * start() только ставит запрос, сэмплирование включается и выключается в on_frame_start(vm)
+   * на главном потоке (wrenSetSampling можно звать только из потока VM).
+   * Пока профилирование выключено, интерпретатор платит одной проверкой счетчика на вызов.
+   */
+  class profiler
+  {
+  public:
+    // Простое число, чтобы сэмплы не совпадали по фазе с телом цикла
+    static constexpr std::uint32_t sample_interval = 997;
+    static constexpr std::size_t max_depth = 128;
+
+    static profiler* get_singleton()
+    {
+      static profiler singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Запрашивает профилирование на duration. false — профилирование или запись файла уже идут.
+     */
+    bool start(const std::chrono::steady_clock::duration duration, const std::filesystem::path& path)
+    {
+      if (duration <= std::chrono::steady_clock::duration::zero() || busy()) return false;
+      std::scoped_lock lock(request_lock_);
+      path_ = path;
+      requested_duration_ = duration;
+      requested_.store(true, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief Граница кадра: включает запрошенное профилирование и выключает его по истечении времени.
+     */
+    void on_frame_start(WrenVM* vm)
+    {
+      if (profiling()) {
+        if (vm != vm_ || stop_requested_.load(std::memory_order_acquire) ||
+            std::chrono::steady_clock::now() >= deadline_) {
+          stop(vm);
+        }
+        return;
+      }
+
+      if (!vm || !requested_.load(std::memory_order_acquire) || writing_.load(std::memory_order_acquire)) return;
+
+      // Предыдущий файл уже записан
+      if (aggregator_.joinable()) aggregator_.join();
+
+      std::filesystem::path path;
+      {
+        std::scoped_lock lock(request_lock_);
+        path = path_;
+        deadline_ = std::chrono::steady_clock::now() + requested_duration_;
+      }
+      requested_.store(false, std::memory_order_release);
+      stop_requested_.store(false, std::memory_order_release);
+
+      ring_ = std::make_unique<event_record::spsc_byte_ring>(ring_capacity);
+      frame_ids_.clear();
+      samples_ = 0;
+      dropped_ = 0;
+      vm_ = vm;
+      profiling_.store(true, std::memory_order_release);
+      writing_.store(true, std::memory_order_release);
+      aggregator_ = std::jthread([this, path = std::move(path)](const std::stop_token& stop) {
+        aggregate_loop(stop, path);
+        writing_.store(false, std::memory_order_release);
+      });
+      wrenSetSampling(vm, sample_interval, &profiler::on_sample);
+      logger::info("Profiler: sampling every {} calls", sample_interval);
+    }
+
+    /**
+     * @brief Выключает сэмплирование и отдает сэмплы на запись. Вызывать до уничтожения VM.
+     */
+    void stop(WrenVM* vm)
+    {
+      if (!profiling()) return;
+      // VM могла быть пересоздана: у старой сэмплирование уже не выключить, она уничтожена
+      if (vm && vm == vm_) wrenSetSampling(vm, 0, nullptr);
+      vm_ = nullptr;
+      profiling_.store(false, std::memory_order_release);
+      aggregator_.request_stop();
+    }
+
+    /**
+     * @brief Досрочное завершение из другого потока (меню): сэмплирование выключится в начале кадра.
+     */
+    void request_stop() { stop_requested_.store(true, std::memory_order_release); }
+
+    /**
+     * @brief Дожидается записи файла.
+     */
+    void wait()
+    {
+      if (aggregator_.joinable()) aggregator_.join();
+    }
+
+    [[nodiscard]] bool profiling() const { return profiling_.load(std::memory_order_relaxed); }
+    [[nodiscard]] bool writing() const { return writing_.load(std::memory_order_relaxed) && !profiling(); }
+    [[nodiscard]] bool busy() const
+    {
+      return requested_.load(std::memory_order_relaxed) || writing_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::uint64_t samples() const { return samples_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Секунд до конца профилирования.
+     */
+    [[nodiscard]] double seconds_left() const
+    {
+      if (!profiling()) return 0.0;
+      return std::max(0.0, std::chrono::duration<double>(deadline_ - std::chrono::steady_clock::now()).count());
+    }
+
+    /**
+     * @brief Для wrenSetSampling: снимает стек текущего файбера.
+     */
+    static void on_sample(WrenVM* vm) { get_singleton()->sample(vm); }
+
+  private:
+    static constexpr std::size_t ring_capacity = 4 * 1024 * 1024;
+
+    enum class record_kind : std::uint8_t
+    {
+      kName,
+      kSample,
+    };
+
+    struct frame_key
+    {
+      const char* module;
+      const char* function;
+      int line;
+
+      bool operator==(const frame_key&) const = default;
+    };
+
+    struct frame_key_hash
+    {
+      std::size_t operator()(const frame_key& k) const
+      {
+        auto h = std::hash<const void*>{}(k.module);
+        h = h * 31 + std::hash<const void*>{}(k.function);
+        return h * 31 + std::hash<int>{}(k.line);
+      }
+    };
+
+    profiler() = default;
+    // jthread сам останавливает поток свертки, файл дописывается
+    ~profiler() = default;
+    profiler(const profiler&) = delete;
+    profiler(profiler&&) = delete;
+    profiler& operator=(const profiler&) = delete;
+    profiler& operator=(profiler&&) = delete;
+
+    template<typename T>
+    void put(const T& value)
+    {
+      const auto offset = scratch_.size();
+      scratch_.resize(offset + sizeof(T));
+      std::memcpy(scratch_.data() + offset, &value, sizeof(T));
+    }
+
+    /**
+     * @brief Номер кадра стека. Строки имен принадлежат VM и живут, пока жива она, поэтому ключ — указатели;
+     * таблица сбрасывается с каждым запуском. Новое имя уходит в буфер перед сэмплом, который на него ссылается.
+     */
+    std::uint32_t frame_id(const frame_key& key)
+    {
+      if (const auto it = frame_ids_.find(key); it != frame_ids_.end()) return it->second;
+
+      const auto id = static_cast<std::uint32_t>(frame_ids_.size());
+      const auto name = std::string(key.function ? key.function : "?") + " (" + key.module + ":" +
+                        std::to_string(key.line) + ")";
+      scratch_.clear();
+      put(record_kind::kName);
+      put(id);
+      put(static_cast<std::uint16_t>(std::min<std::size_t>(name.size(), UINT16_MAX)));
+      scratch_.insert(scratch_.end(), name.begin(), name.begin() + std::min<std::size_t>(name.size(), UINT16_MAX));
+      if (!ring_->try_write(scratch_.data(), scratch_.size())) return UINT32_MAX;
+
+      frame_ids_.emplace(key, id);
+      return id;
+    }
+
+    void sample(WrenVM* vm)
+    {
+      const auto count = std::min<int>(wrenGetStackFrameCount(vm), max_depth);
+
+      // Кадры от внешнего к внутреннему — в этом порядке их ждет folded stacks
+      std::array<std::uint32_t, max_depth> ids;
+      std::uint16_t depth = 0;
+      for (int i = count - 1; i >= 0; --i) {
+        frame_key key{};
+        if (!wrenGetStackFrame(vm, i, &key.module, &key.function, &key.line)) continue;
+        const auto id = frame_id(key);
+        if (id == UINT32_MAX) {
+          dropped_.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        ids[depth++] = id;
+      }
+      if (!depth) return;
+
+      scratch_.clear();
+      put(record_kind::kSample);
+      put(depth);
+      const auto offset = scratch_.size();
+      scratch_.resize(offset + depth * sizeof(std::uint32_t));
+      std::memcpy(scratch_.data() + offset, ids.data(), depth * sizeof(std::uint32_t));
+
+      if (ring_->try_write(scratch_.data(), scratch_.size())) samples_.fetch_add(1, std::memory_order_relaxed);
+      else dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Разбирает записи из буфера. Записи кладутся целиком, поэтому кусок всегда кончается на границе записи.
+     */
+    static void parse(const std::vector<char>& chunk, std::vector<std::string>& names,
+                      std::unordered_map<std::string, std::uint64_t>& stacks)
+    {
+      std::size_t pos = 0;
+      const auto read = [&](auto& value) {
+        std::memcpy(&value, chunk.data() + pos, sizeof(value));
+        pos += sizeof(value);
+      };
+
+      while (pos < chunk.size()) {
+        record_kind kind{};
+        read(kind);
+        if (kind == record_kind::kName) {
+          std::uint32_t id = 0;
+          std::uint16_t size = 0;
+          read(id);
+          read(size);
+          if (id >= names.size()) names.resize(id + 1);
+          names[id].assign(chunk.data() + pos, size);
+          pos += size;
+        }
+        else {
+          std::uint16_t depth = 0;
+          read(depth);
+          // Ключ — сырые номера кадров, в имена переводятся только при записи
+          ++stacks[std::string(chunk.data() + pos, depth * sizeof(std::uint32_t))];
+          pos += depth * sizeof(std::uint32_t);
+        }
+      }
+    }
+
+    void aggregate_loop(const std::stop_token& stop, const std::filesystem::path& path)
+    {
+      std::vector<std::string> names;
+      std::unordered_map<std::string, std::uint64_t> stacks;
+      std::vector<char> chunk;
+
+      while (!stop.stop_requested()) {
+        chunk.clear();
+        if (ring_->drain(chunk)) parse(chunk, names, stacks);
+        else std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      chunk.clear();
+      ring_->drain(chunk);
+      parse(chunk, names, stacks);
+
+      write_folded(path, names, stacks);
+    }
+
+    void write_folded(const std::filesystem::path& path, const std::vector<std::string>& names,
+                      const std::unordered_map<std::string, std::uint64_t>& stacks) const
+    {
+      std::map<std::string, std::uint64_t> folded;
+      for (const auto& [key, count] : stacks) {
+        std::string line;
+        for (std::size_t offset = 0; offset < key.size(); offset += sizeof(std::uint32_t)) {
+          std::uint32_t id = 0;
+          std::memcpy(&id, key.data() + offset, sizeof(id));
+          if (offset) line += ';';
+          line += id < names.size() ? names[id] : "?";
+        }
+        folded[std::move(line)] += count;
+      }
+
+      std::ofstream out(path, std::ios::trunc);
+      if (!out) {
+        logger::error("Profiler: can't open {}", path.string());
+        return;
+      }
+      for (const auto& [stack, count] : folded) out << stack << ' ' << count << '\n';
+
+      logger::info("Profiler: {} samples in {} stacks written to {} ({} dropped)", samples(), folded.size(),
+                   path.string(), dropped());
+    }
+
+    std::atomic<bool> profiling_{false};
+    std::atomic<bool> writing_{false};
+    std::atomic<bool> requested_{false};
+    std::atomic<bool> stop_requested_{false};
+    std::mutex request_lock_;
+    std::filesystem::path path_;
+    std::chrono::steady_clock::duration requested_duration_{};
+    std::chrono::steady_clock::time_point deadline_{};
+
+    // Только главный поток
+    WrenVM* vm_{nullptr};
+    std::unordered_map<frame_key, std::uint32_t, frame_key_hash> frame_ids_;
+    std::vector<char> scratch_;
+
+    std::unique_ptr<event_record::spsc_byte_ring> ring_;
+    std::jthread aggregator_;
+    // Читаются из меню SKSE
+    std::atomic<std::uint64_t> samples_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+  };
+}
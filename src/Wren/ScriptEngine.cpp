@@ -1,16 +1,24 @@
 module;
 
 #include "pch.h"
+#include "Wren/Wrappers/ActiveEffectIndex.hpp"
+#include "Wren/Wrappers/ActorGrid.hpp"
+#include "Wren/Wrappers/ActorHandleCache.hpp"
+#include "Wren/Wrappers/Commands.hpp"
+#include "Wren/Console.hpp"
+#include "Wren/EventRecorder.hpp"
+#include "Wren/HeapSnapshot.hpp"
+#include "Wren/Profiler.hpp"
+#include "Wren/Tracer.hpp"
+#include "Wren/Worker.hpp"
 
 export module WrenRim.Wren.ScriptEngine;
 
 import WrenRim.Config;
-import WrenRim.Wren.BindingManager;
+import WrenRim.Wren.ScriptRuntime;
 
 namespace wren::script_engine
 {
-  namespace fs = std::filesystem;
-
   export class engine
   {
   public:
@@ -31,82 +39,40 @@ namespace wren::script_engine
       }
 
       logger::info("Initializing Wren ScriptEngine...");
+      tracing::tracer::get_singleton()->name_current_thread("Main");
 
-      // Create new VM instance
-      vm_ = std::make_unique<wrenbind17::VM>(std::vector<std::string>{
-        "Data/SKSE/Plugins/WrenRim/Std",
-        "Data/SKSE/Plugins/WrenRim/WrenMods"
-      });
-
-      // 1. Настройка логгера (чтобы System.print писал в лог SKSE)
-      vm_->setPrintFunc([](const char* text) {
-        if (text[0] == '\n' && text[1] == '\0') return;
-        SKSE::log::info("[Wren] {}", text);
-      });
-
-      // Configure Module Resolution
-      vm_->setPathResolveFunc(
-        [](const std::vector<std::string>&, const std::string&, const std::string& name) -> std::string {
-          return name;
-        });
-
-      vm_->setLoadFileFunc([](const std::string& name) -> std::string {
-        const std::vector<std::string> search_paths = {
-          "Data/SKSE/Plugins/WrenRim/Std",
-          "Data/SKSE/Plugins/WrenRim/WrenMods"
-        };
-
-        for (const auto& base_path : search_paths) {
-          auto full_path = fs::path(base_path) / (name + ".wren");
-          if (fs::exists(full_path)) {
-            std::ifstream t(full_path);
-            return std::string((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
-          }
-        }
-
-        throw std::runtime_error("Module not found: " + name);
-      });
-
-      // Register Bindings (C++ -> Wren)
-      binding_manager::bind_wrappers(*vm_);
+      // Воркеры создаются скриптами, потоки пула запускаются при первом Worker.spawn
+      workers::pool::get_singleton()->configure(cfg->get_worker_threads(), std_path_,
+                                                std::filesystem::path(mods_path_) / "Workers");
 
+      // Create new VM instance
+      vm_ = script_runtime::create_vm({std_path_, mods_path_});
+      // До загрузки Std и модов, иначе их объекты в снимках кучи останутся без модуля
+      if (cfg->is_heap_attribution_enabled()) {
+        wrenSetModuleAttribution(vm_->getVm(), true);
+      }
 
       // 1. Pre-load Standard Library
-      try {
-        logger::info("Loading Standard Library...");
-
-        binding_manager::load_core_modules(*vm_);
-      }
-      catch (const std::exception& e) {
-        logger::error("Failed to load Standard Library: {}", e.what());
+      if (!script_runtime::load_std(*vm_)) {
         return; // Critical failure
       }
 
-      // 2. Load User Scripts from "Data/SKSE/Plugins/WrenRim/WrenMods"
+      // Handles for Events.dispatch are looked up once, not per event
       try {
-        const fs::path mods_path = "Data/SKSE/Plugins/WrenRim/WrenMods";
-        if (fs::exists(mods_path) && fs::is_directory(mods_path)) {
-          logger::info("Loading User Mods from: {}", mods_path.string());
-
-          for (const auto& entry : fs::directory_iterator(mods_path)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".wren") {
-              logger::info("  Running script: {}", entry.path().filename().string());
-              try {
-                std::string modName = entry.path().stem().string();
-                vm_->runFromFile(modName, entry.path().string());
-              }
-              catch (const std::exception& e) {
-                logger::error("    Error running script {}: {}", entry.path().filename().string(), e.what());
-              }
-            }
-          }
-        }
-        else {
-          logger::warn("User mods directory not found: {}", mods_path.string());
-        }
+        dispatcher_.attach(*vm_);
       }
       catch (const std::exception& e) {
-        logger::error("Error scanning user mods directory: {}", e.what());
+        logger::error("Events class not found: {}", e.what());
+      }
+
+      // 2. Load User Scripts
+      script_runtime::run_mods(*vm_, mods_path_);
+
+      // Консоль живет в своем модуле "console", после модов ей доступно все, что они импортируют
+      console_.attach(*vm_);
+
+      if (cfg->is_event_recording_enabled()) {
+        event_record::recorder::get_singleton()->start(cfg->get_event_record_path());
       }
 
       logger::info("Wren ScriptEngine initialized.");
@@ -116,6 +82,10 @@ namespace wren::script_engine
     {
       if (vm_) {
         logger::info("Shutting down Wren ScriptEngine...");
+        profiling::profiler::get_singleton()->stop(vm_->getVm());
+        workers::pool::get_singleton()->terminate_all();
+        console_.reset();
+        dispatcher_.reset();
         vm_.reset();
         logger::info("Wren ScriptEngine shut down.");
       }
@@ -124,6 +94,7 @@ namespace wren::script_engine
     void reload_user_mods()
     {
       logger::info("Performing Nuclear Reload of Wren VM...");
+      tracing::zone zone(tracing::category::kReload, "HotReload");
       shutdown();
       initialize();
       logger::info("Nuclear Reload complete.");
@@ -132,6 +103,16 @@ namespace wren::script_engine
     void on_frame_start()
     {
       accumulated_time_us_ = 0;
+      tracing::tracer::get_singleton()->on_frame_start();
+      profiling::profiler::get_singleton()->on_frame_start(vm_ ? vm_->getVm() : nullptr);
+      heap_snapshot::snapshotter::get_singleton()->on_frame_start(vm_ ? vm_->getVm() : nullptr);
+      event_record::recorder::get_singleton()->on_frame_start();
+      // Изменения, записанные обработчиками прошлого кадра; до сброса кеша хендлов
+      wrappers::command_buffer::get_singleton()->flush();
+      wrappers::actor_grid::get_singleton()->on_frame_start();
+      wrappers::actor_handle_cache::get_singleton()->on_frame_start();
+      wrappers::active_effect_index::get_singleton()->on_frame_start();
+      deliver_worker_results();
     }
 
     template<typename... Args>
@@ -139,7 +120,12 @@ namespace wren::script_engine
     {
       auto cfg = config::manager::get_singleton();
       if (!cfg->is_enabled()) return;
-      if (!vm_) return;
+      if (!vm_ || !dispatcher_.attached()) return;
+
+      // Запись идет до проверки бюджета: в файл попадает реальный поток событий
+      if (const auto recorder = event_record::recorder::get_singleton(); recorder->recording()) {
+        recorder->record(event_name, args...);
+      }
 
       // Time Budget Check
       if (accumulated_time_us_ > cfg->get_max_frame_time_budget_us()) {
@@ -150,20 +136,8 @@ namespace wren::script_engine
       auto start = std::chrono::high_resolution_clock::now();
 
       try {
-        // Look for "Events" class in "Events" module
-        auto events_class = vm_->find("Events", "Events");
-
-        // Generate signature: dispatch(_,_,...)
-        std::string signature = "dispatch(";
-        constexpr size_t arg_count = 1 + sizeof...(Args);
-        for (size_t i = 0; i < arg_count; ++i) {
-          if (i > 0) signature += ",";
-          signature += "_";
-        }
-        signature += ")";
-
-        auto dispatch_func = events_class.func(signature);
-        dispatch_func(event_name, std::forward<Args>(args)...);
+        tracing::zone zone(tracing::category::kDispatch, event_name);
+        dispatcher_.dispatch(event_name, std::forward<Args>(args)...);
       }
       catch (const std::exception& e) {
         logger::error("Wren Error in {}: {}", event_name, e.what());
@@ -177,7 +151,7 @@ namespace wren::script_engine
       accumulated_time_us_ += duration;
 
       if (duration > 10) {
-        logger::info("[Wren] Event {} took {}us AccumulatedTime {}us", event_name, duration, accumulated_time_us_);
+        logger::debug("[Wren] Event {} took {}us AccumulatedTime {}us", event_name, duration, accumulated_time_us_);
       }
     }
 
@@ -192,7 +166,39 @@ namespace wren::script_engine
       }
     }
 
+    /**
+     * @brief Строки консоли (меню SKSE) копятся в очереди, выполняет их process_console().
+     */
+    console::session& get_console() { return console_; }
+
+    void process_console()
+    {
+      if (vm_) console_.process();
+    }
+
   private:
+    // Ответов воркеров за кадр, остальные ждут следующего
+    static constexpr std::size_t max_worker_results_per_frame = 64;
+
+    /**
+     * @brief Ответы воркеров событиями OnWorkerMessage / OnWorkerError.
+     * Берутся по одному, пока есть бюджет кадра: не доставленные остаются в очереди пула.
+     */
+    void deliver_worker_results()
+    {
+      if (!vm_ || !dispatcher_.attached()) return;
+
+      const auto cfg = config::manager::get_singleton();
+      const auto pool = workers::pool::get_singleton();
+      workers::result r;
+      for (std::size_t i = 0; i < max_worker_results_per_frame; ++i) {
+        if (accumulated_time_us_ > cfg->get_max_frame_time_budget_us() || !pool->take(r)) break;
+        wrappers::worker w(std::move(r.worker));
+        if (r.error.empty()) dispatch("OnWorkerMessage", w, wrappers::storage_entry{&r.bytes});
+        else dispatch("OnWorkerError", w, r.error);
+      }
+    }
+
     engine() = default;
     ~engine() = default;
     engine(const engine&) = delete;
@@ -200,7 +206,11 @@ namespace wren::script_engine
     engine& operator=(const engine&) = delete;
     engine& operator=(engine&&) = delete;
 
+    std::string std_path_{"Data/SKSE/Plugins/WrenRim/Std"};
+    std::string mods_path_{"Data/SKSE/Plugins/WrenRim/WrenMods"};
     std::unique_ptr<wrenbind17::VM> vm_;
+    script_runtime::event_dispatcher dispatcher_;
+    console::session console_;
     size_t accumulated_time_us_{0};
   };
 }
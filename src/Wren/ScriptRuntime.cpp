@@ -0,0 +1,260 @@
+module;
+
+#include "pch.h"
+#include "Wren/Tracer.hpp"
+
+export module WrenRim.Wren.ScriptRuntime;
+
+import WrenRim.Wren.BindingManager;
+
+// Общая часть движка скриптов: создание VM, загрузка Std и модов, вызов Events.dispatch.
+// Используется engine в плагине и wrenrim-host.
+export namespace wren::script_runtime
+{
+  namespace fs = std::filesystem;
+
+  /**
+   * @brief Создает VM с путями поиска модулей и регистрирует все обертки.
+   */
+  std::unique_ptr<wrenbind17::VM> create_vm(const std::vector<std::string>& search_paths)
+  {
+    auto vm = std::make_unique<wrenbind17::VM>(search_paths);
+
+    // Настройка логгера (чтобы System.print писал в лог SKSE)
+    vm->setPrintFunc([](const char* text) {
+      if (text[0] == '\n' && text[1] == '\0') return;
+      SKSE::log::info("[Wren] {}", text);
+    });
+
+    // Configure Module Resolution
+    vm->setPathResolveFunc(
+      [](const std::vector<std::string>&, const std::string&, const std::string& name) -> std::string {
+        return name;
+      });
+
+    vm->setLoadFileFunc([search_paths](const std::string& name) -> std::string {
+      for (const auto& base_path : search_paths) {
+        auto full_path = fs::path(base_path) / (name + ".wren");
+        if (fs::exists(full_path)) {
+          std::ifstream t(full_path);
+          return std::string((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+        }
+      }
+
+      throw std::runtime_error("Module not found: " + name);
+    });
+
+    // Сборки мусора на временной шкале трассировки
+    vm->setGcFunc(tracing::tracer::on_gc);
+
+    // Register Bindings (C++ -> Wren)
+    binding_manager::bind_wrappers(*vm);
+    return vm;
+  }
+
+  /**
+   * @brief Загружает стандартную библиотеку. false — VM непригодна для модов.
+   */
+  bool load_std(wrenbind17::VM& vm)
+  {
+    try {
+      logger::info("Loading Standard Library...");
+      binding_manager::load_core_modules(vm);
+      return true;
+    }
+    catch (const std::exception& e) {
+      logger::error("Failed to load Standard Library: {}", e.what());
+      return false;
+    }
+  }
+
+  /**
+   * @brief Запускает каждый .wren файл из каталога модов как отдельный модуль.
+   */
+  void run_mods(wrenbind17::VM& vm, const fs::path& mods_path)
+  {
+    try {
+      if (fs::exists(mods_path) && fs::is_directory(mods_path)) {
+        logger::info("Loading User Mods from: {}", mods_path.string());
+
+        for (const auto& entry : fs::directory_iterator(mods_path)) {
+          if (entry.is_regular_file() && entry.path().extension() == ".wren") {
+            logger::info("  Running script: {}", entry.path().filename().string());
+            try {
+              std::string modName = entry.path().stem().string();
+              vm.runFromFile(modName, entry.path().string());
+            }
+            catch (const std::exception& e) {
+              logger::error("    Error running script {}: {}", entry.path().filename().string(), e.what());
+            }
+          }
+        }
+      }
+      else {
+        logger::warn("User mods directory not found: {}", mods_path.string());
+      }
+    }
+    catch (const std::exception& e) {
+      logger::error("Error scanning user mods directory: {}", e.what());
+    }
+  }
+
+  /**
+   * @brief Вызов Events.dispatch(_,...) с кэшированными хэндлами.
+   *
+   * Класс Events и метод для каждой арности ищутся один раз после загрузки Std,
+   * а не на каждом событии. reset() обязателен до уничтожения VM.
+   * Во время захвата трассировки подписчики вызываются по одному (Events.listeners),
+   * чтобы у каждого была своя зона.
+   */
+  class event_dispatcher
+  {
+  public:
+    // Events.wren объявляет dispatch(event) .. dispatch(event, a1..a8)
+    static constexpr std::size_t max_arity = 9;
+
+    void attach(wrenbind17::VM& vm)
+    {
+      reset();
+      events_class_ = vm.find("Events", "Events");
+      vm_ = vm.getVm();
+      attached_ = true;
+    }
+
+    void reset()
+    {
+      for (auto& method : methods_) method.reset();
+      if (vm_) {
+        if (listeners_handle_) wrenReleaseHandle(vm_, listeners_handle_);
+        for (const auto handle : call_handles_) {
+          if (handle) wrenReleaseHandle(vm_, handle);
+        }
+      }
+      listeners_handle_ = nullptr;
+      call_handles_.fill(nullptr);
+      listener_names_.clear();
+      events_class_.reset();
+      vm_ = nullptr;
+      attached_ = false;
+    }
+
+    [[nodiscard]] bool attached() const { return attached_; }
+
+    /**
+     * @brief Исключения Wren пробрасываются вызывающему.
+     */
+    template<typename... Args>
+    void dispatch(const std::string& event_name, Args&&... args)
+    {
+      constexpr std::size_t arity = 1 + sizeof...(Args);
+      static_assert(arity <= max_arity, "Events.dispatch accepts at most 8 arguments");
+
+      if (tracing::tracer::capturing()) {
+        dispatch_traced(event_name, args...);
+        return;
+      }
+
+      auto& method = methods_[arity - 1];
+      if (!method) {
+        method = events_class_.func(signature<arity>());
+      }
+      method(event_name, std::forward<Args>(args)...);
+    }
+
+  private:
+    // То же, что Events.dispatch: подписчики по порядку, первая ошибка прерывает рассылку
+    template<typename... Args>
+    void dispatch_traced(const std::string& event_name, Args&... args)
+    {
+      constexpr int arity = static_cast<int>(sizeof...(Args));
+      auto& call = call_handles_[arity];
+      if (!call) call = wrenMakeCallHandle(vm_, call_signature<arity>().c_str());
+      if (!listeners_handle_) listeners_handle_ = wrenMakeCallHandle(vm_, "listeners(_)");
+
+      wrenEnsureSlots(vm_, 2);
+      wrenSetSlotHandle(vm_, 0, events_class_.getHandle().getHandle());
+      wrenSetSlotBytes(vm_, 1, event_name.data(), event_name.size());
+      if (wrenCall(vm_, listeners_handle_) != WREN_RESULT_SUCCESS) {
+        throw wrenbind17::RuntimeError(wrenbind17::getLastError(vm_));
+      }
+
+      const auto list = wrenGetSlotHandle(vm_, 0);
+      const std::unique_ptr<WrenHandle, std::function<void(WrenHandle*)>> list_guard(
+        list, [vm = vm_](WrenHandle* handle) { wrenReleaseHandle(vm, handle); });
+
+      // Список перечитывается на каждом шаге: подписчик может добавить новый, как и в for-in
+      for (int i = 0;; ++i) {
+        wrenEnsureSlots(vm_, arity + 2);
+        wrenSetSlotHandle(vm_, arity + 1, list);
+        if (i >= wrenGetListCount(vm_, arity + 1)) break;
+        wrenGetListElement(vm_, arity + 1, i, 0);
+
+        tracing::zone z(tracing::category::kListener, listener_name(0));
+        wrenbind17::detail::pushArgs(vm_, 1, args...);
+        if (wrenCall(vm_, call) != WREN_RESULT_SUCCESS) {
+          throw wrenbind17::RuntimeError(wrenbind17::getLastError(vm_));
+        }
+      }
+    }
+
+    // "Модуль:строка" функции-подписчика в слоте
+    std::uint32_t listener_name(const int slot)
+    {
+      const char* module = nullptr;
+      int line = 0;
+      if (!wrenGetSlotFnSource(vm_, slot, &module, &line)) {
+        static const auto unknown = tracing::tracer::get_singleton()->intern("listener");
+        return unknown;
+      }
+
+      const auto key = std::pair{static_cast<const void*>(module), line};
+      auto it = listener_names_.find(key);
+      if (it == listener_names_.end()) {
+        it = listener_names_
+               .emplace(key, tracing::tracer::get_singleton()->intern(std::string(module) + ":" + std::to_string(line)))
+               .first;
+      }
+      return it->second;
+    }
+
+    template<int Arity>
+    static const std::string& call_signature()
+    {
+      // call() / call(_) / call(_,_) ...
+      static const std::string value = [] {
+        std::string result = "call(";
+        for (int i = 0; i < Arity; ++i) {
+          if (i > 0) result += ",";
+          result += "_";
+        }
+        return result + ")";
+      }();
+      return value;
+    }
+
+    template<std::size_t Arity>
+    static const std::string& signature()
+    {
+      // Generate signature: dispatch(_,_,...)
+      static const std::string value = [] {
+        std::string result = "dispatch(";
+        for (std::size_t i = 0; i < Arity; ++i) {
+          if (i > 0) result += ",";
+          result += "_";
+        }
+        return result + ")";
+      }();
+      return value;
+    }
+
+    wrenbind17::Variable events_class_;
+    std::array<wrenbind17::Method, max_arity> methods_{};
+    bool attached_{false};
+
+    // Для dispatch_traced
+    WrenVM* vm_{nullptr};
+    WrenHandle* listeners_handle_{nullptr};
+    std::array<WrenHandle*, max_arity> call_handles_{};
+    std::map<std::pair<const void*, int>, std::uint32_t> listener_names_;
+  };
+}
@@ -0,0 +1,476 @@
+#pragma once
+
+#include "pch.h"
+
+#include <atomic>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+// Трассировка кадров в формате Chrome trace (chrome://tracing, ui.perfetto.dev).
+// События пишутся в кольцевой буфер своего потока с меткой TSC, в наносекунды
+// они переводятся только при экспорте, по калибровке на границах захвата.
+namespace wren::tracing
+{
+  enum class category : std::uint8_t
+  {
+    kFrame,
+    kDispatch,
+    kListener,
+    kGC,
+    kReload,
+    kScript,
+    kCommands,
+  };
+
+  enum class phase : std::uint8_t
+  {
+    kBegin,
+    kEnd,
+  };
+
+  struct trace_event
+  {
+    std::uint64_t tsc{0};
+    // Для GC — размер кучи в байтах
+    std::uint64_t arg{0};
+    std::uint32_t name{0};
+    phase ph{phase::kBegin};
+    category cat{category::kFrame};
+  };
+
+  inline std::uint64_t now()
+  {
+    return __rdtsc();
+  }
+
+  /**
+   * @brief Кольцевой буфер событий одного потока без блокировок: пишет только свой поток, читает экспорт.
+   * Если буфер полон, событие отбрасывается и учитывается в dropped.
+   * Память под события выделяется при первой записи, то есть только во время захвата:
+   * кольцо потока, которому лишь дали имя, почти ничего не занимает.
+   */
+  class thread_ring
+  {
+  public:
+    thread_ring(const std::uint32_t tid, const std::size_t capacity) :
+        tid(tid), name("Thread " + std::to_string(tid)), capacity_(std::bit_ceil(capacity))
+    {
+    }
+
+    bool push(const trace_event& e)
+    {
+      // drain читает events_ только при head != tail, а head публикуется после выделения
+      if (events_.empty()) {
+        events_.resize(capacity_);
+        mask_ = capacity_ - 1;
+      }
+      const auto head = head_.load(std::memory_order_relaxed);
+      const auto tail = tail_.load(std::memory_order_acquire);
+      if (head - tail == capacity_) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      events_[head & mask_] = e;
+      head_.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    template<typename F>
+    void drain(F&& fn)
+    {
+      const auto tail = tail_.load(std::memory_order_relaxed);
+      const auto head = head_.load(std::memory_order_acquire);
+      for (auto i = tail; i != head; ++i) fn(events_[i & mask_]);
+      tail_.store(head, std::memory_order_release);
+    }
+
+    const std::uint32_t tid;
+    std::string name;
+    std::atomic<std::uint64_t> dropped{0};
+    // Открытые зоны Trace.begin из скриптов, закрываются вместе с внешней зоной
+    std::uint32_t script_depth{0};
+
+  private:
+    const std::size_t capacity_;
+    std::vector<trace_event> events_;
+    std::size_t mask_{0};
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+  };
+
+  /**
+   * @brief Захват N кадров и экспорт в JSON (Chrome trace event format).
+   *
+   * capture() только ставит запрос, захват начинается и заканчивается в on_frame_start(),
+   * который вызывается в начале кадра (on_update_player_character). Файл пишет отдельный поток.
+   * Пока захвата нет, каждая точка трассировки стоит одной атомарной загрузки.
+   */
+  class tracer
+  {
+  public:
+    static constexpr std::size_t ring_capacity = 1 << 18;
+
+    static tracer* get_singleton()
+    {
+      static tracer singleton;
+      return &singleton;
+    }
+
+    [[nodiscard]] static bool capturing() { return get_singleton()->capturing_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Запрашивает захват frames кадров. false — захват или запись файла уже идут.
+     */
+    bool capture(const std::uint32_t frames, const std::filesystem::path& path)
+    {
+      if (!frames || busy()) return false;
+      std::scoped_lock lock(request_lock_);
+      path_ = path;
+      requested_frames_.store(frames, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief Завершает текущий захват досрочно и пишет файл.
+     */
+    void stop()
+    {
+      if (!capturing()) return;
+      end(category::kFrame, frame_name_);
+      finish();
+    }
+
+    /**
+     * @brief Дожидается записи файла.
+     */
+    void wait()
+    {
+      if (exporter_.joinable()) exporter_.join();
+    }
+
+    [[nodiscard]] bool busy() const
+    {
+      return capturing_.load(std::memory_order_relaxed) || exporting_.load(std::memory_order_relaxed) ||
+             requested_frames_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint32_t frames_captured() const { return frames_captured_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint32_t frames_requested() const { return frames_target_.load(std::memory_order_relaxed); }
+    [[nodiscard]] bool exporting() const { return exporting_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Граница кадра: начинает запрошенный захват, отмечает кадр и завершает захват после N кадров.
+     */
+    void on_frame_start()
+    {
+      if (capturing()) {
+        end(category::kFrame, frame_name_);
+        if (frames_captured_.fetch_add(1, std::memory_order_relaxed) + 1 >= frames_target_) {
+          finish();
+          return;
+        }
+        begin(category::kFrame, frame_name_);
+        return;
+      }
+
+      const auto frames = requested_frames_.load(std::memory_order_acquire);
+      if (!frames || exporting_.load(std::memory_order_acquire)) return;
+
+      // Предыдущий экспорт закончен, остатки в буферах (события после конца захвата) не нужны
+      wait();
+      {
+        std::scoped_lock lock(rings_lock_);
+        for (const auto& ring : rings_) {
+          ring->drain([](const trace_event&) {});
+          ring->dropped = 0;
+        }
+      }
+      frames_target_ = frames;
+      frames_captured_ = 0;
+      requested_frames_.store(0, std::memory_order_release);
+      start_tsc_ = now();
+      start_time_ = std::chrono::steady_clock::now();
+      capturing_.store(true, std::memory_order_release);
+      logger::info("Trace: capturing {} frames", frames);
+      begin(category::kFrame, frame_name_);
+    }
+
+    /**
+     * @brief Номер имени для событий. Имена не удаляются до конца работы.
+     */
+    std::uint32_t intern(const std::string_view name)
+    {
+      thread_local std::unordered_map<std::string, std::uint32_t, string_hash, std::equal_to<>> cache;
+      if (const auto it = cache.find(name); it != cache.end()) return it->second;
+
+      std::scoped_lock lock(names_lock_);
+      auto it = ids_.find(name);
+      if (it == ids_.end()) {
+        names_.emplace_back(name);
+        it = ids_.emplace(names_.back(), static_cast<std::uint32_t>(names_.size() - 1)).first;
+      }
+      cache.emplace(std::string(name), it->second);
+      return it->second;
+    }
+
+    void begin(const category cat, const std::uint32_t name, const std::uint64_t arg = 0)
+    {
+      current_ring().push({now(), arg, name, phase::kBegin, cat});
+    }
+
+    void end(const category cat, const std::uint32_t name, const std::uint64_t arg = 0)
+    {
+      current_ring().push({now(), arg, name, phase::kEnd, cat});
+    }
+
+    /**
+     * @brief Имя потока на временной шкале.
+     */
+    void name_current_thread(std::string name) { current_ring().name = std::move(name); }
+
+    /**
+     * @brief Зона Trace.begin(name) из скрипта.
+     */
+    void script_begin(const std::string_view name)
+    {
+      auto& ring = current_ring();
+      ++ring.script_depth;
+      ring.push({now(), 0, intern(name), phase::kBegin, category::kScript});
+    }
+
+    /**
+     * @brief Trace.end() без парного begin игнорируется.
+     */
+    void script_end()
+    {
+      auto& ring = current_ring();
+      if (!ring.script_depth) return;
+      --ring.script_depth;
+      ring.push({now(), 0, 0, phase::kEnd, category::kScript});
+    }
+
+    /**
+     * @brief Закрывает зоны скрипта, оставшиеся открытыми после вызова (ошибка или забытый Trace.end).
+     */
+    void close_script_zones(const std::uint32_t depth)
+    {
+      auto& ring = current_ring();
+      while (ring.script_depth > depth) {
+        --ring.script_depth;
+        ring.push({now(), 0, 0, phase::kEnd, category::kScript});
+      }
+    }
+
+    std::uint32_t script_depth() { return current_ring().script_depth; }
+
+    /**
+     * @brief Для WrenConfiguration::gcFn (через wrenbind17::VM::setGcFunc).
+     */
+    static void on_gc(const WrenGCPhase gc_phase, const std::size_t bytes)
+    {
+      if (!capturing()) return;
+      const auto self = get_singleton();
+      if (gc_phase == WREN_GC_BEGIN) self->begin(category::kGC, self->gc_name_, bytes);
+      else self->end(category::kGC, self->gc_name_, bytes);
+    }
+
+  private:
+    struct string_hash
+    {
+      using is_transparent = void;
+      std::size_t operator()(const std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    tracer() : frame_name_(intern("Frame")), gc_name_(intern("GC")) {}
+    ~tracer() { wait(); }
+    tracer(const tracer&) = delete;
+    tracer(tracer&&) = delete;
+    tracer& operator=(const tracer&) = delete;
+    tracer& operator=(tracer&&) = delete;
+
+    thread_ring& current_ring()
+    {
+      thread_local thread_ring* ring = nullptr;
+      if (!ring) {
+        std::scoped_lock lock(rings_lock_);
+        ring = rings_.emplace_back(std::make_unique<thread_ring>(static_cast<std::uint32_t>(rings_.size() + 1),
+                                                                 ring_capacity)).get();
+      }
+      return *ring;
+    }
+
+    void finish()
+    {
+      const auto end_tsc = now();
+      const auto end_time = std::chrono::steady_clock::now();
+      capturing_.store(false, std::memory_order_release);
+      exporting_.store(true, std::memory_order_release);
+
+      const auto ns = std::chrono::duration<double, std::nano>(end_time - start_time_).count();
+      const auto ns_per_tick = end_tsc > start_tsc_ ? ns / static_cast<double>(end_tsc - start_tsc_) : 1.0;
+
+      std::filesystem::path path;
+      {
+        std::scoped_lock lock(request_lock_);
+        path = path_;
+      }
+
+      exporter_ = std::jthread([this, path = std::move(path), ns_per_tick] {
+        write_json(path, ns_per_tick);
+        exporting_.store(false, std::memory_order_release);
+      });
+    }
+
+    static void write_json_string(std::ostream& out, const std::string_view s)
+    {
+      out << '"';
+      for (const char c : s) {
+        switch (c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+          }
+          else {
+            out << c;
+          }
+        }
+      }
+      out << '"';
+    }
+
+    void write_json(const std::filesystem::path& path, const double ns_per_tick)
+    {
+      std::ofstream out(path, std::ios::trunc);
+      if (!out) {
+        logger::error("Trace: can't open {}", path.string());
+        return;
+      }
+
+      static constexpr const char* category_names[] = {"frame",  "dispatch", "listener", "gc",
+                                                       "reload", "script",   "commands"};
+
+      std::vector<std::string> names;
+      {
+        std::scoped_lock lock(names_lock_);
+        names.assign(names_.begin(), names_.end());
+      }
+
+      std::size_t count = 0;
+      std::uint64_t dropped = 0;
+      bool first = true;
+      out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+      out << std::fixed << std::setprecision(3);
+
+      std::scoped_lock lock(rings_lock_);
+      for (const auto& ring : rings_) {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+        bool named = false;
+        ring->drain([&](const trace_event& e) {
+          if (!named) {
+            named = true;
+            out << (first ? "\n" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << ring->tid
+                << R"(,"args":{"name":)";
+            write_json_string(out, ring->name);
+            out << "}}";
+            first = false;
+          }
+
+          const auto ts = e.tsc >= start_tsc_ ? static_cast<double>(e.tsc - start_tsc_) * ns_per_tick / 1000.0 : 0.0;
+          out << (first ? "\n" : ",\n") << "{\"name\":";
+          write_json_string(out, e.ph == phase::kBegin && e.name < names.size() ? names[e.name] : std::string_view{});
+          out << ",\"cat\":\"" << category_names[std::to_underlying(e.cat)] << "\",\"ph\":\""
+              << (e.ph == phase::kBegin ? 'B' : 'E') << "\",\"ts\":" << ts << ",\"pid\":1,\"tid\":" << ring->tid;
+          if (e.cat == category::kGC) out << ",\"args\":{\"bytes\":" << e.arg << "}";
+          out << "}";
+          first = false;
+          ++count;
+        });
+      }
+      out << "\n]}\n";
+
+      logger::info("Trace: {} events written to {} ({} dropped)", count, path.string(), dropped);
+    }
+
+    std::atomic<bool> capturing_{false};
+    std::atomic<bool> exporting_{false};
+    std::atomic<std::uint32_t> requested_frames_{0};
+    std::atomic<std::uint32_t> frames_target_{0};
+    std::atomic<std::uint32_t> frames_captured_{0};
+    std::uint64_t start_tsc_{0};
+    std::chrono::steady_clock::time_point start_time_;
+    std::mutex request_lock_;
+    std::filesystem::path path_;
+    std::jthread exporter_;
+
+    std::mutex rings_lock_;
+    std::vector<std::unique_ptr<thread_ring>> rings_;
+
+    std::mutex names_lock_;
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, std::uint32_t, string_hash, std::equal_to<>> ids_;
+
+    std::uint32_t frame_name_;
+    std::uint32_t gc_name_;
+  };
+
+  /**
+   * @brief Зона на время жизни объекта. Если захвата нет, ничего не пишет.
+   * Закрывает зоны скриптов, которые остались открытыми внутри нее.
+   */
+  class zone
+  {
+  public:
+    zone(const category cat, const std::string_view name)
+    {
+      if (!tracer::capturing()) return;
+      active_ = true;
+      cat_ = cat;
+      const auto t = tracer::get_singleton();
+      name_ = t->intern(name);
+      script_depth_ = t->script_depth();
+      t->begin(cat_, name_);
+    }
+
+    zone(const category cat, const std::uint32_t name)
+    {
+      if (!tracer::capturing()) return;
+      active_ = true;
+      cat_ = cat;
+      name_ = name;
+      const auto t = tracer::get_singleton();
+      script_depth_ = t->script_depth();
+      t->begin(cat_, name_);
+    }
+
+    ~zone()
+    {
+      if (!active_) return;
+      const auto t = tracer::get_singleton();
+      t->close_script_zones(script_depth_);
+      t->end(cat_, name_);
+    }
+
+    zone(const zone&) = delete;
+    zone& operator=(const zone&) = delete;
+
+  private:
+    bool active_{false};
+    category cat_{category::kFrame};
+    std::uint32_t name_{0};
+    std::uint32_t script_depth_{0};
+  };
+}
@@ -0,0 +1,492 @@
+#pragma once
+
+#include "pch.h"
+#include "Wren/Tracer.hpp"
+#include "Wren/Wrappers/Storage.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+// Вычислительные VM Wren в пуле потоков. Скрипт главной VM создает воркера (Worker.spawn),
+// воркер — отдельная wrenbind17::VM со своим скриптом из WrenMods/Workers и урезанной Std
+// без привязок игры: кроме ядра Wren ему доступен только модуль "Worker/Port".
+// Сообщения — значения Wren в формате storage (Num, Bool, String, null, List/Map из них),
+// VM не делят ни одного объекта. Ответы воркеров главная VM получает событиями в начале кадра.
+namespace wren::workers
+{
+  /**
+   * @brief Воркер: VM и очередь входящих сообщений.
+   * VM создается и используется только потоками пула, в каждый момент — не больше чем одним
+   * (scheduled). Поля под lock; vm и хэндлы — только у потока, который воркера обрабатывает.
+   */
+  struct worker_state
+  {
+    std::uint32_t id{0};
+    // pool::terminate_all() на момент создания
+    std::uint32_t generation{0};
+    // Имя скрипта в WrenMods/Workers без расширения
+    std::string name;
+
+    std::mutex lock;
+    std::deque<std::string> inbox;
+    bool scheduled{false};
+    std::atomic<bool> terminated{false};
+
+    std::unique_ptr<wrenbind17::VM> vm;
+    WrenHandle* port_class{nullptr};
+    WrenHandle* receive_handle{nullptr};
+  };
+
+  /**
+   * @brief Сообщение или ошибка воркера для главной VM.
+   */
+  struct result
+  {
+    std::shared_ptr<worker_state> worker;
+    std::string bytes;
+    // Не пусто — ошибка скрипта воркера, bytes не используется
+    std::string error;
+  };
+
+  /**
+   * @brief Значение Wren, закодированное при разборе аргумента foreign-метода (Worker.post, Port.post).
+   */
+  struct message_value
+  {
+    std::string bytes;
+    bool ok{false};
+  };
+
+  /**
+   * @brief Port.post/onMessage в VM воркера.
+   */
+  class port
+  {
+  public:
+    static constexpr const char* module_name = "Worker/Port";
+
+    /**
+     * @brief Отправляет сообщение в главную VM.
+     * @param message Num, Bool, String, null или List/Map из них.
+     */
+    static auto post(const message_value& message) -> wrenbind17::Result<void>;
+
+    static void bind(wrenbind17::ForeignModule& module)
+    {
+      auto& cls = module.klass<port>("Port");
+      cls.funcStatic<&port::post>("post");
+    }
+  };
+
+  /**
+   * @brief Пул потоков воркеров.
+   *
+   * spawn/post/terminate/take — только главный поток. Потоки запускаются при первом spawn.
+   * Скрипт, который не возвращает управление, прервать нельзя: terminate() отбрасывает
+   * очередь воркера, а VM уничтожается, когда текущее сообщение будет обработано.
+   */
+  class pool
+  {
+  public:
+    static constexpr std::size_t max_inbox = 1024;
+    static constexpr std::size_t max_results = 4096;
+    // Сообщений одного воркера подряд, потом поток переходит к следующему
+    static constexpr std::size_t batch = 16;
+
+    static pool* get_singleton()
+    {
+      static pool singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Параметры для новых воркеров. Уже созданные воркеры не меняются.
+     */
+    void configure(const std::size_t threads, const std::filesystem::path& std_path,
+                   const std::filesystem::path& workers_path)
+    {
+      std::scoped_lock lock(queue_lock_);
+      thread_count_ = std::max<std::size_t>(threads, 1);
+      std_path_ = std_path;
+      workers_path_ = workers_path;
+    }
+
+    /**
+     * @brief Создает воркера. Скрипт загружается потоком пула вместе с первым сообщением.
+     * Вызывается из foreign-метода, поэтому не бросает исключений.
+     * @return nullptr, если скрипта нет; ошибка, если потоки пула не удалось запустить.
+     */
+    auto spawn(const std::string& name) -> wrenbind17::Result<std::shared_ptr<worker_state>>
+    {
+      std::filesystem::path path;
+      {
+        std::scoped_lock lock(queue_lock_);
+        path = workers_path_ / (name + ".wren");
+      }
+      std::error_code ec;
+      if (name.empty() || name.find_first_of("/\\.") != std::string::npos || !std::filesystem::exists(path, ec)) {
+        logger::error("Worker: script not found: {}", path.string());
+        return nullptr;
+      }
+
+      if (!start_threads()) return wrenbind17::scriptError("Worker.spawn: failed to start worker threads");
+      prune();
+      auto w = std::make_shared<worker_state>();
+      w->id = ++last_id_;
+      w->generation = generation_;
+      w->name = name;
+      workers_.push_back(w);
+      // Загрузка скрипта — первая задача воркера
+      schedule(w);
+      return w;
+    }
+
+    /**
+     * @brief Ставит сообщение в очередь воркера. false — воркер остановлен или очередь полна.
+     */
+    bool post(const std::shared_ptr<worker_state>& w, std::string bytes)
+    {
+      if (!w || w->terminated.load(std::memory_order_acquire)) return false;
+      {
+        std::scoped_lock lock(w->lock);
+        if (w->inbox.size() >= max_inbox) return false;
+        w->inbox.push_back(std::move(bytes));
+      }
+      schedule(w);
+      return true;
+    }
+
+    void terminate(const std::shared_ptr<worker_state>& w)
+    {
+      prune();
+      if (!w || w->terminated.exchange(true, std::memory_order_acq_rel)) return;
+      {
+        std::scoped_lock lock(w->lock);
+        w->inbox.clear();
+      }
+      std::erase(workers_, w);
+      // VM уничтожит поток пула
+      schedule(w);
+    }
+
+    /**
+     * @brief Останавливает всех воркеров и отбрасывает их ответы (перезагрузка главной VM).
+     */
+    void terminate_all()
+    {
+      for (const auto& w : std::vector(workers_)) terminate(w);
+      workers_.clear();
+      ++generation_;
+      std::scoped_lock lock(results_lock_);
+      results_.clear();
+    }
+
+    /**
+     * @brief Забирает следующий ответ воркеров.
+     */
+    bool take(result& out)
+    {
+      std::scoped_lock lock(results_lock_);
+      while (!results_.empty()) {
+        out = std::move(results_.front());
+        results_.pop_front();
+        // Ответы воркеров прошлой VM и сообщения остановленных воркеров не доставляются
+        if (out.worker->generation != generation_) continue;
+        if (out.error.empty() && out.worker->terminated.load(std::memory_order_acquire)) continue;
+        return true;
+      }
+      return false;
+    }
+
+    [[nodiscard]] std::size_t workers() const { return workers_.size(); }
+    [[nodiscard]] std::uint64_t processed() const { return processed_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Для Port.post: ответ воркера, сообщение которого сейчас обрабатывает этот поток.
+     */
+    static bool post_result(std::string bytes)
+    {
+      auto& w = current();
+      if (!w) return false;
+      return get_singleton()->push_result({w, std::move(bytes), {}});
+    }
+
+  private:
+    // Воркеры, остановленные потоком пула (fail), сам пул из workers_ не убирает: он не главный поток
+    void prune()
+    {
+      std::erase_if(workers_, [](const auto& w) { return w->terminated.load(std::memory_order_acquire); });
+    }
+
+    static std::shared_ptr<worker_state>& current()
+    {
+      thread_local std::shared_ptr<worker_state> value;
+      return value;
+    }
+
+    // Потоки пишут в трейсер: он должен пережить пул
+    pool() { tracing::tracer::get_singleton(); }
+    ~pool()
+    {
+      for (auto& t : threads_) t.request_stop();
+      queue_cv_.notify_all();
+    }
+    pool(const pool&) = delete;
+    pool(pool&&) = delete;
+    pool& operator=(const pool&) = delete;
+    pool& operator=(pool&&) = delete;
+
+    // false — не запущено ни одного потока; при следующем spawn попытка повторится
+    bool start_threads()
+    {
+      if (!threads_.empty()) return true;
+      std::size_t count = 0;
+      {
+        std::scoped_lock lock(queue_lock_);
+        count = thread_count_;
+      }
+      try {
+        for (std::size_t i = 0; i < count; ++i) {
+          threads_.emplace_back([this, i](const std::stop_token& stop) {
+            tracing::tracer::get_singleton()->name_current_thread("Worker " + std::to_string(i + 1));
+            run(stop);
+          });
+        }
+      }
+      catch (const std::system_error& e) {
+        logger::error("Worker: failed to start thread {} of {}: {}", threads_.size() + 1, count, e.what());
+      }
+      if (threads_.empty()) return false;
+      logger::info("Worker: started {} threads", threads_.size());
+      return true;
+    }
+
+    void schedule(const std::shared_ptr<worker_state>& w)
+    {
+      {
+        std::scoped_lock lock(w->lock);
+        if (w->scheduled) return;
+        w->scheduled = true;
+      }
+      {
+        std::scoped_lock lock(queue_lock_);
+        queue_.push_back(w);
+      }
+      queue_cv_.notify_one();
+    }
+
+    bool push_result(result r)
+    {
+      std::scoped_lock lock(results_lock_);
+      if (results_.size() >= max_results) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      results_.push_back(std::move(r));
+      return true;
+    }
+
+    void run(const std::stop_token& stop)
+    {
+      while (true) {
+        std::shared_ptr<worker_state> w;
+        {
+          std::unique_lock lock(queue_lock_);
+          if (!queue_cv_.wait(lock, stop, [&] { return !queue_.empty(); })) return;
+          w = std::move(queue_.front());
+          queue_.pop_front();
+        }
+        process(w);
+      }
+    }
+
+    void process(const std::shared_ptr<worker_state>& w)
+    {
+      if (!w->terminated.load(std::memory_order_acquire)) {
+        // Port.post может быть вызван и из кода верхнего уровня скрипта при загрузке
+        current() = w;
+        if (!w->vm) load(w);
+        for (std::size_t i = 0; i < batch && !w->terminated.load(std::memory_order_acquire); ++i) {
+          std::string bytes;
+          {
+            std::scoped_lock lock(w->lock);
+            if (w->inbox.empty()) break;
+            bytes = std::move(w->inbox.front());
+            w->inbox.pop_front();
+          }
+          receive(w, bytes);
+        }
+        current().reset();
+      }
+
+      if (w->terminated.load(std::memory_order_acquire)) release(*w);
+
+      {
+        std::scoped_lock lock(w->lock);
+        w->scheduled = false;
+        // terminate() мог прийти после release выше: тогда VM уничтожит следующий проход
+        const bool terminated = w->terminated.load(std::memory_order_acquire);
+        if (terminated ? !w->vm : w->inbox.empty()) return;
+      }
+      // Остались сообщения — в конец очереди, чтобы не занимать поток одним воркером
+      schedule(w);
+    }
+
+    void load(const std::shared_ptr<worker_state>& w)
+    {
+      std::filesystem::path std_path;
+      std::filesystem::path workers_path;
+      {
+        std::scoped_lock lock(queue_lock_);
+        std_path = std_path_;
+        workers_path = workers_path_;
+      }
+
+      try {
+        w->vm = create_vm(w->name, std_path, workers_path);
+        w->vm->runFromModule(port::module_name);
+        w->vm->runFromFile(w->name, (workers_path / (w->name + ".wren")).string());
+
+        const auto vm = w->vm->getVm();
+        wrenEnsureSlots(vm, 1);
+        wrenGetVariable(vm, port::module_name, "Port", 0);
+        w->port_class = wrenGetSlotHandle(vm, 0);
+        w->receive_handle = wrenMakeCallHandle(vm, "receive_(_)");
+        logger::info("Worker: {} loaded", w->name);
+      }
+      catch (const std::exception& e) {
+        fail(w, std::string("load failed: ") + e.what());
+      }
+    }
+
+    void receive(const std::shared_ptr<worker_state>& w, const std::string& bytes)
+    {
+      tracing::zone zone(tracing::category::kDispatch, w->name);
+      const auto vm = w->vm->getVm();
+      wrenEnsureSlots(vm, 2);
+      wrenSetSlotHandle(vm, 0, w->port_class);
+      wrappers::storage::decode(vm, 1, bytes);
+      if (wrenCall(vm, w->receive_handle) != WREN_RESULT_SUCCESS) {
+        push_result({w, {}, wrenbind17::getLastError(vm)});
+      }
+      processed_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Ошибка загрузки: воркер останавливается, главная VM получает ошибку
+    void fail(const std::shared_ptr<worker_state>& w, std::string error)
+    {
+      logger::error("Worker: {} {}", w->name, error);
+      w->terminated.store(true, std::memory_order_release);
+      push_result({w, {}, std::move(error)});
+    }
+
+    static void release(worker_state& w)
+    {
+      if (w.vm) {
+        const auto vm = w.vm->getVm();
+        if (w.port_class) wrenReleaseHandle(vm, w.port_class);
+        if (w.receive_handle) wrenReleaseHandle(vm, w.receive_handle);
+      }
+      w.port_class = nullptr;
+      w.receive_handle = nullptr;
+      w.vm.reset();
+      std::scoped_lock lock(w.lock);
+      w.inbox.clear();
+    }
+
+    /**
+     * @brief VM воркера: только ядро Wren, Worker/Port из Std и скрипты из каталога воркеров.
+     */
+    static std::unique_ptr<wrenbind17::VM> create_vm(const std::string& name, const std::filesystem::path& std_path,
+                                                     const std::filesystem::path& workers_path)
+    {
+      auto vm = std::make_unique<wrenbind17::VM>(std::vector<std::string>{workers_path.string()});
+
+      vm->setPrintFunc([name](const char* text) {
+        if (text[0] == '\n' && text[1] == '\0') return;
+        SKSE::log::info("[Wren:{}] {}", name, text);
+      });
+
+      vm->setPathResolveFunc(
+        [](const std::vector<std::string>&, const std::string&, const std::string& module) -> std::string {
+          return module;
+        });
+
+      // Модули игры (Skyrim/..., Events, Storage) недоступны: их нет ни в одном из каталогов
+      vm->setLoadFileFunc([std_path, workers_path](const std::string& module) -> std::string {
+        const auto base = module.starts_with("Worker/") ? std_path : workers_path;
+        const auto path = base / (module + ".wren");
+        std::error_code ec;
+        if (module.find("..") == std::string::npos && std::filesystem::exists(path, ec)) {
+          std::ifstream t(path);
+          return std::string((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+        }
+        throw std::runtime_error("Module not found in worker: " + module);
+      });
+
+      port::bind(vm->module(port::module_name));
+      return vm;
+    }
+
+    std::mutex queue_lock_;
+    std::condition_variable_any queue_cv_;
+    std::deque<std::shared_ptr<worker_state>> queue_;
+    std::size_t thread_count_{2};
+    std::filesystem::path std_path_{"Data/SKSE/Plugins/WrenRim/Std"};
+    std::filesystem::path workers_path_{"Data/SKSE/Plugins/WrenRim/WrenMods/Workers"};
+
+    std::mutex results_lock_;
+    std::deque<result> results_;
+    std::atomic<std::uint64_t> processed_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+
+    // Только главный поток
+    std::vector<std::shared_ptr<worker_state>> workers_;
+    std::uint32_t last_id_{0};
+    std::uint32_t generation_{0};
+
+    // Последнее поле: потоки останавливаются до уничтожения очередей
+    std::vector<std::jthread> threads_;
+  };
+
+  inline auto port::post(const message_value& message) -> wrenbind17::Result<void>
+  {
+    if (!message.ok) {
+      return wrenbind17::scriptError("Port.post: message must be Num, Bool, String, Null or a List/Map of them");
+    }
+    if (!pool::post_result(message.bytes)) return wrenbind17::scriptError("Port.post: result queue is full");
+    return {};
+  }
+}
+
+namespace wrenbind17::detail
+{
+  template<>
+  struct PopHelper<wren::workers::message_value>
+  {
+    static wren::workers::message_value f(WrenVM* vm, const int idx)
+    {
+      wren::workers::message_value out;
+      out.ok = wren::wrappers::storage::encode_value(vm, idx, out.bytes, false);
+      return out;
+    }
+  };
+
+  template<>
+  struct PopHelper<const wren::workers::message_value&> : PopHelper<wren::workers::message_value>
+  {
+  };
+
+  // Поддерживаемость значения проверяется при кодировании, ошибку возвращает post
+  template<>
+  struct ArgCheck<wren::workers::message_value>
+  {
+    static constexpr bool exact = true;
+
+    static const char* f(WrenVM*, int) { return nullptr; }
+  };
+}
@@ -61,6 +61,7 @@ namespace wren::wrappers
     {
         if (is_valid()) {
             effect_->magnitude = value;
+            active_effect_index::get_singleton()->mark_stale(effect_->target);
         }
     }
 
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "pch.h"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Кеш сумм магнитуд активных эффектов актеров по ключевым словам базового эффекта.
+   * Для актера суммы по всем ключевым словам считаются одним обходом GetActiveEffectList
+   * при первом запросе в кадре, дальше запрос — поиск в таблице. Указатели на эффекты
+   * между запросами не хранятся, поэтому эффект, снятый в обход хуков, не оставляет
+   * висячих указателей.
+   * Хуки MagicTarget::EffectAdded / EffectRemoved и ActiveEffect.setMagnitude помечают запись
+   * актера устаревшей, так что добавление и снятие эффекта видны в том же кадре. Прочие
+   * изменения (флаг kInactive, магнитуда, измененная игрой) видны со следующего кадра.
+   * Записи актеров сбрасываются при выгрузке актера и при загрузке сохранения.
+   */
+  class active_effect_index
+  {
+  public:
+    static active_effect_index* get_singleton()
+    {
+      static active_effect_index singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Эффекты цели изменились: суммы будут пересчитаны при следующем запросе.
+     * Вызывается из хуков добавления и снятия эффекта и при изменении магнитуды из скрипта.
+     */
+    void mark_stale(RE::MagicTarget* target)
+    {
+      if (const auto entry = find(target)) entry->epoch = 0;
+    }
+
+    /**
+     * @brief Сумма магнитуд активных эффектов с ключевым словом.
+     * Вредные (kDetrimental) эффекты вычитаются, неактивные (kInactive) пропускаются,
+     * как в core::utility::get_magnitude_sum_of_active_effects.
+     * @param handle Хендл актера.
+     * @param a Актер (для пересчета сумм при первом запросе в кадре).
+     * @param keyword Ключевое слово базового эффекта.
+     */
+    float magnitude_sum(const RE::ActorHandle& handle, RE::Actor* a, const RE::BGSKeyword* keyword)
+    {
+      if (!a || !keyword) return 0.f;
+
+      const auto& entry = get_or_build(handle.native_handle(), a);
+      const auto it = entry.sums.find(keyword);
+      return it != entry.sums.end() ? it->second : 0.f;
+    }
+
+    /**
+     * @brief Сбрасывает запись актера (при выгрузке).
+     */
+    void invalidate(const RE::ActorHandle& handle)
+    {
+      actors_.erase(handle.native_handle());
+    }
+
+    /**
+     * @brief Начало кадра: суммы всех актеров будут пересчитаны при следующем запросе.
+     */
+    void on_frame_start() { ++epoch_; }
+
+    /**
+     * @brief Сбрасывает записи всех актеров (при загрузке сохранения).
+     */
+    void clear()
+    {
+      actors_.clear();
+    }
+
+  private:
+    struct actor_entry
+    {
+      std::unordered_map<const RE::BGSKeyword*, float> sums;
+      // Кадр, в котором суммы были посчитаны; 0 — устарели
+      uint32_t epoch{0};
+    };
+
+    active_effect_index() = default;
+
+    static void add(actor_entry& entry, const RE::ActiveEffect* effect)
+    {
+      if (!effect || !effect->effect || !effect->effect->baseEffect) return;
+      if (effect->flags.any(RE::ActiveEffect::Flag::kInactive)) return;
+
+      const auto base = effect->effect->baseEffect;
+      const auto magnitude =
+        base->data.flags.any(RE::EffectSetting::EffectSettingData::Flag::kDetrimental) ? -effect->GetMagnitude()
+                                                                                      : effect->GetMagnitude();
+      for (uint32_t i = 0; i < base->numKeywords; ++i) {
+        if (const auto keyword = base->keywords[i]) entry.sums[keyword] += magnitude;
+      }
+    }
+
+    // Запись есть только у актеров, для которых уже был запрос; остальные пропускаются
+    actor_entry* find(RE::MagicTarget* target)
+    {
+      if (!target || actors_.empty()) return nullptr;
+
+      const auto a = target->GetTargetAsActor();
+      if (!a) return nullptr;
+
+      const auto it = actors_.find(a->GetHandle().native_handle());
+      return it != actors_.end() ? &it->second : nullptr;
+    }
+
+    // Память таблицы сумм сохраняется между пересчетами
+    actor_entry& get_or_build(const uint32_t key, RE::Actor* a)
+    {
+      auto& entry = actors_[key];
+      if (entry.epoch == epoch_) return entry;
+
+      entry.epoch = epoch_;
+      entry.sums.clear();
+      if (const auto magic_target = a->AsMagicTarget()) {
+        if (const auto effects = magic_target->GetActiveEffectList()) {
+          for (const auto effect : *effects) add(entry, effect);
+        }
+      }
+      return entry;
+    }
+
+    std::unordered_map<uint32_t, actor_entry> actors_;
+    // Начинается с 1, чтобы новые и устаревшие записи (epoch 0) пересчитывались
+    uint32_t epoch_{1};
+  };
+}
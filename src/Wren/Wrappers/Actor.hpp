@@ -1,7 +1,12 @@
 #pragma once
 
 #include "pch.h"
+#include "Wren/Wrappers/ActiveEffectIndex.hpp"
+#include "Wren/Wrappers/ActorHandleCache.hpp"
+#include "Wren/Wrappers/ActorValueBuffer.hpp"
+#include "Wren/Wrappers/ActorValueTable.hpp"
 #include "Wren/Wrappers/Keyword.hpp"
+#include "Wren/Wrappers/KeywordBitsets.hpp"
 
 namespace wren::wrappers
 {
@@ -52,11 +57,21 @@ namespace wren::wrappers
 
     /**
      * @brief Получает указатель на RE::Actor.
-     * @return Указатель на RE::Actor или nullptr, если актер невалиден.
+     * Хендл разрешается не больше одного раза за кадр (см. actor_handle_cache).
+     * @return Указатель на RE::Actor или nullptr, если актер невалиден. Валиден до конца кадра.
      */
     [[nodiscard]] RE::Actor* get() const
     {
-      return handle_.get().get();
+      return actor_handle_cache::get_singleton()->resolve(handle_);
+    }
+
+    /**
+     * @brief Получает хендл актера.
+     * @return RE::ActorHandle (может быть пустым).
+     */
+    [[nodiscard]] RE::ActorHandle get_handle() const
+    {
+      return handle_;
     }
 
     /**
@@ -65,7 +80,7 @@ namespace wren::wrappers
      */
     [[nodiscard]] bool is_valid() const
     {
-      return static_cast<bool>(handle_);
+      return get() != nullptr;
     }
 
     /**
@@ -78,6 +93,28 @@ namespace wren::wrappers
       return ptr ? ptr->GetName() : "";
     }
 
+    /**
+     * @brief Получает позицию актера в мире.
+     * @return Массив [x, y, z] или пустой массив, если актер невалиден.
+     */
+    std::vector<float> get_position() const
+    {
+      auto ptr = get();
+      if (!ptr) return {};
+      const auto pos = ptr->GetPosition();
+      return {pos.x, pos.y, pos.z};
+    }
+
+    /**
+     * @brief Получает направление взгляда актера (поворот вокруг оси Z).
+     * @return Угол в радианах.
+     */
+    float get_heading() const
+    {
+      auto ptr = get();
+      return ptr ? ptr->GetAngleZ() : 0.f;
+    }
+
     /**
      * @brief Получает значение ActorValue по его числовому ID.
      * @param av_raw ID ActorValue (см. RE::ActorValue).
@@ -85,9 +122,10 @@ namespace wren::wrappers
      */
     auto get_actor_value_by_enum(const uint32_t av_raw) const -> float
     {
-      if (!is_valid()) return 0.f;
+      const auto ptr = get();
+      if (!ptr) return 0.f;
 
-      const auto owner = get()->AsActorValueOwner();
+      const auto owner = ptr->AsActorValueOwner();
       if (!owner) return 0.f;
 
       const auto av = static_cast<RE::ActorValue>(av_raw);
@@ -100,14 +138,15 @@ namespace wren::wrappers
      * @param str_av Имя ActorValue (например, "Health").
      * @return Значение ActorValue.
      */
-    auto get_actor_value_by_string(const std::string& str_av) const -> float
+    auto get_actor_value_by_string(std::string_view str_av) const -> float
     {
-      if (!is_valid()) return 0.f;
+      const auto ptr = get();
+      if (!ptr) return 0.f;
 
-      const auto owner = get()->AsActorValueOwner();
+      const auto owner = ptr->AsActorValueOwner();
       if (!owner) return 0.f;
 
-      const auto av = RE::ActorValueList::LookupActorValueByName(str_av.c_str());
+      const auto av = actor_value_table::get_singleton()->lookup(str_av);
 
       if (av == RE::ActorValue::kNone) return 0.f;
 
@@ -121,9 +160,10 @@ namespace wren::wrappers
      */
     auto mod_actor_value_by_enum(const uint32_t av_raw, const float value) const -> void
     {
-      if (!is_valid()) return;
+      const auto ptr = get();
+      if (!ptr) return;
 
-      const auto owner = get()->AsActorValueOwner();
+      const auto owner = ptr->AsActorValueOwner();
       if (!owner) return;
 
       const auto av = static_cast<RE::ActorValue>(av_raw);
@@ -136,14 +176,15 @@ namespace wren::wrappers
      * @param str_av Имя ActorValue.
      * @param value Значение, на которое нужно изменить.
      */
-    auto mod_actor_value_by_string(const std::string& str_av, const float value) const -> void
+    auto mod_actor_value_by_string(std::string_view str_av, const float value) const -> void
     {
-      if (!is_valid()) return;
+      const auto ptr = get();
+      if (!ptr) return;
 
-      const auto owner = get()->AsActorValueOwner();
+      const auto owner = ptr->AsActorValueOwner();
       if (!owner) return;
 
-      const auto av = RE::ActorValueList::LookupActorValueByName(str_av.c_str());
+      const auto av = actor_value_table::get_singleton()->lookup(str_av);
 
       return owner->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, av, value);
     }
@@ -155,9 +196,10 @@ namespace wren::wrappers
      */
     auto restore_actor_value_by_enum(const uint32_t av_raw, const float value) const -> void
     {
-      if (!is_valid()) return;
+      const auto ptr = get();
+      if (!ptr) return;
 
-      const auto owner = get()->AsActorValueOwner();
+      const auto owner = ptr->AsActorValueOwner();
       if (!owner) return;
 
       const auto av = static_cast<RE::ActorValue>(av_raw);
@@ -170,14 +212,15 @@ namespace wren::wrappers
      * @param str_av Имя ActorValue.
      * @param value Значение для восстановления.
      */
-    auto restore_actor_value_by_string(const std::string& str_av, const float value) const -> void
+    auto restore_actor_value_by_string(std::string_view str_av, const float value) const -> void
     {
-      if (!is_valid()) return;
+      const auto ptr = get();
+      if (!ptr) return;
 
-      const auto owner = get()->AsActorValueOwner();
+      const auto owner = ptr->AsActorValueOwner();
       if (!owner) return;
 
-      const auto av = RE::ActorValueList::LookupActorValueByName(str_av.c_str());
+      const auto av = actor_value_table::get_singleton()->lookup(str_av);
 
       return owner->RestoreActorValue(av, value);
     }
@@ -189,9 +232,10 @@ namespace wren::wrappers
      */
     auto damage_actor_value_by_enum(const uint32_t av_raw, const float value) const -> void
     {
-      if (!is_valid()) return;
+      const auto ptr = get();
+      if (!ptr) return;
 
-      const auto owner = get()->AsActorValueOwner();
+      const auto owner = ptr->AsActorValueOwner();
       if (!owner) return;
 
       const auto av = static_cast<RE::ActorValue>(av_raw);
@@ -204,18 +248,132 @@ namespace wren::wrappers
      * @param str_av Имя ActorValue.
      * @param value Значение урона.
      */
-    auto damage_actor_value_by_string(const std::string& str_av, const float value) const -> void
+    auto damage_actor_value_by_string(std::string_view str_av, const float value) const -> void
     {
-      if (!is_valid()) return;
+      const auto ptr = get();
+      if (!ptr) return;
 
-      const auto owner = get()->AsActorValueOwner();
+      const auto owner = ptr->AsActorValueOwner();
       if (!owner) return;
 
-      const auto av = RE::ActorValueList::LookupActorValueByName(str_av.c_str());
+      const auto av = actor_value_table::get_singleton()->lookup(str_av);
 
       return owner->DamageActorValue(av, value);
     }
 
+    /**
+     * @brief Проверяет ID ActorValue из Wren: целое число в [0, kTotal).
+     */
+    static bool is_actor_value_id(const double id)
+    {
+      return id >= 0 && id < std::to_underlying(RE::ActorValue::kTotal) && id == std::floor(id);
+    }
+
+    /**
+     * @brief Получает несколько ActorValue за один вызов.
+     * @param ids ID ActorValue, целые числа в [0, kTotal).
+     * @return Значения в том же порядке (0 для невалидного актера) или ошибка скрипта для неверного ID.
+     */
+    auto get_actor_values(const std::vector<double>& ids) const -> wrenbind17::Result<std::vector<float>>
+    {
+      if (!std::ranges::all_of(ids, is_actor_value_id)) {
+        return wrenbind17::scriptError("getActorValues: ids must be valid ActorValue ids");
+      }
+
+      std::vector<float> values(ids.size(), 0.f);
+
+      const auto ptr = get();
+      if (!ptr) return values;
+
+      const auto owner = ptr->AsActorValueOwner();
+      if (!owner) return values;
+
+      for (std::size_t i = 0; i < ids.size(); ++i) {
+        values[i] = owner->GetActorValue(static_cast<RE::ActorValue>(ids[i]));
+      }
+      return values;
+    }
+
+    /**
+     * @brief Заполняет буфер значениями ActorValue за один вызов, без создания нового списка.
+     * @param buffer Буфер с ID ActorValue.
+     * @return true, если актер валиден и значения прочитаны.
+     */
+    bool read_actor_values(actor_value_buffer& buffer) const
+    {
+      const auto& ids = buffer.ids();
+      auto& values = buffer.values();
+      std::ranges::fill(values, 0.f);
+
+      const auto ptr = get();
+      if (!ptr) return false;
+
+      const auto owner = ptr->AsActorValueOwner();
+      if (!owner) return false;
+
+      for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (ids[i] < std::to_underlying(RE::ActorValue::kTotal)) {
+          values[i] = owner->GetActorValue(static_cast<RE::ActorValue>(ids[i]));
+        }
+      }
+      return true;
+    }
+
+    /**
+     * @brief Применяет изменения к нескольким ActorValue за один вызов.
+     * @param ids ID ActorValue, целые числа в [0, kTotal).
+     * @param deltas Изменения, по одному на ID.
+     * @param modifier_kinds Модификаторы RE::ACTOR_VALUE_MODIFIER по одному на ID:
+     * 0 = Permanent (как modActorValue), 1 = Temporary, 2 = Damage (отрицательное значение наносит
+     * урон, положительное восстанавливает). Пустой список означает Permanent для всех.
+     */
+    auto apply_actor_value_deltas(const std::vector<double>& ids,
+                                  const std::vector<float>& deltas,
+                                  const std::vector<double>& modifier_kinds) const -> wrenbind17::Result<void>
+    {
+      if (deltas.size() != ids.size()) {
+        return wrenbind17::scriptError("applyActorValueDeltas: ids and deltas must have the same length");
+      }
+      if (!modifier_kinds.empty() && modifier_kinds.size() != ids.size()) {
+        return wrenbind17::scriptError("applyActorValueDeltas: modifierKinds must be empty or match ids");
+      }
+      // Проверка до применения: неверный ID не оставляет изменения примененными наполовину
+      if (!std::ranges::all_of(ids, is_actor_value_id)) {
+        return wrenbind17::scriptError("applyActorValueDeltas: ids must be valid ActorValue ids");
+      }
+      const auto valid_kind = [](const double kind) {
+        return kind >= 0 && kind <= std::to_underlying(RE::ACTOR_VALUE_MODIFIER::kDamage) && kind == std::floor(kind);
+      };
+      if (!std::ranges::all_of(modifier_kinds, valid_kind)) {
+        return wrenbind17::scriptError("applyActorValueDeltas: unknown modifier kind");
+      }
+
+      const auto ptr = get();
+      if (!ptr) return {};
+
+      const auto owner = ptr->AsActorValueOwner();
+      if (!owner) return {};
+
+      for (std::size_t i = 0; i < ids.size(); ++i) {
+        const auto av = static_cast<RE::ActorValue>(ids[i]);
+        const auto kind = modifier_kinds.empty() ? 0 : static_cast<uint32_t>(modifier_kinds[i]);
+        switch (kind) {
+        case std::to_underlying(RE::ACTOR_VALUE_MODIFIER::kPermanent):
+          owner->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, av, deltas[i]);
+          break;
+        case std::to_underlying(RE::ACTOR_VALUE_MODIFIER::kTemporary):
+          owner->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kTemporary, av, deltas[i]);
+          break;
+        case std::to_underlying(RE::ACTOR_VALUE_MODIFIER::kDamage):
+          owner->RestoreActorValue(RE::ACTOR_VALUE_MODIFIER::kDamage, av, deltas[i]);
+          break;
+        default:
+          return wrenbind17::scriptError("applyActorValueDeltas: unknown modifier kind");
+        }
+      }
+      return {};
+    }
+
     /**
      * @brief Проверяет наличие ключевого слова (Keyword) у актера.
      * @param kw Объект keyword.
@@ -226,7 +384,7 @@ namespace wren::wrappers
         auto ptr = get();
         auto kw_ptr = kw.get();
         if (ptr && kw_ptr) {
-            return ptr->HasKeyword(kw_ptr);
+            return keyword_bitsets::get_singleton()->has({ptr->GetActorBase(), ptr->GetRace()}, kw_ptr);
         }
         return false;
     }
@@ -236,15 +394,54 @@ namespace wren::wrappers
      * @param editor_id EditorID ключевого слова.
      * @return true, если ключевое слово есть.
      */
-    bool has_keyword_string(const std::string& editor_id) const
+    bool has_keyword_string(std::string_view editor_id) const
     {
         auto ptr = get();
         if (ptr) {
+            // Индекс форм дает BGSKeyword за O(1), дальше сравнение указателей вместо строк
+            if (const auto kw = core::forms::form_index::get_singleton()->by_editor_id<RE::BGSKeyword>(editor_id)) {
+                return keyword_bitsets::get_singleton()->has({ptr->GetActorBase(), ptr->GetRace()}, kw);
+            }
             return ptr->HasKeywordString(editor_id);
         }
         return false;
     }
 
+    /**
+     * @brief Формы с ключевыми словами актера для keyword_queries: NPC и раса.
+     */
+    [[nodiscard]] keyword_bitsets::sources keyword_sources() const
+    {
+        const auto ptr = get();
+        return {ptr ? ptr->GetActorBase() : nullptr, ptr ? ptr->GetRace() : nullptr};
+    }
+
+    /**
+     * @brief Сумма магнитуд активных эффектов с ключевым словом (вредные эффекты вычитаются).
+     * Берется из кеша сумм active_effect_index, список эффектов обходится не чаще раза за кадр.
+     * @param kw Ключевое слово базового эффекта.
+     * @return Сумма магнитуд или 0.
+     */
+    float effect_magnitude_sum(const keyword& kw) const
+    {
+        auto ptr = get();
+        auto kw_ptr = kw.get();
+        if (ptr && kw_ptr) {
+            return active_effect_index::get_singleton()->magnitude_sum(handle_, ptr, kw_ptr);
+        }
+        return 0.f;
+    }
+
+    /**
+     * @brief Получает числовой ID ActorValue по его имени.
+     * @param name Имя ActorValue (например, "Health"), без учета регистра.
+     * @return ID ActorValue или -1, если имя не найдено.
+     */
+    static int32_t lookup_actor_value(std::string_view name)
+    {
+      return static_cast<int32_t>(actor_value_table::get_singleton()->lookup(name));
+    }
+
     static void bind(wrenbind17::ForeignModule& module)
     {
       auto& cls = module.klass<actor>("Actor");
@@ -252,6 +449,8 @@ namespace wren::wrappers
       cls.ctor<const RE::FormID>();
       cls.func<&actor::get_name>("getName");
       cls.func<&actor::is_valid>("isValid");
+      cls.func<&actor::get_position>("getPosition");
+      cls.func<&actor::get_heading>("getHeading");
       cls.func<&actor::get_actor_value_by_enum>("getActorValueByEnum");
       cls.func<&actor::get_actor_value_by_string>("getActorValueByString");
       cls.func<&actor::mod_actor_value_by_enum>("modActorValueByEnum");
@@ -260,11 +459,36 @@ namespace wren::wrappers
       cls.func<&actor::restore_actor_value_by_string>("restoreActorValueByString");
       cls.func<&actor::damage_actor_value_by_enum>("damageActorValueByEnum");
       cls.func<&actor::damage_actor_value_by_string>("damageActorValueByString");
+      cls.func<&actor::get_actor_values>("getActorValues");
+      cls.func<&actor::read_actor_values>("readActorValues");
+      cls.func<&actor::apply_actor_value_deltas>("applyActorValueDeltas");
       cls.func<&actor::has_keyword>("hasKeyword");
       cls.func<&actor::has_keyword_string>("hasKeywordString");
+      keyword_queries<actor>::bind(cls);
+      cls.func<&actor::effect_magnitude_sum>("effectMagnitudeSum");
+      cls.funcStatic<&actor::lookup_actor_value>("lookupActorValue");
     }
 
   private:
     RE::ActorHandle handle_;
   };
 }
+
+namespace wrenbind17
+{
+  // RE::ActorHandle is a 32-bit handle value, store actor inline in the Wren object
+  template<>
+  struct ForeignInline<wren::wrappers::actor> : std::true_type
+  {
+  };
+
+  // One Wren object per live actor handle, scripts can compare actors with == and use them as Map keys
+  template<>
+  struct ForeignIdentity<wren::wrappers::actor> : std::true_type
+  {
+    static std::uint64_t key(const wren::wrappers::actor& a)
+    {
+      return a.get_handle().native_handle();
+    }
+  };
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "pch.h"
+#include "Wren/Wrappers/Actor.hpp"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Массив актеров для результатов пространственных запросов.
+   * Каждый запрос возвращает свой массив (вложенные запросы не портят внешний результат),
+   * массивы берутся из пула: когда Wren освобождает массив, он и его память переиспользуются
+   * следующим запросом, поэтому повторные запросы каждый кадр не выделяют память.
+   */
+  class actor_array
+  {
+  public:
+    // Массивов в пуле; если все заняты, запрос создает массив вне пула
+    static constexpr std::size_t max_pooled = 64;
+
+    /**
+     * @brief Массив для результата запроса: свободный из пула или новый. Только главный поток.
+     */
+    static std::shared_ptr<actor_array> acquire()
+    {
+      static std::vector<std::shared_ptr<actor_array>> pool;
+      // use_count() == 1 — массив держит только пул, объект Wren уже собран
+      for (const auto& a : pool) {
+        if (a.use_count() == 1) {
+          a->clear();
+          return a;
+        }
+      }
+      auto a = std::make_shared<actor_array>();
+      if (pool.size() < max_pooled) pool.push_back(a);
+      return a;
+    }
+
+    /**
+     * @brief Количество актеров в массиве.
+     */
+    [[nodiscard]] std::size_t get_count() const
+    {
+      return actors_.size();
+    }
+
+    /**
+     * @brief Получает актера по индексу.
+     * @param index Индекс.
+     * @return Актер или невалидный актер, если индекс вне диапазона.
+     */
+    [[nodiscard]] actor get(const std::size_t index) const
+    {
+      return index < actors_.size() ? actors_[index] : actor();
+    }
+
+    /**
+     * @brief Копирует актеров в новый список.
+     */
+    [[nodiscard]] const std::vector<actor>& to_list() const
+    {
+      return actors_;
+    }
+
+    void clear() { actors_.clear(); }
+    void push_back(const actor& a) { actors_.push_back(a); }
+
+    static void bind(wrenbind17::ForeignModule& module)
+    {
+      auto& cls = module.klass<actor_array>("ActorArray");
+      cls.ctor<>();
+      cls.func<&actor_array::get_count>("getCount");
+      cls.func<&actor_array::get>("get");
+      cls.func<&actor_array::to_list>("toList");
+    }
+
+  private:
+    std::vector<actor> actors_;
+  };
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "pch.h"
+#include <numbers>
+#include "Wren/Wrappers/ActorArray.hpp"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Флаги фильтра для пространственных запросов (битовая маска).
+   */
+  enum class actor_filter : uint32_t
+  {
+    kNone = 0,
+    kAlive = 1 << 0,         // Только живые
+    kHostile = 1 << 1,       // Только враждебные игроку
+    kExcludePlayer = 1 << 2, // Без игрока
+    kInCombat = 1 << 3,      // Только в бою
+  };
+
+  /**
+   * @brief Равномерная сетка загруженных актеров для запросов по радиусу и конусу.
+   * Обновляется инкрементально из хука обновления персонажа: актер перемещается между
+   * ячейками только при смене ячейки. Актеры, которые давно не обновлялись
+   * (выгружены или удалены), удаляются из сетки при периодической очистке.
+   * Сетка двумерная (X/Y), высота учитывается только при проверке расстояния.
+   */
+  class actor_grid
+  {
+  public:
+    static actor_grid* get_singleton()
+    {
+      static actor_grid singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Обновляет позицию актера в сетке. Вызывается из хука обновления персонажа.
+     * @param a Актер.
+     */
+    void update(RE::Actor* a)
+    {
+      if (!a) return;
+
+      const auto pos = a->GetPosition();
+      const auto cell = cell_of(pos.x, pos.y);
+
+      auto [it, inserted] = slots_by_actor_.try_emplace(a, 0);
+      if (inserted) {
+        it->second = allocate({a, a->GetHandle(), a->GetFormID(), pos, cell, frame_});
+        cells_[cell].push_back(it->second);
+        return;
+      }
+
+      auto& e = entries_[it->second];
+      if (e.form_id != a->GetFormID()) {
+        // Память удаленного актера занята новым, старый хендл больше не подходит
+        e.handle = a->GetHandle();
+        e.form_id = a->GetFormID();
+      }
+      e.position = pos;
+      e.last_seen = frame_;
+      if (e.cell != cell) {
+        remove_from_cell(e.cell, it->second);
+        e.cell = cell;
+        cells_[cell].push_back(it->second);
+      }
+    }
+
+    /**
+     * @brief Удаляет актера из сетки (при выгрузке).
+     * @param a Актер.
+     */
+    void remove(const RE::Actor* a)
+    {
+      const auto it = slots_by_actor_.find(a);
+      if (it == slots_by_actor_.end()) return;
+
+      const auto slot = it->second;
+      remove_from_cell(entries_[slot].cell, slot);
+      entries_[slot] = {};
+      free_.push_back(slot);
+      slots_by_actor_.erase(it);
+    }
+
+    /**
+     * @brief Начало кадра: периодически удаляет актеров, которые перестали обновляться.
+     */
+    void on_frame_start()
+    {
+      if (++frame_ % sweep_interval != 0) return;
+
+      for (uint32_t i = 0; i < entries_.size(); ++i) {
+        auto& e = entries_[i];
+        if (!e.actor || frame_ - e.last_seen <= stale_frames) continue;
+        remove_from_cell(e.cell, i);
+        slots_by_actor_.erase(e.actor);
+        e = {};
+        free_.push_back(i);
+      }
+    }
+
+    /**
+     * @brief Ищет актеров в сфере.
+     * @param out Массив результатов (очищается).
+     * @param center Центр.
+     * @param radius Радиус.
+     * @param filter Маска actor_filter.
+     */
+    void query_radius(actor_array& out, const RE::NiPoint3& center, const float radius, const uint32_t filter)
+    {
+      out.clear();
+      if (radius < 0.f) return;
+
+      const auto radius_sq = radius * radius;
+      for_each_in_range(center, radius, [&](const entry& e) {
+        if ((e.position - center).SqrLength() <= radius_sq) accept(out, e, filter);
+      });
+    }
+
+    /**
+     * @brief Ищет актеров в конусе.
+     * @param out Массив результатов (очищается).
+     * @param origin Вершина конуса.
+     * @param direction Направление оси конуса (нормализуется).
+     * @param half_angle_deg Половина угла раствора в градусах.
+     * @param range Длина конуса.
+     * @param filter Маска actor_filter.
+     */
+    void query_cone(actor_array& out, const RE::NiPoint3& origin, RE::NiPoint3 direction,
+                    const float half_angle_deg, const float range, const uint32_t filter)
+    {
+      out.clear();
+      if (range < 0.f) return;
+
+      const auto length = direction.Length();
+      if (length <= 0.f) return;
+      direction /= length;
+
+      const auto range_sq = range * range;
+      const auto cos_half = std::cos(std::clamp(half_angle_deg, 0.f, 180.f) * std::numbers::pi_v<float> / 180.f);
+      for_each_in_range(origin, range, [&](const entry& e) {
+        const auto v = e.position - origin;
+        const auto dist_sq = v.SqrLength();
+        if (dist_sq > range_sq) return;
+        if (dist_sq > 0.f && v.Dot(direction) < cos_half * std::sqrt(dist_sq)) return;
+        accept(out, e, filter);
+      });
+    }
+
+    /**
+     * @brief Количество актеров в сетке.
+     */
+    [[nodiscard]] std::size_t size() const { return slots_by_actor_.size(); }
+
+  private:
+    struct entry
+    {
+      RE::Actor* actor{nullptr};
+      RE::ActorHandle handle;
+      RE::FormID form_id{0};
+      RE::NiPoint3 position;
+      uint64_t cell{0};
+      uint64_t last_seen{0};
+    };
+
+    actor_grid() = default;
+
+    static int32_t cell_coord(const float v)
+    {
+      return static_cast<int32_t>(std::clamp(std::floor(v / cell_size), -1e9f, 1e9f));
+    }
+
+    static uint64_t cell_key(const int32_t x, const int32_t y)
+    {
+      return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    static uint64_t cell_of(const float x, const float y)
+    {
+      return cell_key(cell_coord(x), cell_coord(y));
+    }
+
+    uint32_t allocate(const entry& e)
+    {
+      if (!free_.empty()) {
+        const auto slot = free_.back();
+        free_.pop_back();
+        entries_[slot] = e;
+        return slot;
+      }
+      entries_.push_back(e);
+      return static_cast<uint32_t>(entries_.size() - 1);
+    }
+
+    void remove_from_cell(const uint64_t cell, const uint32_t slot)
+    {
+      const auto it = cells_.find(cell);
+      if (it == cells_.end()) return;
+
+      auto& slots = it->second;
+      if (const auto pos = std::ranges::find(slots, slot); pos != slots.end()) {
+        *pos = slots.back();
+        slots.pop_back();
+      }
+      if (slots.empty()) cells_.erase(it);
+    }
+
+    template<typename Fn>
+    void for_each_in_range(const RE::NiPoint3& center, const float range, Fn&& fn) const
+    {
+      const auto min_x = cell_coord(center.x - range);
+      const auto max_x = cell_coord(center.x + range);
+      const auto min_y = cell_coord(center.y - range);
+      const auto max_y = cell_coord(center.y + range);
+
+      // Для больших радиусов дешевле обойти только занятые ячейки
+      const auto span = static_cast<uint64_t>(int64_t{max_x} - min_x + 1) * static_cast<uint64_t>(int64_t{max_y} - min_y + 1);
+      if (span > cells_.size()) {
+        for (const auto& [cell, slots] : cells_) {
+          const auto x = static_cast<int32_t>(static_cast<uint32_t>(cell >> 32));
+          const auto y = static_cast<int32_t>(static_cast<uint32_t>(cell));
+          if (x < min_x || x > max_x || y < min_y || y > max_y) continue;
+          for (const auto slot : slots) fn(entries_[slot]);
+        }
+        return;
+      }
+
+      for (auto x = min_x; x <= max_x; ++x) {
+        for (auto y = min_y; y <= max_y; ++y) {
+          const auto it = cells_.find(cell_key(x, y));
+          if (it == cells_.end()) continue;
+          for (const auto slot : it->second) fn(entries_[slot]);
+        }
+      }
+    }
+
+    static void accept(actor_array& out, const entry& e, const uint32_t filter)
+    {
+      // Указатель мог быть переиспользован после удаления актера, проверяем через хендл
+      const auto ptr = e.handle.get();
+      if (!ptr || ptr.get() != e.actor || ptr->IsDeleted()) return;
+
+      if ((filter & std::to_underlying(actor_filter::kAlive)) && ptr->IsDead()) return;
+      if ((filter & std::to_underlying(actor_filter::kExcludePlayer)) && ptr->IsPlayerRef()) return;
+      if ((filter & std::to_underlying(actor_filter::kInCombat)) && !ptr->IsInCombat()) return;
+      if (filter & std::to_underlying(actor_filter::kHostile)) {
+        const auto player = RE::PlayerCharacter::GetSingleton();
+        if (!player || !ptr->IsHostileToActor(player)) return;
+      }
+
+      out.push_back(actor(e.handle));
+    }
+
+    static constexpr float cell_size = 1024.f;
+    static constexpr uint64_t sweep_interval = 60;
+    static constexpr uint64_t stale_frames = 300;
+
+    std::vector<entry> entries_;
+    std::vector<uint32_t> free_;
+    std::unordered_map<const RE::Actor*, uint32_t> slots_by_actor_;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;
+    uint64_t frame_{0};
+  };
+}
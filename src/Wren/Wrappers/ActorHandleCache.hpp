@@ -0,0 +1,135 @@
+#pragma once
+
+#include "pch.h"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Кеш разрешения RE::ActorHandle в пределах одного кадра.
+   * Разрешение хендла блокирует глобальную таблицу хендлов, поэтому каждый хендл
+   * разрешается не больше одного раза за кадр, дальше указатель берется из кеша.
+   * Кеш держит NiPointer, так что актер не может быть удален до конца кадра.
+   * Сбрасывается в engine::on_frame_start и при смене сессии, отдельные записи — при выгрузке актера.
+   */
+  class actor_handle_cache
+  {
+  public:
+    static actor_handle_cache* get_singleton()
+    {
+      static actor_handle_cache singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Разрешает хендл актера через кеш.
+     * @param handle Хендл актера.
+     * @return Указатель на актера или nullptr. Валиден до конца кадра.
+     */
+    RE::Actor* resolve(const RE::ActorHandle& handle)
+    {
+      const auto key = handle.native_handle();
+      if (!key) return nullptr;
+
+      if ((used_.size() + 1) * 2 > slots_.size()) grow();
+
+      const auto mask = slots_.size() - 1;
+      for (auto i = hash(key) & mask;; i = (i + 1) & mask) {
+        auto& slot = slots_[i];
+        if (slot.epoch != epoch_) {
+          slot = {key, epoch_, true, handle.get()};
+          used_.push_back(static_cast<uint32_t>(i));
+          return slot.actor.get();
+        }
+        if (slot.key == key) {
+          if (!slot.resolved) {
+            slot.actor = handle.get();
+            slot.resolved = true;
+          }
+          return slot.actor.get();
+        }
+      }
+    }
+
+    /**
+     * @brief Сбрасывает запись хендла, следующий resolve снова обратится к таблице хендлов.
+     * @param handle Хендл актера.
+     */
+    void invalidate(const RE::ActorHandle& handle)
+    {
+      const auto key = handle.native_handle();
+      if (!key || slots_.empty()) return;
+
+      const auto mask = slots_.size() - 1;
+      for (auto i = hash(key) & mask;; i = (i + 1) & mask) {
+        auto& slot = slots_[i];
+        if (slot.epoch != epoch_) return;
+        if (slot.key == key) {
+          slot.actor.reset();
+          slot.resolved = false;
+          return;
+        }
+      }
+    }
+
+    /**
+     * @brief Начало кадра: сбрасывает все записи и отпускает удерживаемых актеров.
+     */
+    void on_frame_start()
+    {
+      for (const auto i : used_) {
+        slots_[i].actor.reset();
+      }
+      used_.clear();
+      ++epoch_;
+    }
+
+    /**
+     * @brief Смена сессии: хендлы прошлой игры больше не действительны.
+     */
+    void clear() { on_frame_start(); }
+
+  private:
+    struct slot
+    {
+      uint32_t key{0};
+      uint32_t epoch{0};
+      bool resolved{false};
+      RE::NiPointer<RE::Actor> actor;
+    };
+
+    actor_handle_cache() { slots_.resize(initial_capacity); }
+
+    static uint32_t hash(uint32_t key)
+    {
+      key ^= key >> 16;
+      key *= 0x7feb352du;
+      key ^= key >> 15;
+      return key;
+    }
+
+    // Перенос записей текущего кадра в таблицу вдвое больше
+    void grow()
+    {
+      std::vector<slot> old = std::move(slots_);
+      slots_.clear();
+      slots_.resize(old.size() * 2);
+      used_.clear();
+
+      const auto mask = slots_.size() - 1;
+      for (auto& s : old) {
+        if (s.epoch != epoch_) continue;
+        auto i = hash(s.key) & mask;
+        while (slots_[i].epoch == epoch_) i = (i + 1) & mask;
+        slots_[i] = std::move(s);
+        used_.push_back(static_cast<uint32_t>(i));
+      }
+    }
+
+    static constexpr std::size_t initial_capacity = 256;
+
+    std::vector<slot> slots_;
+    std::vector<uint32_t> used_;
+    // Начинается с 1, чтобы пустые слоты (epoch 0) не считались занятыми
+    uint32_t epoch_{1};
+  };
+}
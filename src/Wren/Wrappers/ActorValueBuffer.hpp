@@ -0,0 +1,150 @@
+#pragma once
+
+#include "pch.h"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Список Wren, переданный в foreign-метод: слот, из которого метод пишет в него напрямую.
+   * Действителен только во время вызова.
+   */
+  struct list_slot
+  {
+    WrenVM* vm{nullptr};
+    int slot{0};
+  };
+
+  /**
+   * @brief Переиспользуемый буфер для пакетного чтения ActorValue.
+   * Список ID задается один раз при создании, actor::read_actor_values заполняет значения
+   * на месте, без создания нового списка Wren на каждый вызов.
+   */
+  class actor_value_buffer
+  {
+  public:
+    /**
+     * @brief Конструктор из списка ID ActorValue.
+     * @param ids ID ActorValue (см. RE::ActorValue). Нецелые и вне [0, kTotal) заменяются на kNone:
+     * их значение всегда 0, getId возвращает -1.
+     */
+    actor_value_buffer(const std::vector<double>& ids) : values_(ids.size(), 0.f)
+    {
+      ids_.reserve(ids.size());
+      for (const auto id : ids) {
+        if (id >= 0 && id < std::to_underlying(RE::ActorValue::kTotal) && id == std::floor(id)) {
+          ids_.push_back(static_cast<uint32_t>(id));
+          continue;
+        }
+        logger::warn("ActorValueBuffer: invalid ActorValue id {}", id);
+        ids_.push_back(invalid_id);
+      }
+    }
+
+    /**
+     * @brief Конструктор по умолчанию. Создает пустой буфер.
+     */
+    actor_value_buffer() = default;
+
+    /**
+     * @brief Количество значений в буфере.
+     */
+    [[nodiscard]] std::size_t get_count() const
+    {
+      return values_.size();
+    }
+
+    /**
+     * @brief Получает значение по индексу (в порядке ID, переданных при создании).
+     * @param index Индекс значения.
+     * @return Значение или 0, если индекс вне диапазона.
+     */
+    [[nodiscard]] float get_value(const std::size_t index) const
+    {
+      return index < values_.size() ? values_[index] : 0.f;
+    }
+
+    /**
+     * @brief Получает ID ActorValue по индексу.
+     * @param index Индекс значения.
+     * @return ID ActorValue или -1, если индекс вне диапазона.
+     */
+    [[nodiscard]] int32_t get_id(const std::size_t index) const
+    {
+      return index < ids_.size() && ids_[index] != invalid_id ? static_cast<int32_t>(ids_[index]) : -1;
+    }
+
+    /**
+     * @brief Копирует значения в новый список.
+     */
+    [[nodiscard]] const std::vector<float>& to_list() const
+    {
+      return values_;
+    }
+
+    /**
+     * @brief Записывает значения в список вызывающего за один вызов, без создания нового списка.
+     * Первые getCount() элементов перезаписываются, недостающие добавляются в конец,
+     * лишние элементы списка не меняются.
+     * @param list Список Wren.
+     */
+    void fill(const list_slot& list) const
+    {
+      const auto vm = list.vm;
+      const auto element = list.slot + 1;
+      wrenEnsureSlots(vm, element + 1);
+      const auto count = static_cast<std::size_t>(wrenGetListCount(vm, list.slot));
+      for (std::size_t i = 0; i < values_.size(); ++i) {
+        wrenSetSlotDouble(vm, element, values_[i]);
+        if (i < count) wrenSetListElement(vm, list.slot, static_cast<int>(i), element);
+        else wrenInsertInList(vm, list.slot, -1, element);
+      }
+    }
+
+    [[nodiscard]] const std::vector<uint32_t>& ids() const { return ids_; }
+    [[nodiscard]] std::vector<float>& values() { return values_; }
+
+    static void bind(wrenbind17::ForeignModule& module)
+    {
+      auto& cls = module.klass<actor_value_buffer>("ActorValueBuffer");
+      cls.ctor<const std::vector<double>&>();
+      cls.func<&actor_value_buffer::get_count>("getCount");
+      cls.func<&actor_value_buffer::get_value>("getValue");
+      cls.func<&actor_value_buffer::get_id>("getId");
+      cls.func<&actor_value_buffer::to_list>("toList");
+      cls.func<&actor_value_buffer::fill>("fill");
+    }
+
+  private:
+    static constexpr uint32_t invalid_id = static_cast<uint32_t>(RE::ActorValue::kNone);
+
+    std::vector<uint32_t> ids_;
+    std::vector<float> values_;
+  };
+}
+
+namespace wrenbind17::detail
+{
+  template<>
+  struct PopHelper<wren::wrappers::list_slot>
+  {
+    // Проверка та же, что в ArgCheck: без WRENBIND17_NO_EXCEPTIONS ArgCheck не вызывается
+    static wren::wrappers::list_slot f(WrenVM* vm, const int idx)
+    {
+      validate<WrenType::WREN_TYPE_LIST>(vm, idx);
+      return {vm, idx};
+    }
+  };
+
+  template<>
+  struct PopHelper<const wren::wrappers::list_slot&> : PopHelper<wren::wrappers::list_slot>
+  {
+  };
+
+  template<>
+  struct ArgCheck<wren::wrappers::list_slot>
+  {
+    static constexpr bool exact = true;
+
+    static const char* f(WrenVM* vm, const int idx) { return checkSlotType(vm, idx, WrenType::WREN_TYPE_LIST); }
+  };
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "pch.h"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Таблица имен ActorValue с идеальным хешированием.
+   * Строится один раз из RE::ActorValueList (после загрузки данных) и заменяет
+   * линейный поиск RE::ActorValueList::LookupActorValueByName.
+   * Поиск регистронезависимый, как и в движке.
+   */
+  class actor_value_table
+  {
+  public:
+    /**
+     * @brief Возвращает таблицу, при первом обращении строит ее.
+     */
+    static actor_value_table* get_singleton()
+    {
+      static actor_value_table singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Ищет ActorValue по имени.
+     * @param name Имя ActorValue (например, "Health").
+     * @return ActorValue или RE::ActorValue::kNone, если имя не найдено.
+     */
+    [[nodiscard]] RE::ActorValue lookup(std::string_view name) const
+    {
+      if (slots_.empty()) {
+        // Список ActorValue еще не загружен, используем поиск движка
+        return RE::ActorValueList::LookupActorValueByName(name);
+      }
+
+      const auto bucket = hash(name, 0) % displacements_.size();
+      const auto& slot = slots_[hash(name, displacements_[bucket]) & (slots_.size() - 1)];
+
+      if (!slot.name || !iequals(slot.name, name)) return RE::ActorValue::kNone;
+      return slot.av;
+    }
+
+    /**
+     * @brief Количество имен в таблице.
+     */
+    [[nodiscard]] std::size_t size() const { return count_; }
+
+  private:
+    struct entry
+    {
+      const char* name{nullptr};
+      RE::ActorValue av{RE::ActorValue::kNone};
+    };
+
+    actor_value_table() { build(); }
+
+    // FNV-1a по имени в нижнем регистре с финальным перемешиванием (младшие биты используются как индекс)
+    static uint32_t hash(std::string_view name, const uint32_t seed)
+    {
+      uint32_t h = 2166136261u ^ (seed * 16777619u);
+      for (const auto c : name) {
+        h ^= static_cast<uint8_t>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+        h *= 16777619u;
+      }
+      h ^= h >> 16;
+      h *= 0x85ebca6bu;
+      h ^= h >> 13;
+      h *= 0xc2b2ae35u;
+      h ^= h >> 16;
+      return h;
+    }
+
+    static bool iequals(std::string_view lhs, std::string_view rhs)
+    {
+      if (lhs.size() != rhs.size()) return false;
+      for (std::size_t i = 0; i < lhs.size(); ++i) {
+        auto a = lhs[i];
+        auto b = rhs[i];
+        if (a >= 'A' && a <= 'Z') a += 'a' - 'A';
+        if (b >= 'A' && b <= 'Z') b += 'a' - 'A';
+        if (a != b) return false;
+      }
+      return true;
+    }
+
+    // Hash and displace: ключи делятся на корзины по hash(name, 0), затем для каждой
+    // корзины (от больших к меньшим) подбирается seed, раскладывающий ее ключи по свободным слотам.
+    void build()
+    {
+      const auto list = RE::ActorValueList::GetSingleton();
+      if (!list) return;
+
+      std::vector<entry> entries;
+      for (std::size_t i = 0; i < std::to_underlying(RE::ActorValue::kTotal); ++i) {
+        const auto info = list->actorValues[i];
+        if (!info || !info->enumName || !*info->enumName) continue;
+        // Как и LookupActorValueByName, при совпадении имен выигрывает первое
+        if (std::ranges::any_of(entries, [&](const entry& e) { return iequals(e.name, info->enumName); })) continue;
+        entries.push_back({info->enumName, static_cast<RE::ActorValue>(i)});
+      }
+      if (entries.empty()) return;
+
+      std::size_t slot_count = 1;
+      while (slot_count < entries.size() + entries.size() / 2) slot_count <<= 1;
+
+      std::vector<std::vector<std::size_t>> buckets(entries.size());
+      for (std::size_t i = 0; i < entries.size(); ++i) {
+        buckets[hash(entries[i].name, 0) % buckets.size()].push_back(i);
+      }
+
+      std::vector<std::size_t> order(buckets.size());
+      for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+      std::ranges::stable_sort(order, [&](auto a, auto b) { return buckets[a].size() > buckets[b].size(); });
+
+      std::vector<entry> slots(slot_count);
+      std::vector<uint32_t> displacements(buckets.size(), 0);
+      std::vector<std::size_t> taken;
+
+      for (const auto b : order) {
+        if (buckets[b].empty()) break;
+
+        bool placed = false;
+        for (uint32_t seed = 1; seed < max_seed && !placed; ++seed) {
+          taken.clear();
+          bool ok = true;
+          for (const auto i : buckets[b]) {
+            const auto s = hash(entries[i].name, seed) & (slot_count - 1);
+            if (slots[s].name || std::ranges::find(taken, s) != taken.end()) {
+              ok = false;
+              break;
+            }
+            taken.push_back(s);
+          }
+          if (!ok) continue;
+
+          for (std::size_t k = 0; k < taken.size(); ++k) {
+            slots[taken[k]] = entries[buckets[b][k]];
+          }
+          displacements[b] = seed;
+          placed = true;
+        }
+
+        if (!placed) {
+          logger::warn("ActorValue name table: no perfect hash found, falling back to engine lookup");
+          return;
+        }
+      }
+
+      slots_ = std::move(slots);
+      displacements_ = std::move(displacements);
+      count_ = entries.size();
+      logger::info("ActorValue name table built: {} names, {} slots", count_, slots_.size());
+    }
+
+    static constexpr uint32_t max_seed = 1u << 16;
+
+    std::vector<entry> slots_;
+    std::vector<uint32_t> displacements_;
+    std::size_t count_{0};
+  };
+}
@@ -2,6 +2,7 @@
 
 #include "pch.h"
 #include "Wren/Wrappers/Keyword.hpp"
+#include "Wren/Wrappers/KeywordBitsets.hpp"
 
 namespace wren::wrappers
 {
@@ -121,7 +122,7 @@ namespace wren::wrappers
         auto ptr = get();
         auto kw_ptr = kw.get();
         if (ptr && kw_ptr) {
-            return ptr->HasKeyword(kw_ptr);
+            return keyword_bitsets::get_singleton()->has({ptr}, kw_ptr);
         }
         return false;
     }
@@ -135,7 +136,7 @@ namespace wren::wrappers
     {
         auto ptr = get();
         if (ptr) {
-            return ptr->HasKeywordID(form_id);
+            return keyword_bitsets::get_singleton()->has({ptr}, RE::TESForm::LookupByID<RE::BGSKeyword>(form_id));
         }
         return false;
     }
@@ -145,15 +146,23 @@ namespace wren::wrappers
      * @param editor_id EditorID ключевого слова.
      * @return true, если ключевое слово есть.
      */
-    bool has_keyword_string(const std::string& editor_id) const
+    bool has_keyword_string(std::string_view editor_id) const
     {
         auto ptr = get();
         if (ptr) {
+            if (const auto kw = core::forms::form_index::get_singleton()->by_editor_id<RE::BGSKeyword>(editor_id)) {
+                return keyword_bitsets::get_singleton()->has({ptr}, kw);
+            }
             return ptr->HasKeywordString(editor_id);
         }
         return false;
     }
 
+    /**
+     * @brief Форма с ключевыми словами для keyword_queries.
+     */
+    [[nodiscard]] keyword_bitsets::sources keyword_sources() const { return {get(), nullptr}; }
+
     static void bind(wrenbind17::ForeignModule& module)
     {
       auto& cls = module.klass<armor>("Armor");
@@ -168,6 +177,7 @@ namespace wren::wrappers
       cls.func<&armor::has_keyword>("hasKeyword");
       cls.func<&armor::has_keyword_id>("hasKeywordID");
       cls.func<&armor::has_keyword_string>("hasKeywordString");
+      keyword_queries<armor>::bind(cls);
     }
 
   private:
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "pch.h"
+#include "Wren/Tracer.hpp"
+#include "Wren/Wrappers/ActiveEffect.hpp"
+#include "Wren/Wrappers/ActorHandleCache.hpp"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Буфер отложенных изменений игры за кадр.
+   * Обработчики событий записывают изменения, буфер применяет их одним проходом в начале
+   * следующего кадра (engine::on_frame_start), когда все обработчики кадра уже отработали.
+   * Изменения одного (актер, ActorValue, модификатор) складываются в одну дельту:
+   * урон и восстановление — модификатор kDamage, mod — kPermanent. Для величины эффекта
+   * остается последнее значение. Нулевые суммарные дельты не применяются.
+   *
+   * Порядок: записи применяются в порядке первого появления ключа. barrier() разделяет
+   * буфер на части, изменения после барьера не складываются с изменениями до него и
+   * применяются после них. Ограничения kDamage (не выше 0) действуют на сумму, а не
+   * на каждое слагаемое; если это важно, нужен барьер.
+   */
+  class command_buffer
+  {
+  public:
+    struct stats
+    {
+      // Вызовов за кадр
+      std::uint32_t recorded{0};
+      // Обращений к игре при применении
+      std::uint32_t applied{0};
+      // Актер выгружен или эффект снят до применения
+      std::uint32_t skipped{0};
+    };
+
+    static command_buffer* get_singleton()
+    {
+      static command_buffer singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Добавляет дельту ActorValue.
+     * @param handle Хендл актера.
+     * @param av ActorValue.
+     * @param modifier Модификатор.
+     * @param delta Дельта (урон — отрицательная дельта kDamage).
+     */
+    void add_actor_value(const RE::ActorHandle& handle, const RE::ActorValue av,
+                         const RE::ACTOR_VALUE_MODIFIER modifier, const float delta)
+    {
+      const auto native = handle.native_handle();
+      if (!native) return;
+      ++pending_stats_.recorded;
+
+      const auto key = (static_cast<std::uint64_t>(native) << 32) |
+                       (static_cast<std::uint64_t>(static_cast<std::uint32_t>(av)) << 2) |
+                       static_cast<std::uint64_t>(std::to_underlying(modifier));
+      const auto [it, inserted] = actor_value_index_.try_emplace(key, static_cast<std::uint32_t>(entries_.size()));
+      if (!inserted) {
+        entries_[it->second].value += delta;
+        return;
+      }
+      entries_.push_back({kind::kActorValue, handle, av, modifier, nullptr, delta});
+    }
+
+    /**
+     * @brief Записывает величину активного эффекта, остается последнее значение.
+     * @param effect Эффект.
+     * @param value Новая величина.
+     */
+    void set_magnitude(RE::ActiveEffect* effect, const float value)
+    {
+      if (!effect || !effect->target) return;
+      const auto target = effect->target->GetTargetAsActor();
+      if (!target) return;
+      ++pending_stats_.recorded;
+
+      const auto [it, inserted] = magnitude_index_.try_emplace(effect, static_cast<std::uint32_t>(entries_.size()));
+      if (!inserted) {
+        entries_[it->second].value = value;
+        return;
+      }
+      entries_.push_back({kind::kMagnitude, target->GetHandle(), RE::ActorValue::kNone,
+                          RE::ACTOR_VALUE_MODIFIER::kPermanent, effect, value});
+    }
+
+    /**
+     * @brief Изменения после барьера применяются после всех изменений до него.
+     */
+    void barrier()
+    {
+      actor_value_index_.clear();
+      magnitude_index_.clear();
+    }
+
+    [[nodiscard]] std::size_t pending() const { return entries_.size(); }
+
+    /**
+     * @brief Статистика последнего применения.
+     */
+    [[nodiscard]] const stats& last_stats() const { return last_stats_; }
+
+    /**
+     * @brief Применяет буфер. Вызывается в начале кадра, до сброса actor_handle_cache:
+     * хендлы, разрешенные обработчиками прошлого кадра, берутся из кеша.
+     */
+    void flush()
+    {
+      last_stats_ = pending_stats_;
+      pending_stats_ = {};
+      if (entries_.empty()) return;
+
+      tracing::zone zone(tracing::category::kCommands, "Commands");
+      const auto cache = actor_handle_cache::get_singleton();
+      for (const auto& e : entries_) {
+        const auto a = cache->resolve(e.handle);
+        if (!a) {
+          ++last_stats_.skipped;
+          continue;
+        }
+
+        if (e.kind == kind::kActorValue) {
+          if (e.value == 0.f) continue;
+          const auto owner = a->AsActorValueOwner();
+          if (!owner) continue;
+          if (e.modifier == RE::ACTOR_VALUE_MODIFIER::kDamage) owner->RestoreActorValue(e.modifier, e.av, e.value);
+          else owner->ModActorValue(e.modifier, e.av, e.value);
+          ++last_stats_.applied;
+          continue;
+        }
+
+        // Эффект мог быть снят и удален после записи: меняем только если он еще у цели
+        if (!has_effect(a, e.effect)) {
+          ++last_stats_.skipped;
+          continue;
+        }
+        e.effect->magnitude = e.value;
+        active_effect_index::get_singleton()->mark_stale(a->AsMagicTarget());
+        ++last_stats_.applied;
+      }
+
+      entries_.clear();
+      barrier();
+    }
+
+    /**
+     * @brief Отбрасывает буфер без применения.
+     */
+    void clear()
+    {
+      entries_.clear();
+      barrier();
+      pending_stats_ = {};
+    }
+
+  private:
+    enum class kind : std::uint8_t
+    {
+      kActorValue,
+      kMagnitude,
+    };
+
+    struct entry
+    {
+      command_buffer::kind kind;
+      // Актер, для эффекта — его цель
+      RE::ActorHandle handle;
+      RE::ActorValue av;
+      RE::ACTOR_VALUE_MODIFIER modifier;
+      RE::ActiveEffect* effect;
+      float value;
+    };
+
+    command_buffer() = default;
+    ~command_buffer() = default;
+    command_buffer(const command_buffer&) = delete;
+    command_buffer(command_buffer&&) = delete;
+    command_buffer& operator=(const command_buffer&) = delete;
+    command_buffer& operator=(command_buffer&&) = delete;
+
+    static bool has_effect(RE::Actor* a, const RE::ActiveEffect* effect)
+    {
+      const auto target = a->AsMagicTarget();
+      const auto list = target ? target->GetActiveEffectList() : nullptr;
+      if (!list) return false;
+      for (const auto active : *list) {
+        if (active == effect) return true;
+      }
+      return false;
+    }
+
+    std::vector<entry> entries_;
+    // Ключ -> индекс в entries_ в текущей части буфера
+    std::unordered_map<std::uint64_t, std::uint32_t> actor_value_index_;
+    std::unordered_map<const RE::ActiveEffect*, std::uint32_t> magnitude_index_;
+    stats pending_stats_;
+    stats last_stats_;
+  };
+
+  /**
+   * @brief Отложенные изменения из скриптов (см. command_buffer).
+   */
+  class commands
+  {
+  public:
+    /**
+     * @brief Урон ActorValue в начале следующего кадра.
+     * @param a Актер.
+     * @param av_raw ID ActorValue.
+     * @param value Урон.
+     */
+    static auto damage(const actor& a, const uint32_t av_raw, const float value) -> wrenbind17::Result<void>
+    {
+      return add_actor_value("Commands.damage", a, av_raw, RE::ACTOR_VALUE_MODIFIER::kDamage, -value);
+    }
+
+    /**
+     * @brief Восстановление ActorValue в начале следующего кадра.
+     * @param a Актер.
+     * @param av_raw ID ActorValue.
+     * @param value Значение для восстановления.
+     */
+    static auto restore(const actor& a, const uint32_t av_raw, const float value) -> wrenbind17::Result<void>
+    {
+      return add_actor_value("Commands.restore", a, av_raw, RE::ACTOR_VALUE_MODIFIER::kDamage, value);
+    }
+
+    /**
+     * @brief Изменение постоянного модификатора ActorValue в начале следующего кадра.
+     * @param a Актер.
+     * @param av_raw ID ActorValue.
+     * @param value Изменение.
+     */
+    static auto mod(const actor& a, const uint32_t av_raw, const float value) -> wrenbind17::Result<void>
+    {
+      return add_actor_value("Commands.mod", a, av_raw, RE::ACTOR_VALUE_MODIFIER::kPermanent, value);
+    }
+
+    /**
+     * @brief Величина эффекта в начале следующего кадра.
+     * @param effect Эффект.
+     * @param value Новая величина.
+     */
+    static void set_magnitude(const active_effect& effect, const float value)
+    {
+      command_buffer::get_singleton()->set_magnitude(effect.get(), value);
+    }
+
+    static void barrier() { command_buffer::get_singleton()->barrier(); }
+
+    /**
+     * @brief Применяет буфер сейчас, если обработчику нужен результат в этом же кадре.
+     */
+    static void flush() { command_buffer::get_singleton()->flush(); }
+
+    static std::size_t get_pending() { return command_buffer::get_singleton()->pending(); }
+
+    static void bind(wrenbind17::ForeignModule& module)
+    {
+      auto& cls = module.klass<commands>("Commands");
+      cls.funcStatic<&commands::damage>("damage");
+      cls.funcStatic<&commands::restore>("restore");
+      cls.funcStatic<&commands::mod>("mod");
+      cls.funcStatic<&commands::set_magnitude>("setMagnitude");
+      cls.funcStatic<&commands::barrier>("barrier");
+      cls.funcStatic<&commands::flush>("flush");
+      cls.funcStatic<&commands::get_pending>("getPending");
+    }
+
+  private:
+    // Число вне enum дало бы запись за пределами таблицы ActorValue при применении буфера
+    static auto add_actor_value(const char* method, const actor& a, const uint32_t av_raw,
+                                const RE::ACTOR_VALUE_MODIFIER modifier, const float value) -> wrenbind17::Result<void>
+    {
+      if (av_raw >= static_cast<uint32_t>(RE::ActorValue::kTotal)) {
+        return wrenbind17::scriptError(std::string(method) + ": invalid actor value id " + std::to_string(av_raw));
+      }
+      command_buffer::get_singleton()->add_actor_value(a.get_handle(), static_cast<RE::ActorValue>(av_raw), modifier,
+                                                       value);
+      return {};
+    }
+  };
+}
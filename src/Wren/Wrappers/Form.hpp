@@ -0,0 +1,141 @@
+#pragma once
+
+#include "pch.h"
+#include "Core/FormIndex.hpp"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Обертка для класса RE::TESForm.
+   * Представляет произвольную форму игры; используется для поиска форм по EditorID и по строке плагина.
+   */
+  class form
+  {
+  public:
+    /**
+     * @brief Конструктор из указателя на RE::TESForm.
+     * @param f Указатель на RE::TESForm.
+     */
+    form(RE::TESForm* f)
+    {
+      if (f) {
+        form_ = f;
+        form_id_ = f->GetFormID();
+      }
+    }
+
+    /**
+     * @brief Конструктор из FormID.
+     * @param form_id ID формы.
+     */
+    form(const RE::FormID form_id)
+    {
+      if (auto f = RE::TESForm::LookupByID(form_id)) {
+        form_ = f;
+        form_id_ = form_id;
+      }
+    }
+
+    /**
+     * @brief Конструктор по умолчанию. Создает невалидную обертку.
+     */
+    form() = default;
+
+    /**
+     * @brief Получает указатель на RE::TESForm.
+     * @return Указатель на RE::TESForm или nullptr.
+     */
+    [[nodiscard]] RE::TESForm* get() const
+    {
+      if (form_) return form_;
+      return RE::TESForm::LookupByID(form_id_);
+    }
+
+    /**
+     * @brief Проверяет валидность формы.
+     * @return true, если форма существует и валидна.
+     */
+    [[nodiscard]] bool is_valid() const
+    {
+      return static_cast<bool>(get());
+    }
+
+    /**
+     * @brief Получает FormID формы.
+     * @return FormID или 0.
+     */
+    RE::FormID get_form_id() const
+    {
+      auto ptr = get();
+      return ptr ? ptr->GetFormID() : 0;
+    }
+
+    /**
+     * @brief Получает имя формы.
+     * @return Имя или пустая строка.
+     */
+    std::string get_name() const
+    {
+      auto ptr = get();
+      return ptr ? ptr->GetName() : "";
+    }
+
+    /**
+     * @brief Получает EditorID формы.
+     * @return EditorID или пустая строка.
+     */
+    std::string get_editor_id() const
+    {
+      return core::forms::form_index::editor_id_of(get());
+    }
+
+    /**
+     * @brief Получает тип формы.
+     * @return Значение RE::FormType или -1.
+     */
+    int32_t get_form_type() const
+    {
+      auto ptr = get();
+      return ptr ? static_cast<int32_t>(ptr->GetFormType()) : -1;
+    }
+
+    /**
+     * @brief Ищет форму по EditorID через индекс форм.
+     * @param editor_id EditorID (без учета регистра).
+     * @return Обертка формы (невалидная, если форма не найдена).
+     */
+    static form by_editor_id(std::string_view editor_id)
+    {
+      return form(core::forms::form_index::get_singleton()->by_editor_id(editor_id));
+    }
+
+    /**
+     * @brief Ищет форму по строке вида "0xABC~Plugin.esp".
+     * @param plugin_id Локальный FormID (hex) и имя плагина через '~'.
+     * @return Обертка формы (невалидная, если форма не найдена).
+     */
+    static form by_plugin_id(std::string_view plugin_id)
+    {
+      const auto form_id = core::forms::form_index::get_singleton()->form_id_by_plugin_id(plugin_id);
+      return form_id ? form(form_id) : form();
+    }
+
+    static void bind(wrenbind17::ForeignModule& module)
+    {
+      auto& cls = module.klass<form>("Form");
+      cls.ctor<>();
+      cls.ctor<const RE::FormID>();
+      cls.func<&form::is_valid>("isValid");
+      cls.func<&form::get_form_id>("getFormID");
+      cls.func<&form::get_name>("getName");
+      cls.func<&form::get_editor_id>("getEditorID");
+      cls.func<&form::get_form_type>("getFormType");
+      cls.funcStatic<&form::by_editor_id>("byEditorId");
+      cls.funcStatic<&form::by_plugin_id>("byPluginId");
+    }
+
+  private:
+    RE::TESForm* form_{nullptr};
+    RE::FormID form_id_{0};
+  };
+}
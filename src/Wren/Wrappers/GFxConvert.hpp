@@ -0,0 +1,429 @@
+#pragma once
+
+#include "pch.h"
+#include <charconv>
+#include "Wren/Wrappers/GFxValue.hpp"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Значение Wren (Num, Bool, String, null, GFxValue, List, Map), разобранное в gfx_arena.
+   * Как аргумент foreign-метода разбирается прямо из слотов VM, без промежуточных gfx_value.
+   * У метода может быть только один такой аргумент: разбор следующего сбрасывает арену.
+   * Слишком глубокие (в том числе циклические) и слишком большие значения не разбираются,
+   * ошибку возвращает метод.
+   */
+  struct gfx_input
+  {
+    uint32_t root{0};
+    bool ok{true};
+  };
+
+  /**
+   * @brief Значение Scaleform, которое при возврате в Wren рекурсивно превращается в List/Map.
+   */
+  struct gfx_output
+  {
+    RE::GFxValue value;
+  };
+
+  /**
+   * @brief Пакет UI.apply, построенный из арены: пути и готовые значения/аргументы вызовов.
+   * Не ссылается на арену, поэтому ActionScript, вызванный из пакета, может снова разбирать значения.
+   */
+  struct gfx_batch
+  {
+    struct op
+    {
+      // Смещение пути в paths
+      uint32_t path{0};
+      // Значение переменной или первый аргумент вызова в values
+      uint32_t first{0};
+      uint32_t count{0};
+      bool call{false};
+    };
+
+    std::string paths;
+    std::vector<RE::GFxValue> values;
+    std::vector<op> ops;
+
+    void clear()
+    {
+      paths.clear();
+      values.clear();
+      ops.clear();
+    }
+  };
+
+  /**
+   * @brief Переиспользуемая память для перевода значений Wren в дерево GFxValue.
+   * Значение сначала разбирается из слотов VM в плоский список узлов (строки копируются
+   * в общий буфер), затем по узлам строится объект/массив Scaleform. Память арены
+   * не освобождается между вызовами.
+   */
+  class gfx_arena
+  {
+  public:
+    static gfx_arena* get_singleton()
+    {
+      static gfx_arena singleton;
+      return &singleton;
+    }
+
+    // Текст ошибки для gfx_input с ok == false
+    static constexpr auto input_error = "value is nested deeper than 32 levels, contains a cycle or is too large";
+
+    /**
+     * @brief Разбирает значение из слота VM в узлы арены.
+     * @return Корневой узел; ok == false, если значение слишком глубокое или большое.
+     */
+    gfx_input record(WrenVM* vm, const int slot)
+    {
+      const auto index = static_cast<uint32_t>(nodes_.size());
+      nodes_.emplace_back();
+      if (fill(vm, slot, index, 0)) return {index};
+      reset();
+      return {0, false};
+    }
+
+    /**
+     * @brief Строит GFxValue из разобранного значения и сбрасывает арену.
+     * Массивы, объекты и строки создаются в movie; без movie результат undefined.
+     */
+    RE::GFxValue take_value(RE::GFxMovieView* movie, const gfx_input& input)
+    {
+      RE::GFxValue result;
+      if (movie && input.root < nodes_.size()) build(movie, input.root, result);
+      reset();
+      return result;
+    }
+
+    /**
+     * @brief Строит аргументы вызова и сбрасывает арену. Элементы списка становятся
+     * отдельными аргументами, любое другое значение — единственным аргументом.
+     */
+    void take_args(RE::GFxMovieView* movie, const gfx_input& input, std::vector<RE::GFxValue>& out)
+    {
+      out.clear();
+      if (movie && input.root < nodes_.size()) {
+        const auto root = nodes_[input.root];
+        if (root.type == kind::kArray) {
+          out.resize(root.count);
+          for (uint32_t i = 0; i < root.count; ++i) build(movie, root.first + i, out[i]);
+        } else {
+          build(movie, input.root, out.emplace_back());
+        }
+      }
+      reset();
+    }
+
+    /**
+     * @brief Строит пакет из списка [путь, значение, ...] и сбрасывает арену.
+     * Значение-список — вызов функции по пути, его элементы — аргументы (как в take_args),
+     * любое другое значение устанавливается как переменная.
+     * @return Текст ошибки или nullptr. Без movie пакет только проверяется.
+     */
+    const char* take_batch(RE::GFxMovieView* movie, const gfx_input& input, gfx_batch& out)
+    {
+      out.clear();
+      const char* error = nullptr;
+      const auto root = input.root < nodes_.size() ? nodes_[input.root] : node{};
+      if (!input.ok) {
+        error = "UI.apply: value is nested deeper than 32 levels, contains a cycle or is too large";
+      } else if (root.type != kind::kArray || root.count % 2 != 0) {
+        error = "UI.apply: expected [path, value, ...] pairs";
+      }
+      for (uint32_t i = 0; !error && i < root.count; i += 2) {
+        if (nodes_[root.first + i].type != kind::kString) error = "UI.apply: path must be a string";
+      }
+
+      for (uint32_t i = 0; !error && movie && i < root.count; i += 2) {
+        const auto& path = nodes_[root.first + i];
+        const auto& value = nodes_[root.first + i + 1];
+        gfx_batch::op op{static_cast<uint32_t>(out.paths.size()), static_cast<uint32_t>(out.values.size()), 1,
+                         value.type == kind::kArray};
+        out.paths.append(chars_.data() + path.first, path.count);
+        out.paths.push_back('\0');
+        if (op.call) {
+          op.count = value.count;
+          out.values.resize(out.values.size() + value.count);
+          for (uint32_t j = 0; j < value.count; ++j) build(movie, value.first + j, out.values[op.first + j]);
+        } else {
+          build(movie, root.first + i + 1, out.values.emplace_back());
+        }
+        out.ops.push_back(op);
+      }
+      reset();
+      return error;
+    }
+
+    void reset()
+    {
+      nodes_.clear();
+      chars_.clear();
+      values_.clear();
+    }
+
+    /**
+     * @brief Записывает GFxValue в слот VM: массивы становятся List, объекты — Map.
+     * Display object, слишком глубокие значения и значения сверх max_nodes остаются GFxValue.
+     */
+    static void push(WrenVM* vm, const int slot, const RE::GFxValue& value)
+    {
+      std::size_t budget = max_nodes;
+      push(vm, slot, value, 0, budget);
+    }
+
+  private:
+    static void push(WrenVM* vm, const int slot, const RE::GFxValue& value, const uint32_t depth, std::size_t& budget)
+    {
+      const auto expand = depth < max_depth && budget > 0;
+      if (expand) --budget;
+
+      if (value.IsUndefined() || value.IsNull()) {
+        wrenSetSlotNull(vm, slot);
+      } else if (value.IsBool()) {
+        wrenSetSlotBool(vm, slot, value.GetBool());
+      } else if (value.IsNumber()) {
+        wrenSetSlotDouble(vm, slot, value.GetNumber());
+      } else if (value.IsString()) {
+        wrenSetSlotString(vm, slot, value.GetString());
+      } else if (expand && value.IsArray()) {
+        wrenEnsureSlots(vm, slot + 2);
+        wrenSetSlotNewList(vm, slot);
+        RE::GFxValue element;
+        const auto size = value.GetArraySize();
+        for (uint32_t i = 0; i < size; ++i) {
+          value.GetElement(i, &element);
+          push(vm, slot + 1, element, depth + 1, budget);
+          wrenInsertInList(vm, slot, -1, slot + 1);
+        }
+      } else if (expand && value.IsObject() && !value.IsDisplayObject()) {
+        wrenEnsureSlots(vm, slot + 3);
+        wrenSetSlotNewMap(vm, slot);
+        member_visitor visitor{vm, slot, depth, budget};
+        value.VisitMembers(&visitor);
+      } else {
+        wrenbind17::detail::PushHelper<gfx_value>::f(vm, slot, gfx_value(value));
+      }
+    }
+
+    enum class kind : uint8_t
+    {
+      kUndefined,
+      kNull,
+      kBool,
+      kNumber,
+      kString, // first/count — смещение и длина в chars_
+      kValue,  // first — индекс в values_
+      kArray,  // first/count — дочерние узлы
+      kObject, // first/count — пары узлов ключ/значение, count — число пар
+    };
+
+    struct node
+    {
+      kind type{kind::kUndefined};
+      uint32_t first{0};
+      uint32_t count{0};
+      double number{0.0};
+    };
+
+    struct member_visitor final : RE::GFxValue::ObjectVisitor
+    {
+      member_visitor(WrenVM* vm, const int slot, const uint32_t depth, std::size_t& budget) :
+        vm(vm), slot(slot), depth(depth), budget(budget)
+      {
+      }
+
+      void Visit(const char* name, const RE::GFxValue& value) override
+      {
+        wrenSetSlotString(vm, slot + 1, name);
+        push(vm, slot + 2, value, depth + 1, budget);
+        wrenSetMapValue(vm, slot, slot + 1, slot + 2);
+      }
+
+      WrenVM* vm;
+      int slot;
+      uint32_t depth;
+      std::size_t& budget;
+    };
+
+    gfx_arena() = default;
+
+    // Узел пишется по индексу: вложенные значения добавляют узлы и могут переместить nodes_.
+    // Глубже max_depth разбор прерывается целиком, как в storage::encode: обрезка одной ветви
+    // оставила бы циклическому списку с несколькими ссылками на себя экспоненциальный обход.
+    bool fill(WrenVM* vm, const int slot, const uint32_t index, const uint32_t depth)
+    {
+      node n;
+      switch (wrenGetSlotType(vm, slot)) {
+      case WREN_TYPE_NULL:
+        n.type = kind::kNull;
+        break;
+      case WREN_TYPE_BOOL:
+        n.type = kind::kBool;
+        n.number = wrenGetSlotBool(vm, slot) ? 1.0 : 0.0;
+        break;
+      case WREN_TYPE_NUM:
+        n.type = kind::kNumber;
+        n.number = wrenGetSlotDouble(vm, slot);
+        break;
+      case WREN_TYPE_STRING: {
+        int length = 0;
+        const auto bytes = wrenGetSlotBytes(vm, slot, &length);
+        n = string_node({bytes, static_cast<std::size_t>(length)});
+        break;
+      }
+      case WREN_TYPE_FOREIGN:
+        if (wrenbind17::detail::is<gfx_value>(vm, slot)) {
+          n.type = kind::kValue;
+          n.first = static_cast<uint32_t>(values_.size());
+          values_.push_back(wrenbind17::detail::PopHelper<const gfx_value&>::f(vm, slot).get());
+        }
+        break;
+      case WREN_TYPE_LIST: {
+        const auto count = static_cast<uint32_t>(wrenGetListCount(vm, slot));
+        if (depth >= max_depth || nodes_.size() + count > max_nodes) return false;
+        n = {kind::kArray, static_cast<uint32_t>(nodes_.size()), count};
+        nodes_.resize(nodes_.size() + count);
+        wrenEnsureSlots(vm, slot + 2);
+        for (uint32_t i = 0; i < count; ++i) {
+          wrenGetListElement(vm, slot, static_cast<int>(i), slot + 1);
+          if (!fill(vm, slot + 1, n.first + i, depth + 1)) return false;
+        }
+        break;
+      }
+      case WREN_TYPE_MAP: {
+        const auto count = static_cast<uint32_t>(wrenGetMapCount(vm, slot));
+        if (depth >= max_depth || nodes_.size() + std::size_t{count} * 2 > max_nodes) return false;
+        n = {kind::kObject, static_cast<uint32_t>(nodes_.size()), 0};
+        nodes_.resize(nodes_.size() + count * 2);
+        wrenEnsureSlots(vm, slot + 3);
+        for (auto cursor = wrenGetMapNextEntry(vm, slot, -1, slot + 1, slot + 2); cursor >= 0;
+             cursor = wrenGetMapNextEntry(vm, slot, cursor, slot + 1, slot + 2)) {
+          // Имена членов AS2 — строки, числовые ключи переводятся в строку, остальные пропускаются
+          const auto key_type = wrenGetSlotType(vm, slot + 1);
+          if (key_type == WREN_TYPE_STRING) {
+            int length = 0;
+            const auto bytes = wrenGetSlotBytes(vm, slot + 1, &length);
+            nodes_[n.first + n.count * 2] = string_node({bytes, static_cast<std::size_t>(length)});
+          } else if (key_type == WREN_TYPE_NUM) {
+            char buffer[32];
+            const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), wrenGetSlotDouble(vm, slot + 1));
+            nodes_[n.first + n.count * 2] = string_node({buffer, static_cast<std::size_t>(end - buffer)});
+          } else {
+            continue;
+          }
+          if (!fill(vm, slot + 2, n.first + n.count * 2 + 1, depth + 1)) return false;
+          ++n.count;
+        }
+        break;
+      }
+      default:
+        break;
+      }
+      nodes_[index] = n;
+      return true;
+    }
+
+    node string_node(const std::string_view text)
+    {
+      const node n{kind::kString, static_cast<uint32_t>(chars_.size()), static_cast<uint32_t>(text.size())};
+      chars_.append(text);
+      chars_.push_back('\0');
+      return n;
+    }
+
+    void build(RE::GFxMovieView* movie, const uint32_t index, RE::GFxValue& out) const
+    {
+      const auto& n = nodes_[index];
+      switch (n.type) {
+      case kind::kNull:
+        out.SetNull();
+        break;
+      case kind::kBool:
+        out.SetBoolean(n.number != 0.0);
+        break;
+      case kind::kNumber:
+        out.SetNumber(n.number);
+        break;
+      case kind::kString:
+        // Строка создается в movie: буфер арены будет переиспользован
+        movie->CreateString(&out, chars_.data() + n.first);
+        break;
+      case kind::kValue:
+        out = values_[n.first];
+        break;
+      case kind::kArray: {
+        movie->CreateArray(&out);
+        out.SetArraySize(n.count);
+        RE::GFxValue element;
+        for (uint32_t i = 0; i < n.count; ++i) {
+          build(movie, n.first + i, element);
+          out.SetElement(i, element);
+        }
+        break;
+      }
+      case kind::kObject: {
+        movie->CreateObject(&out);
+        RE::GFxValue member;
+        for (uint32_t i = 0; i < n.count; ++i) {
+          const auto& key = nodes_[n.first + i * 2];
+          build(movie, n.first + i * 2 + 1, member);
+          out.SetMember(chars_.data() + key.first, member);
+        }
+        break;
+      }
+      default:
+        out.SetUndefined();
+        break;
+      }
+    }
+
+    // Предел глубины останавливает циклические списки и объекты, предел узлов — общие
+    // подсписки, которые при разборе в дерево копируются заново на каждой ссылке
+    static constexpr uint32_t max_depth = 32;
+    static constexpr std::size_t max_nodes = 1 << 20;
+
+    std::vector<node> nodes_;
+    std::string chars_;
+    std::vector<RE::GFxValue> values_;
+  };
+}
+
+namespace wrenbind17::detail
+{
+  template<>
+  struct PopHelper<wren::wrappers::gfx_input>
+  {
+    static wren::wrappers::gfx_input f(WrenVM* vm, const int idx)
+    {
+      const auto arena = wren::wrappers::gfx_arena::get_singleton();
+      arena->reset();
+      return arena->record(vm, idx);
+    }
+  };
+
+  template<>
+  struct PopHelper<const wren::wrappers::gfx_input&> : PopHelper<wren::wrappers::gfx_input>
+  {
+  };
+
+  // Принимается любое значение: неподдерживаемые становятся undefined
+  template<>
+  struct ArgCheck<wren::wrappers::gfx_input>
+  {
+    static constexpr bool exact = true;
+
+    static const char* f(WrenVM*, int) { return nullptr; }
+  };
+
+  template<>
+  struct PushHelper<wren::wrappers::gfx_output>
+  {
+    static void f(WrenVM* vm, const int idx, const wren::wrappers::gfx_output& value)
+    {
+      wren::wrappers::gfx_arena::push(vm, idx, value.value);
+    }
+  };
+}
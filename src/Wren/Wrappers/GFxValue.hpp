@@ -188,16 +188,16 @@ namespace wren::wrappers
      * @param name Имя члена.
      * @return true, если член существует.
      */
-    bool has_member(const std::string& name) const { return value_.HasMember(name.c_str()); }
+    bool has_member(const char* name) const { return value_.HasMember(name); }
 
     /**
      * @brief Получает член объекта по имени.
      * @param name Имя члена.
      * @return Значение члена как GFxValue.
      */
-    gfx_value get_member(const std::string& name) const {
+    gfx_value get_member(const char* name) const {
         RE::GFxValue result;
-        value_.GetMember(name.c_str(), &result);
+        value_.GetMember(name, &result);
         return gfx_value(result);
     }
 
@@ -206,8 +206,8 @@ namespace wren::wrappers
      * @param name Имя члена.
      * @param val Значение для установки.
      */
-    void set_member(const std::string& name, const gfx_value& val) {
-        value_.SetMember(name.c_str(), val.get());
+    void set_member(const char* name, const gfx_value& val) {
+        value_.SetMember(name, val.get());
     }
 
     /**
@@ -215,11 +215,11 @@ namespace wren::wrappers
      * @param name Имя метода.
      * @param args Аргументы вызова.
      */
-    void invoke(const std::string& name, const std::vector<gfx_value>& args) {
+    void invoke(const char* name, const std::vector<gfx_value>& args) {
         std::vector<RE::GFxValue> gfx_args;
         gfx_args.reserve(args.size());
         for (const auto& arg : args) gfx_args.push_back(arg.get());
-        value_.Invoke(name.c_str(), nullptr, gfx_args.data(), gfx_args.size());
+        value_.Invoke(name, nullptr, gfx_args.data(), gfx_args.size());
     }
 
     /**
@@ -228,12 +228,12 @@ namespace wren::wrappers
      * @param args Аргументы вызова.
      * @return Результат вызова как GFxValue.
      */
-    gfx_value invoke_result(const std::string& name, const std::vector<gfx_value>& args) {
+    gfx_value invoke_result(const char* name, const std::vector<gfx_value>& args) {
         std::vector<RE::GFxValue> gfx_args;
         gfx_args.reserve(args.size());
         for (const auto& arg : args) gfx_args.push_back(arg.get());
         RE::GFxValue result;
-        value_.Invoke(name.c_str(), &result, gfx_args.data(), gfx_args.size());
+        value_.Invoke(name, &result, gfx_args.data(), gfx_args.size());
         return gfx_value(result);
     }
 
@@ -283,13 +283,13 @@ namespace wren::wrappers
      * @brief Устанавливает текст (для текстовых полей).
      * @param text Текст.
      */
-    void set_text(const std::string& text) { value_.SetText(text.c_str()); }
+    void set_text(const char* text) { value_.SetText(text); }
 
     /**
      * @brief Устанавливает HTML текст (для текстовых полей).
      * @param html HTML текст.
      */
-    void set_text_html(const std::string& html) { value_.SetTextHTML(html.c_str()); }
+    void set_text_html(const char* html) { value_.SetTextHTML(html); }
 
     static void bind(wrenbind17::ForeignModule& module)
     {
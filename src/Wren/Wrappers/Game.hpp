@@ -1,11 +1,20 @@
 #pragma once
 
 #include "Wren/Wrappers/Actor.hpp"
+#include "Wren/Wrappers/ActorGrid.hpp"
 #include "Wren/Wrappers/Setting.hpp"
 #include "pch.h"
 
 namespace wren::wrappers
 {
+  /**
+   * @brief Точка [x, y, z] из списка Wren, читается прямо в NiPoint3 без промежуточного вектора.
+   */
+  struct point_value
+  {
+    RE::NiPoint3 point;
+  };
+
   /**
    * @brief Статический класс с глобальными функциями игры.
    */
@@ -26,18 +35,18 @@ namespace wren::wrappers
      * @brief Выводит уведомление в левом верхнем углу экрана.
      * @param notification Текст уведомления.
      */
-    static void debug_notification(const std::string& notification)
+    static void debug_notification(const char* notification)
     {
-      RE::DebugNotification(notification.c_str());
+      RE::DebugNotification(notification);
     }
 
     /**
      * @brief Выводит модальное окно с сообщением (MessageBox).
      * @param message Текст сообщения.
      */
-    static void debug_message_box(const std::string& message)
+    static void debug_message_box(const char* message)
     {
-        RE::DebugMessageBox(message.c_str());
+        RE::DebugMessageBox(message);
     }
 
     #undef PlaySound
@@ -45,9 +54,9 @@ namespace wren::wrappers
      * @brief Проигрывает звук по его EditorID.
      * @param editor_id EditorID звука.
      */
-    static void play_sound(const std::string& editor_id)
+    static void play_sound(const char* editor_id)
     {
-        RE::PlaySound(editor_id.c_str());
+        RE::PlaySound(editor_id);
     }
 
     /**
@@ -90,12 +99,43 @@ namespace wren::wrappers
      * @param name Имя настройки (например, "fJumpHeightMin:GamePlay").
      * @return Объект setting.
      */
-    static setting get_ini_setting(const std::string& name)
+    static setting get_ini_setting(const char* name)
     {
-        auto s = RE::GetINISetting(name.c_str());
+        auto s = RE::GetINISetting(name);
         return setting(s);
     }
 
+    /**
+     * @brief Ищет загруженных актеров в радиусе от точки.
+     * @param position Центр (список [x, y, z]).
+     * @param radius Радиус.
+     * @param filter Маска actor_filter.
+     * @return Новый массив результатов (из пула actor_array).
+     */
+    static std::shared_ptr<actor_array> actors_in_radius(const point_value& position, float radius, uint32_t filter)
+    {
+        auto results = actor_array::acquire();
+        actor_grid::get_singleton()->query_radius(*results, position.point, radius, filter);
+        return results;
+    }
+
+    /**
+     * @brief Ищет загруженных актеров в конусе.
+     * @param origin Вершина конуса (список [x, y, z]).
+     * @param direction Направление оси конуса (список [x, y, z]).
+     * @param half_angle Половина угла раствора в градусах.
+     * @param range Длина конуса.
+     * @param filter Маска actor_filter.
+     * @return Новый массив результатов (из пула actor_array).
+     */
+    static std::shared_ptr<actor_array> actors_in_cone(const point_value& origin, const point_value& direction,
+                                                       float half_angle, float range, uint32_t filter)
+    {
+        auto results = actor_array::acquire();
+        actor_grid::get_singleton()->query_cone(*results, origin.point, direction.point, half_angle, range, filter);
+        return results;
+    }
+
     static void bind(wrenbind17::ForeignModule& module)
     {
       auto& cls = module.klass<game>("Game");
@@ -107,6 +147,58 @@ namespace wren::wrappers
       cls.funcStatic<&game::get_duration_of_application_run_time>("getDurationOfApplicationRunTime");
       cls.funcStatic<&game::get_seconds_since_last_frame>("getSecondsSinceLastFrame");
       cls.funcStatic<&game::get_ini_setting>("getINISetting");
+      cls.funcStatic<&game::actors_in_radius>("actorsInRadius");
+      cls.funcStatic<&game::actors_in_cone>("actorsInCone");
+    }
+
+  };
+}
+
+namespace wrenbind17::detail
+{
+  template<>
+  struct PopHelper<wren::wrappers::point_value>
+  {
+    static constexpr auto error = "Bad cast when getting value from Wren expected list [x, y, z]";
+
+    // Проверки те же, что в ArgCheck: без WRENBIND17_NO_EXCEPTIONS ArgCheck не вызывается
+    static wren::wrappers::point_value f(WrenVM* vm, const int idx)
+    {
+      if (wrenGetSlotType(vm, idx) != WREN_TYPE_LIST || wrenGetListCount(vm, idx) < 3) throw BadCast(error);
+      // Свободный слот за аргументами вызова
+      const auto element = wrenGetSlotCount(vm);
+      wrenEnsureSlots(vm, element + 1);
+      float xyz[3];
+      for (int i = 0; i < 3; ++i) {
+        wrenGetListElement(vm, idx, i, element);
+        if (wrenGetSlotType(vm, element) != WREN_TYPE_NUM) throw BadCast(error);
+        xyz[i] = static_cast<float>(wrenGetSlotDouble(vm, element));
+      }
+      return {RE::NiPoint3(xyz[0], xyz[1], xyz[2])};
+    }
+  };
+
+  template<>
+  struct PopHelper<const wren::wrappers::point_value&> : PopHelper<wren::wrappers::point_value>
+  {
+  };
+
+  template<>
+  struct ArgCheck<wren::wrappers::point_value>
+  {
+    static constexpr bool exact = true;
+
+    static const char* f(WrenVM* vm, const int idx)
+    {
+      constexpr auto error = PopHelper<wren::wrappers::point_value>::error;
+      if (wrenGetSlotType(vm, idx) != WREN_TYPE_LIST || wrenGetListCount(vm, idx) < 3) return error;
+      const auto element = wrenGetSlotCount(vm);
+      wrenEnsureSlots(vm, element + 1);
+      for (int i = 0; i < 3; ++i) {
+        wrenGetListElement(vm, idx, i, element);
+        if (wrenGetSlotType(vm, element) != WREN_TYPE_NUM) return error;
+      }
+      return nullptr;
     }
   };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "pch.h"
+#include "Core/FormIndex.hpp"
 
 namespace wren::wrappers
 {
@@ -39,9 +40,9 @@ namespace wren::wrappers
      * @brief Конструктор из EditorID (строкового идентификатора).
      * @param editor_id EditorID ключевого слова (например, "ActorTypeNPC").
      */
-    keyword(const std::string& editor_id)
+    keyword(std::string_view editor_id)
     {
-        if (auto k = RE::TESForm::LookupByEditorID<RE::BGSKeyword>(editor_id)) {
+        if (auto k = core::forms::form_index::get_singleton()->by_editor_id<RE::BGSKeyword>(editor_id)) {
             keyword_ = k;
             form_id_ = k->GetFormID();
         }
@@ -77,8 +78,7 @@ namespace wren::wrappers
      */
     std::string get_editor_id() const
     {
-      auto ptr = get();
-      return ptr ? ptr->GetFormEditorID() : "";
+      return core::forms::form_index::editor_id_of(get());
     }
 
     /**
@@ -97,7 +97,7 @@ namespace wren::wrappers
       auto& cls = module.klass<keyword>("Keyword");
       cls.ctor<>();
       cls.ctor<const RE::FormID>();
-      cls.ctor<const std::string&>(); // Allow creating by EditorID
+      cls.ctor<std::string_view>(); // Allow creating by EditorID
       cls.func<&keyword::is_valid>("isValid");
       cls.func<&keyword::get_editor_id>("getEditorID");
       cls.func<&keyword::get_name>("getName");
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "pch.h"
+#include "Wren/Wrappers/Keyword.hpp"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Кеш ключевых слов форм в виде битовых множеств.
+   * При загрузке данных каждому BGSKeyword назначается плотный индекс, для формы
+   * битовое множество ее ключевых слов строится лениво при первом запросе.
+   * Проверка одного ключевого слова сводится к проверке бита, проверка списка —
+   * к AND/OR по 64-битным словам вместо обхода массива ключевых слов формы.
+   * Ключевые слова, созданные после загрузки данных, индекса не имеют и проверяются движком.
+   */
+  class keyword_bitsets
+  {
+  public:
+    using forms = std::initializer_list<const RE::BGSKeywordForm*>;
+    // Формы обертки для keyword_queries (для актера — NPC и раса)
+    using sources = std::array<const RE::BGSKeywordForm*, 2>;
+
+    static constexpr uint32_t npos = ~0u;
+    // Форм в кеше, при переполнении кеш сбрасывается и заполняется заново
+    static constexpr std::size_t max_forms = 1 << 16;
+
+    /**
+     * @brief Возвращает кеш, при первом обращении назначает индексы ключевым словам.
+     */
+    static keyword_bitsets* get_singleton()
+    {
+      static keyword_bitsets singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Получает плотный индекс ключевого слова.
+     * @param kw Ключевое слово.
+     * @return Индекс или npos, если ключевое слово не проиндексировано.
+     */
+    [[nodiscard]] uint32_t index_of(const RE::BGSKeyword* kw) const
+    {
+      if (!kw) return npos;
+      const auto it = indices_.find(kw);
+      return it != indices_.end() ? it->second : npos;
+    }
+
+    /**
+     * @brief Проверяет, есть ли ключевое слово хотя бы у одной из форм.
+     * @param sources Формы (для актера — NPC и раса).
+     * @param kw Ключевое слово.
+     */
+    bool has(const forms sources, const RE::BGSKeyword* kw)
+    {
+      if (!kw) return false;
+
+      const auto idx = index_of(kw);
+      if (idx == npos) return has_unindexed({sources.begin(), sources.size()}, kw);
+
+      for (const auto form : sources) {
+        if (!form) continue;
+        const auto& words = words_of(form);
+        if ((idx >> 6) < words.size() && (words[idx >> 6] >> (idx & 63) & 1)) return true;
+      }
+      return false;
+    }
+
+    /**
+     * @brief Проверяет, есть ли у форм хотя бы одно ключевое слово из списка.
+     * @param sources Формы (для актера — NPC и раса).
+     * @param keywords Список ключевых слов. Невалидные пропускаются.
+     * @return false для пустого списка.
+     */
+    bool has_any(const std::span<const RE::BGSKeywordForm* const> sources, std::span<const keyword> keywords)
+    {
+      return match(sources, keywords, false);
+    }
+
+    /**
+     * @brief Проверяет, есть ли у форм все ключевые слова из списка.
+     * @param sources Формы (для актера — NPC и раса).
+     * @param keywords Список ключевых слов. Невалидное ключевое слово дает false.
+     * @return true для пустого списка.
+     */
+    bool has_all(const std::span<const RE::BGSKeywordForm* const> sources, std::span<const keyword> keywords)
+    {
+      return match(sources, keywords, true);
+    }
+
+    /**
+     * @brief Сбрасывает битовые множества форм (новая игра или загрузка сохранения):
+     * формы, созданные в прошлой сессии, могли быть удалены, а их адреса — переиспользованы.
+     * Индексы ключевых слов сохраняются.
+     */
+    void clear() { cache_.clear(); }
+
+  private:
+    struct entry
+    {
+      RE::BGSKeyword** keywords{nullptr};
+      uint32_t count{0};
+      std::vector<uint64_t> words;
+    };
+
+    keyword_bitsets() { build(); }
+
+    void build()
+    {
+      const auto data_handler = RE::TESDataHandler::GetSingleton();
+      if (!data_handler) return;
+
+      const auto& keywords = data_handler->GetFormArray<RE::BGSKeyword>();
+      indices_.reserve(keywords.size());
+      for (const auto kw : keywords) {
+        if (kw) indices_.emplace(kw, static_cast<uint32_t>(indices_.size()));
+      }
+
+      logger::info("Keyword bitsets: {} keywords indexed", indices_.size());
+    }
+
+    static bool has_unindexed(const std::span<const RE::BGSKeywordForm* const> sources, const RE::BGSKeyword* kw)
+    {
+      return std::ranges::any_of(sources, [&](const auto form) { return form && form->HasKeyword(kw); });
+    }
+
+    // Битовое множество формы; перестраивается, если массив ключевых слов формы был заменен
+    const std::vector<uint64_t>& words_of(const RE::BGSKeywordForm* form)
+    {
+      if (cache_.size() >= max_forms && !cache_.contains(form)) cache_.clear();
+      auto& e = cache_[form];
+      if (e.keywords == form->keywords && e.count == form->numKeywords) {
+        return e.words;
+      }
+
+      e.keywords = form->keywords;
+      e.count = form->numKeywords;
+      e.words.clear();
+      for (uint32_t i = 0; i < e.count; ++i) {
+        const auto idx = index_of(e.keywords[i]);
+        if (idx == npos) continue;
+        if (e.words.size() <= (idx >> 6)) e.words.resize((idx >> 6) + 1, 0);
+        e.words[idx >> 6] |= 1ull << (idx & 63);
+      }
+      return e.words;
+    }
+
+    bool match(const std::span<const RE::BGSKeywordForm* const> sources, std::span<const keyword> keywords, const bool all)
+    {
+      query_.clear();
+      for (const auto& kw : keywords) {
+        const auto ptr = kw.get();
+        if (!ptr) {
+          if (all) return false;
+          continue;
+        }
+
+        const auto idx = index_of(ptr);
+        if (idx == npos) {
+          const bool found = has_unindexed(sources, ptr);
+          if (found != all) return found;
+          continue;
+        }
+
+        if (query_.size() <= (idx >> 6)) query_.resize((idx >> 6) + 1, 0);
+        query_[idx >> 6] |= 1ull << (idx & 63);
+      }
+      if (query_.empty()) return all;
+
+      // Объединение множеств всех форм, затем одна маска на весь список
+      merged_.assign(query_.size(), 0);
+      for (const auto form : sources) {
+        if (!form) continue;
+        const auto& words = words_of(form);
+        const auto n = std::min(words.size(), merged_.size());
+        for (std::size_t i = 0; i < n; ++i) merged_[i] |= words[i];
+      }
+
+      uint64_t acc = 0;
+      if (all) {
+        for (std::size_t i = 0; i < query_.size(); ++i) acc |= query_[i] & ~merged_[i];
+        return acc == 0;
+      }
+      for (std::size_t i = 0; i < query_.size(); ++i) acc |= query_[i] & merged_[i];
+      return acc != 0;
+    }
+
+    std::unordered_map<const RE::BGSKeyword*, uint32_t> indices_;
+    std::unordered_map<const RE::BGSKeywordForm*, entry> cache_;
+    std::vector<uint64_t> query_;
+    std::vector<uint64_t> merged_;
+  };
+
+  /**
+   * @brief hasAnyKeyword/hasAllKeywords для оберток форм с ключевыми словами.
+   * W::keyword_sources() возвращает формы, ключевые слова которых проверяются.
+   */
+  template<typename W>
+  struct keyword_queries
+  {
+    /**
+     * @brief Проверяет наличие хотя бы одного ключевого слова из списка за один вызов.
+     * @return false для невалидной обертки или пустого списка.
+     */
+    static bool has_any_keyword(W& self, const std::vector<keyword>& keywords)
+    {
+      return self.get() && keyword_bitsets::get_singleton()->has_any(self.keyword_sources(), keywords);
+    }
+
+    /**
+     * @brief Проверяет наличие всех ключевых слов из списка за один вызов.
+     * @return false для невалидной обертки, true для пустого списка.
+     */
+    static bool has_all_keywords(W& self, const std::vector<keyword>& keywords)
+    {
+      return self.get() && keyword_bitsets::get_singleton()->has_all(self.keyword_sources(), keywords);
+    }
+
+    static void bind(wrenbind17::ForeignKlassImpl<W>& cls)
+    {
+      cls.template funcExt<&keyword_queries::has_any_keyword>("hasAnyKeyword");
+      cls.template funcExt<&keyword_queries::has_all_keywords>("hasAllKeywords");
+    }
+  };
+}
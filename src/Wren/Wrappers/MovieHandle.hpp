@@ -0,0 +1,263 @@
+#pragma once
+
+#include "pch.h"
+#include "Wren/Wrappers/GFxConvert.hpp"
+#include "Wren/Wrappers/GFxValue.hpp"
+
+#include <deque>
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Кеш GFxMovieView открытых меню по имени меню.
+   * RE::UI::GetMovieView на каждый вызов создает BSFixedString (блокировка глобальной
+   * таблицы строк) и ищет меню в карте UI, поэтому указатель запоминается до закрытия меню.
+   * Запись сбрасывается из обработчика MenuOpenCloseEvent при закрытии меню.
+   */
+  class movie_view_cache
+  {
+  public:
+    struct entry
+    {
+      std::string menu_name;
+      RE::GPtr<RE::GFxMovieView> view;
+    };
+
+    static movie_view_cache* get_singleton()
+    {
+      static movie_view_cache singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Получает (или создает) запись меню. Запись живет, пока на нее ссылаются MovieHandle.
+     * @param menu_name Имя меню.
+     */
+    std::shared_ptr<entry> entry_of(const std::string_view menu_name)
+    {
+      if (const auto it = entries_.find(menu_name); it != entries_.end()) return it->second;
+
+      auto e = std::make_shared<entry>(std::string(menu_name));
+      entries_.emplace(e->menu_name, e);
+      return e;
+    }
+
+    /**
+     * @brief Получает MovieView меню через кеш.
+     * @param menu_name Имя меню.
+     * @return MovieView или nullptr, если меню не открыто.
+     */
+    RE::GFxMovieView* get(const std::string_view menu_name)
+    {
+      return resolve(*entry_of(menu_name));
+    }
+
+    /**
+     * @brief Возвращает закешированный MovieView записи, при необходимости запрашивая его у UI.
+     */
+    static RE::GFxMovieView* resolve(entry& e)
+    {
+      if (!e.view) {
+        if (const auto ui = RE::UI::GetSingleton()) e.view = ui->GetMovieView(e.menu_name);
+      }
+      return e.view.get();
+    }
+
+    /**
+     * @brief Сбрасывает MovieView меню (при закрытии меню).
+     * @param menu_name Имя меню.
+     */
+    void invalidate(const std::string_view menu_name)
+    {
+      if (const auto it = entries_.find(menu_name); it != entries_.end()) it->second->view.reset();
+    }
+
+  private:
+    struct string_hash
+    {
+      using is_transparent = void;
+      std::size_t operator()(const std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    movie_view_cache() = default;
+
+    std::unordered_map<std::string, std::shared_ptr<entry>, string_hash, std::equal_to<>> entries_;
+  };
+
+  /**
+   * @brief Хендл MovieView меню для скриптов.
+   * Хранит запись movie_view_cache, поэтому повторные вызовы не ищут меню по имени.
+   * После закрытия меню хендл остается пригодным: при следующем открытии MovieView
+   * будет получен заново.
+   */
+  class movie_handle
+  {
+  public:
+    movie_handle() = default;
+
+    explicit movie_handle(std::shared_ptr<movie_view_cache::entry> entry) : entry_(std::move(entry)) {}
+
+    /**
+     * @brief Получает MovieView меню.
+     * @return MovieView или nullptr, если меню не открыто.
+     */
+    [[nodiscard]] RE::GFxMovieView* view() const
+    {
+      return entry_ ? movie_view_cache::resolve(*entry_) : nullptr;
+    }
+
+    /**
+     * @brief Проверяет, открыто ли меню хендла.
+     */
+    [[nodiscard]] bool is_valid() const { return view() != nullptr; }
+
+    /**
+     * @brief Получает имя меню.
+     */
+    [[nodiscard]] std::string get_menu_name() const { return entry_ ? entry_->menu_name : ""; }
+
+    /**
+     * @brief Получает корневой объект (_root) меню.
+     * @return Объект GFxValue или undefined, если меню не открыто.
+     */
+    [[nodiscard]] gfx_value get_root() const { return get_variable(view(), "_root"); }
+
+    /**
+     * @brief Вызывает функцию ActionScript.
+     * @param target Путь к функции.
+     * @param args Список аргументов (значения Wren или GFxValue).
+     */
+    auto invoke(const char* target, const gfx_input& args) const -> wrenbind17::Result<void>
+    {
+      if (!args.ok) return input_error("MovieHandle.invoke");
+      invoke_in(view(), target, args, nullptr);
+      return {};
+    }
+
+    /**
+     * @brief Вызывает функцию ActionScript и возвращает результат.
+     * @param target Путь к функции.
+     * @param args Список аргументов (значения Wren или GFxValue).
+     */
+    [[nodiscard]] auto invoke_result(const char* target, const gfx_input& args) const -> wrenbind17::Result<gfx_value>
+    {
+      if (!args.ok) return input_error("MovieHandle.invokeResult");
+      RE::GFxValue result;
+      invoke_in(view(), target, args, &result);
+      return gfx_value(result);
+    }
+
+    /**
+     * @brief Вызывает функцию ActionScript и переводит результат в значения Wren
+     * (массивы в List, объекты в Map).
+     * @param target Путь к функции.
+     * @param args Список аргументов (значения Wren или GFxValue).
+     */
+    [[nodiscard]] auto call(const char* target, const gfx_input& args) const -> wrenbind17::Result<gfx_output>
+    {
+      if (!args.ok) return input_error("MovieHandle.call");
+      gfx_output result;
+      invoke_in(view(), target, args, &result.value);
+      return result;
+    }
+
+    /**
+     * @brief Строит значение Scaleform из значения Wren за один вызов:
+     * List становится массивом, Map — объектом, вложенные значения переводятся рекурсивно.
+     * @param value Значение Wren.
+     * @return GFxValue или undefined, если меню не открыто.
+     */
+    [[nodiscard]] auto create_value(const gfx_input& value) const -> wrenbind17::Result<gfx_value>
+    {
+      if (!value.ok) return input_error("MovieHandle.createValue");
+      return gfx_value(gfx_arena::get_singleton()->take_value(view(), value));
+    }
+
+    void set_bool(const char* target, bool value) const { set_variable(view(), target, RE::GFxValue(value)); }
+    void set_number(const char* target, double value) const { set_variable(view(), target, RE::GFxValue(value)); }
+    void set_string(const char* target, const char* value) const { set_variable(view(), target, RE::GFxValue(value)); }
+
+    [[nodiscard]] bool get_bool(const char* target) const { return get_bool_in(view(), target); }
+    [[nodiscard]] double get_number(const char* target) const { return get_number_in(view(), target); }
+    [[nodiscard]] std::string get_string(const char* target) const { return get_string_in(view(), target); }
+
+    // Общие операции над MovieView, используются и статическими методами UI
+
+    static void set_variable(RE::GFxMovieView* movie, const char* target, const RE::GFxValue& value)
+    {
+      if (movie) movie->SetVariable(target, value);
+    }
+
+    static gfx_value get_variable(RE::GFxMovieView* movie, const char* target)
+    {
+      RE::GFxValue val;
+      if (movie) movie->GetVariable(&val, target);
+      return gfx_value(val);
+    }
+
+    static bool get_bool_in(RE::GFxMovieView* movie, const char* target)
+    {
+      const auto val = get_variable(movie, target);
+      return val.is_bool() && val.get_bool();
+    }
+
+    static double get_number_in(RE::GFxMovieView* movie, const char* target)
+    {
+      const auto val = get_variable(movie, target);
+      return val.is_number() ? val.get_number() : 0.0;
+    }
+
+    static std::string get_string_in(RE::GFxMovieView* movie, const char* target)
+    {
+      const auto val = get_variable(movie, target);
+      return val.is_string() ? val.get_string() : "";
+    }
+
+    // Ошибка для значения, которое gfx_arena отказалась разбирать
+    static std::unexpected<wrenbind17::ScriptError> input_error(const std::string_view method)
+    {
+      return wrenbind17::scriptError(std::string(method) + ": " + gfx_arena::input_error);
+    }
+
+    static void invoke_in(RE::GFxMovieView* movie, const char* target, const gfx_input& args, RE::GFxValue* result)
+    {
+      // Буфер аргументов на каждую глубину вложенности: ActionScript может через колбэк
+      // снова вызвать скрипт, и вложенный invoke не должен портить аргументы внешнего.
+      // deque не перемещает элементы при росте, ссылка на буфер остается валидной.
+      static std::deque<std::vector<RE::GFxValue>> buffers;
+      static std::size_t depth = 0;
+      if (depth == buffers.size()) buffers.emplace_back();
+      auto& gfx_args = buffers[depth];
+
+      gfx_arena::get_singleton()->take_args(movie, args, gfx_args);
+      ++depth;
+      if (movie) movie->Invoke(target, result, gfx_args.data(), static_cast<uint32_t>(gfx_args.size()));
+      --depth;
+      gfx_args.clear();
+    }
+
+    static void bind(wrenbind17::ForeignModule& module)
+    {
+      auto& cls = module.klass<movie_handle>("MovieHandle");
+      cls.ctor<>();
+      cls.func<&movie_handle::is_valid>("isValid");
+      cls.func<&movie_handle::get_menu_name>("getMenuName");
+      cls.func<&movie_handle::get_root>("getRoot");
+      cls.func<&movie_handle::invoke>("invoke");
+      cls.func<&movie_handle::invoke_result>("invokeResult");
+      cls.func<&movie_handle::call>("call");
+      cls.func<&movie_handle::create_value>("createValue");
+
+      cls.func<&movie_handle::set_bool>("setBool");
+      cls.func<&movie_handle::set_number>("setNumber");
+      cls.func<&movie_handle::set_string>("setString");
+
+      cls.func<&movie_handle::get_bool>("getBool");
+      cls.func<&movie_handle::get_number>("getNumber");
+      cls.func<&movie_handle::get_string>("getString");
+    }
+
+  private:
+    std::shared_ptr<movie_view_cache::entry> entry_;
+  };
+}
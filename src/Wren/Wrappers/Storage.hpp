@@ -0,0 +1,683 @@
+#pragma once
+
+#include "pch.h"
+#include "Wren/Wrappers/Form.hpp"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Значение Wren, закодированное в буфер storage при разборе аргумента foreign-метода.
+   * У метода может быть только один такой аргумент.
+   */
+  struct storage_value
+  {
+    bool ok{false};
+  };
+
+  /**
+   * @brief Закодированное значение storage, при возврате в Wren декодируется в слоты VM.
+   */
+  struct storage_entry
+  {
+    const std::string* bytes{nullptr};
+  };
+
+  /**
+   * @brief Постоянное хранилище значений скриптов в ко-сейве SKSE.
+   * Значения хранятся по пространствам имен (обычно имя мода) и ключам, каждое значение
+   * кодируется в компактный бинарный формат при записи. При сохранении заново собираются
+   * только измененные пространства, остальные пишутся готовым блоком. При загрузке блок
+   * пространства только читается и в нем переназначаются FormID, разбор на записи
+   * происходит при первом обращении к пространству.
+   *
+   * Формат значения: байт тега и данные.
+   * - kNull, kFalse, kTrue — без данных
+   * - kInt — целое число, zigzag varint
+   * - kNumber — double, 8 байт
+   * - kString — varint длины и байты
+   * - kList — varint количества и значения
+   * - kMap — varint количества и пары ключ/значение
+   * - kForm — FormID, 4 байта (фиксированный размер для переназначения на месте)
+   *
+   * Блок пространства: varint количества записей и записи (varint длины ключа, ключ,
+   * varint длины значения, значение). Длина значения позволяет пропустить поврежденную
+   * запись и прочитать следующие. В версии 1 длины значения не было.
+   */
+  class storage
+  {
+  public:
+    static storage* get_singleton()
+    {
+      static storage singleton;
+      return &singleton;
+    }
+
+    /**
+     * @brief Получает значение.
+     * @param space Пространство имен.
+     * @param key Ключ.
+     * @return Значение или null, если ключа нет.
+     */
+    static storage_entry get(std::string_view space, std::string_view key)
+    {
+      const auto s = get_singleton()->find_space(space);
+      if (!s) return {};
+
+      const auto it = s->entries.find(key);
+      return {it != s->entries.end() ? &it->second : nullptr};
+    }
+
+    /**
+     * @brief Записывает значение.
+     * @param space Пространство имен.
+     * @param key Ключ.
+     * @param value Num, Bool, String, null, Form или List/Map из них.
+     */
+    static auto set(std::string_view space, std::string_view key, const storage_value& value) -> wrenbind17::Result<void>
+    {
+      const auto self = get_singleton();
+      if (!value.ok) {
+        return wrenbind17::scriptError("Storage.set: value must be Num, Bool, String, Null, Form or a List/Map of them");
+      }
+
+      auto& s = self->space_of(space);
+      const auto it = s.entries.find(key);
+      if (it != s.entries.end()) {
+        it->second.assign(self->scratch_);
+      } else {
+        s.entries.emplace(std::string(key), self->scratch_);
+      }
+      s.dirty = true;
+      return {};
+    }
+
+    /**
+     * @brief Проверяет наличие ключа.
+     */
+    static bool has(std::string_view space, std::string_view key)
+    {
+      const auto s = get_singleton()->find_space(space);
+      return s && s->entries.contains(key);
+    }
+
+    /**
+     * @brief Удаляет ключ.
+     * @return true, если ключ был.
+     */
+    static bool remove(std::string_view space, std::string_view key)
+    {
+      const auto s = get_singleton()->find_space(space);
+      if (!s) return false;
+
+      const auto it = s->entries.find(key);
+      if (it == s->entries.end()) return false;
+
+      s->entries.erase(it);
+      s->dirty = true;
+      return true;
+    }
+
+    /**
+     * @brief Получает список ключей пространства.
+     */
+    static std::vector<std::string> keys(std::string_view space)
+    {
+      std::vector<std::string> result;
+      if (const auto s = get_singleton()->find_space(space)) {
+        result.reserve(s->entries.size());
+        for (const auto& [key, bytes] : s->entries) result.push_back(key);
+      }
+      return result;
+    }
+
+    /**
+     * @brief Удаляет все ключи пространства.
+     */
+    static void clear(std::string_view space)
+    {
+      if (const auto s = get_singleton()->find_space(space)) {
+        s->entries.clear();
+        s->dirty = true;
+      }
+    }
+
+    /**
+     * @brief Кодирует значение из слота VM в буфер аргумента.
+     * @return false, если значение не поддерживается.
+     */
+    bool encode_argument(WrenVM* vm, const int slot)
+    {
+      scratch_.clear();
+      return encode(vm, slot, scratch_, 0);
+    }
+
+    /**
+     * @brief Кодирует значение из слота VM в out (формат значений storage, см. выше).
+     * @param forms false — формы не допускаются (значение для VM без привязок игры).
+     * @return false, если значение не поддерживается.
+     */
+    static bool encode_value(WrenVM* vm, const int slot, std::string& out, const bool forms)
+    {
+      out.clear();
+      if (!encode(vm, slot, out, 0)) return false;
+      if (forms) return true;
+
+      bool has_form = false;
+      reader r{out.data(), out.data() + out.size()};
+      skip(r, 0, [&](char*) { has_form = true; });
+      return !has_form;
+    }
+
+    /**
+     * @brief Декодирует значение в слот VM. Поврежденные данные и удаленные формы дают null.
+     */
+    static void decode(WrenVM* vm, const int slot, const std::string& bytes)
+    {
+      reader r{bytes.data(), bytes.data() + bytes.size()};
+      if (!decode(vm, slot, r, 0)) wrenSetSlotNull(vm, slot);
+    }
+
+    // Колбэки SKSE::SerializationInterface
+
+    static void on_save(SKSE::SerializationInterface* intfc)
+    {
+      get_singleton()->save(intfc);
+    }
+
+    static void on_load(SKSE::SerializationInterface* intfc)
+    {
+      get_singleton()->load(intfc);
+    }
+
+    static void on_revert(SKSE::SerializationInterface*)
+    {
+      get_singleton()->spaces_.clear();
+    }
+
+    static void bind(wrenbind17::ForeignModule& module)
+    {
+      auto& cls = module.klass<storage>("Storage");
+      cls.funcStatic<&storage::get>("get");
+      cls.funcStatic<&storage::set>("set");
+      cls.funcStatic<&storage::has>("has");
+      cls.funcStatic<&storage::remove>("remove");
+      cls.funcStatic<&storage::keys>("keys");
+      cls.funcStatic<&storage::clear>("clear");
+    }
+
+    // 'WRRM' и 'STOR' как четыре символа, старший байт первый
+    static constexpr uint32_t unique_id = 0x5752524D;
+    static constexpr uint32_t record_type = 0x53544F52;
+    static constexpr uint32_t record_version = 2;
+    // Записи без длины значения, читаются и пересобираются при следующем сохранении
+    static constexpr uint32_t record_version_unframed = 1;
+
+  private:
+    enum class tag : uint8_t
+    {
+      kNull,
+      kFalse,
+      kTrue,
+      kInt,
+      kNumber,
+      kString,
+      kList,
+      kMap,
+      kForm,
+    };
+
+    struct space
+    {
+      // Блок в формате сохранения; актуален, пока пространство не изменено
+      std::string blob;
+      bool parsed{true};
+      bool dirty{false};
+      std::map<std::string, std::string, std::less<>> entries;
+    };
+
+    struct reader
+    {
+      const char* p;
+      const char* end;
+
+      bool read_varint(uint64_t& value)
+      {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64 && p < end; shift += 7) {
+          const auto byte = static_cast<uint8_t>(*p++);
+          value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+          if (!(byte & 0x80)) return true;
+        }
+        return false;
+      }
+
+      bool read_bytes(const std::size_t size, const char*& data)
+      {
+        if (static_cast<std::size_t>(end - p) < size) return false;
+        data = p;
+        p += size;
+        return true;
+      }
+
+      // Запись блока пространства: ключ и значение, каждое с varint длины
+      bool read_entry(std::string_view& key, reader& value)
+      {
+        uint64_t key_length = 0;
+        uint64_t value_length = 0;
+        const char* key_data = nullptr;
+        const char* value_data = nullptr;
+        if (!read_varint(key_length) || !read_bytes(key_length, key_data) || !read_varint(value_length) ||
+            !read_bytes(value_length, value_data)) {
+          return false;
+        }
+        key = {key_data, static_cast<std::size_t>(key_length)};
+        value = {value_data, value_data + value_length};
+        return true;
+      }
+    };
+
+    storage() = default;
+
+    // Ограничение глубины защищает от циклических списков и словарей. Считаются только
+    // List и Map, одинаково в encode, decode и skip: все, что записано, должно читаться
+    static constexpr uint32_t max_depth = 32;
+
+    static void write_varint(std::string& out, uint64_t value)
+    {
+      while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+      }
+      out.push_back(static_cast<char>(value));
+    }
+
+    static void write_bytes(std::string& out, const void* data, const std::size_t size)
+    {
+      out.append(static_cast<const char*>(data), size);
+    }
+
+    static bool encode(WrenVM* vm, const int slot, std::string& out, const uint32_t depth)
+    {
+      switch (wrenGetSlotType(vm, slot)) {
+      case WREN_TYPE_NULL:
+        out.push_back(static_cast<char>(tag::kNull));
+        return true;
+      case WREN_TYPE_BOOL:
+        out.push_back(static_cast<char>(wrenGetSlotBool(vm, slot) ? tag::kTrue : tag::kFalse));
+        return true;
+      case WREN_TYPE_NUM: {
+        const auto value = wrenGetSlotDouble(vm, slot);
+        // Целые (счетчики, ID) занимают 1-5 байт вместо 8; -0 кодируется как double
+        if (std::trunc(value) == value && std::abs(value) <= 2147483648.0 && !(value == 0.0 && std::signbit(value))) {
+          const auto i = static_cast<int64_t>(value);
+          out.push_back(static_cast<char>(tag::kInt));
+          write_varint(out, (static_cast<uint64_t>(i) << 1) ^ static_cast<uint64_t>(i >> 63));
+        } else {
+          out.push_back(static_cast<char>(tag::kNumber));
+          write_bytes(out, &value, sizeof(value));
+        }
+        return true;
+      }
+      case WREN_TYPE_STRING: {
+        int length = 0;
+        const auto bytes = wrenGetSlotBytes(vm, slot, &length);
+        out.push_back(static_cast<char>(tag::kString));
+        write_varint(out, static_cast<uint64_t>(length));
+        write_bytes(out, bytes, static_cast<std::size_t>(length));
+        return true;
+      }
+      case WREN_TYPE_FOREIGN: {
+        if (!wrenbind17::detail::is<form>(vm, slot)) return false;
+        const uint32_t form_id = wrenbind17::detail::PopHelper<const form&>::f(vm, slot).get_form_id();
+        out.push_back(static_cast<char>(tag::kForm));
+        write_bytes(out, &form_id, sizeof(form_id));
+        return true;
+      }
+      case WREN_TYPE_LIST: {
+        if (depth >= max_depth) return false;
+        const auto count = wrenGetListCount(vm, slot);
+        out.push_back(static_cast<char>(tag::kList));
+        write_varint(out, static_cast<uint64_t>(count));
+        wrenEnsureSlots(vm, slot + 2);
+        for (int i = 0; i < count; ++i) {
+          wrenGetListElement(vm, slot, i, slot + 1);
+          if (!encode(vm, slot + 1, out, depth + 1)) return false;
+        }
+        return true;
+      }
+      case WREN_TYPE_MAP: {
+        if (depth >= max_depth) return false;
+        out.push_back(static_cast<char>(tag::kMap));
+        write_varint(out, static_cast<uint64_t>(wrenGetMapCount(vm, slot)));
+        wrenEnsureSlots(vm, slot + 3);
+        for (auto cursor = wrenGetMapNextEntry(vm, slot, -1, slot + 1, slot + 2); cursor >= 0;
+             cursor = wrenGetMapNextEntry(vm, slot, cursor, slot + 1, slot + 2)) {
+          if (!encode(vm, slot + 1, out, depth + 1)) return false;
+          if (!encode(vm, slot + 2, out, depth + 1)) return false;
+        }
+        return true;
+      }
+      default:
+        return false;
+      }
+    }
+
+    static bool decode(WrenVM* vm, const int slot, reader& r, const uint32_t depth)
+    {
+      if (r.p >= r.end) return false;
+
+      switch (static_cast<tag>(*r.p++)) {
+      case tag::kNull:
+        wrenSetSlotNull(vm, slot);
+        return true;
+      case tag::kFalse:
+      case tag::kTrue:
+        wrenSetSlotBool(vm, slot, r.p[-1] == static_cast<char>(tag::kTrue));
+        return true;
+      case tag::kInt: {
+        uint64_t zigzag = 0;
+        if (!r.read_varint(zigzag)) return false;
+        wrenSetSlotDouble(vm, slot, static_cast<double>(static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1)));
+        return true;
+      }
+      case tag::kNumber: {
+        const char* data = nullptr;
+        if (!r.read_bytes(sizeof(double), data)) return false;
+        double value = 0.0;
+        std::memcpy(&value, data, sizeof(value));
+        wrenSetSlotDouble(vm, slot, value);
+        return true;
+      }
+      case tag::kString: {
+        uint64_t length = 0;
+        const char* data = nullptr;
+        if (!r.read_varint(length) || !r.read_bytes(length, data)) return false;
+        wrenSetSlotBytes(vm, slot, data, static_cast<std::size_t>(length));
+        return true;
+      }
+      case tag::kForm: {
+        const char* data = nullptr;
+        if (!r.read_bytes(sizeof(uint32_t), data)) return false;
+        uint32_t form_id = 0;
+        std::memcpy(&form_id, data, sizeof(form_id));
+        if (form_id) {
+          wrenbind17::detail::PushHelper<form>::f(vm, slot, form(form_id));
+        } else {
+          wrenSetSlotNull(vm, slot);
+        }
+        return true;
+      }
+      case tag::kList: {
+        uint64_t count = 0;
+        if (depth >= max_depth || !r.read_varint(count)) return false;
+        wrenEnsureSlots(vm, slot + 2);
+        wrenSetSlotNewList(vm, slot);
+        for (uint64_t i = 0; i < count; ++i) {
+          if (!decode(vm, slot + 1, r, depth + 1)) return false;
+          wrenInsertInList(vm, slot, -1, slot + 1);
+        }
+        return true;
+      }
+      case tag::kMap: {
+        uint64_t count = 0;
+        if (depth >= max_depth || !r.read_varint(count)) return false;
+        wrenEnsureSlots(vm, slot + 3);
+        wrenSetSlotNewMap(vm, slot);
+        for (uint64_t i = 0; i < count; ++i) {
+          if (!decode(vm, slot + 1, r, depth + 1) || !decode(vm, slot + 2, r, depth + 1)) return false;
+          // Ключ мог стать невалидным (например, List), такую пару пропускаем
+          const auto key_type = wrenGetSlotType(vm, slot + 1);
+          if (key_type == WREN_TYPE_LIST || key_type == WREN_TYPE_MAP) continue;
+          wrenSetMapValue(vm, slot, slot + 1, slot + 2);
+        }
+        return true;
+      }
+      default:
+        return false;
+      }
+    }
+
+    // Пропускает значение, вызывая on_form для каждого FormID (указатель на 4 байта в блоке)
+    template<typename Fn>
+    static bool skip(reader& r, const uint32_t depth, Fn&& on_form)
+    {
+      if (r.p >= r.end) return false;
+
+      uint64_t length = 0;
+      const char* data = nullptr;
+      switch (static_cast<tag>(*r.p++)) {
+      case tag::kNull:
+      case tag::kFalse:
+      case tag::kTrue:
+        return true;
+      case tag::kInt:
+        return r.read_varint(length);
+      case tag::kNumber:
+        return r.read_bytes(sizeof(double), data);
+      case tag::kString:
+        return r.read_varint(length) && r.read_bytes(length, data);
+      case tag::kForm:
+        if (!r.read_bytes(sizeof(uint32_t), data)) return false;
+        on_form(const_cast<char*>(data));
+        return true;
+      case tag::kList:
+      case tag::kMap: {
+        const auto per_item = r.p[-1] == static_cast<char>(tag::kMap) ? 2u : 1u;
+        if (depth >= max_depth || !r.read_varint(length)) return false;
+        for (uint64_t i = 0; i < length * per_item; ++i) {
+          if (!skip(r, depth + 1, on_form)) return false;
+        }
+        return true;
+      }
+      default:
+        return false;
+      }
+    }
+
+    space* find_space(const std::string_view name)
+    {
+      const auto it = spaces_.find(name);
+      if (it == spaces_.end()) return nullptr;
+      parse(it->second);
+      return &it->second;
+    }
+
+    space& space_of(const std::string_view name)
+    {
+      if (const auto s = find_space(name)) return *s;
+      return spaces_.emplace(std::string(name), space{}).first->second;
+    }
+
+    // Значение записи целиком и без лишних байт после него
+    template<typename Fn>
+    static bool skip_entry(reader value, Fn&& on_form)
+    {
+      return skip(value, 0, on_form) && value.p == value.end;
+    }
+
+    // Разбор загруженного блока на записи при первом обращении.
+    // Поврежденная запись отбрасывается, следующие читаются
+    static void parse(space& s)
+    {
+      if (s.parsed) return;
+      s.parsed = true;
+
+      reader r{s.blob.data(), s.blob.data() + s.blob.size()};
+      uint64_t count = 0;
+      if (!r.read_varint(count)) return;
+
+      for (uint64_t i = 0; i < count; ++i) {
+        std::string_view key;
+        reader value{};
+        if (!r.read_entry(key, value)) break;
+        if (!skip_entry(value, [](char*) {})) {
+          logger::warn("Storage: dropping corrupted entry {}"sv, key);
+          // Следующее сохранение пересоберет блок без нее
+          s.dirty = true;
+          continue;
+        }
+        s.entries.emplace(std::string(key), std::string(value.p, value.end));
+      }
+    }
+
+    // Блок версии 1: без длины значения, после поврежденной записи читать дальше нельзя
+    static void parse_unframed(space& s, SKSE::SerializationInterface* intfc)
+    {
+      reader r{s.blob.data(), s.blob.data() + s.blob.size()};
+      uint64_t count = 0;
+      if (r.read_varint(count)) {
+        for (uint64_t i = 0; i < count; ++i) {
+          uint64_t key_length = 0;
+          const char* key = nullptr;
+          if (!r.read_varint(key_length) || !r.read_bytes(key_length, key)) break;
+
+          const auto value = r.p;
+          if (!skip(r, 0, [&](char* data) { resolve_form(intfc, data); })) break;
+          s.entries.emplace(std::string(key, key_length), std::string(value, r.p));
+        }
+      }
+      s.blob.clear();
+      s.parsed = true;
+      s.dirty = true;
+    }
+
+    static void resolve_form(SKSE::SerializationInterface* intfc, char* data)
+    {
+      uint32_t form_id = 0;
+      std::memcpy(&form_id, data, sizeof(form_id));
+      if (form_id && !intfc->ResolveFormID(form_id, form_id)) form_id = 0;
+      std::memcpy(data, &form_id, sizeof(form_id));
+    }
+
+    static void build_blob(space& s)
+    {
+      s.blob.clear();
+      write_varint(s.blob, s.entries.size());
+      for (const auto& [key, bytes] : s.entries) {
+        write_varint(s.blob, key.size());
+        s.blob.append(key);
+        write_varint(s.blob, bytes.size());
+        s.blob.append(bytes);
+      }
+      s.dirty = false;
+    }
+
+    void save(SKSE::SerializationInterface* intfc)
+    {
+      uint32_t written = 0;
+      for (auto& [name, s] : spaces_) {
+        if (s.dirty) build_blob(s);
+        if (s.parsed && s.entries.empty()) continue;
+
+        const auto name_size = static_cast<uint32_t>(name.size());
+        const auto blob_size = static_cast<uint32_t>(s.blob.size());
+        if (!intfc->OpenRecord(record_type, record_version) ||
+            !intfc->WriteRecordData(&name_size, sizeof(name_size)) ||
+            !intfc->WriteRecordData(name.data(), name_size) ||
+            !intfc->WriteRecordData(&blob_size, sizeof(blob_size)) ||
+            !intfc->WriteRecordData(s.blob.data(), blob_size)) {
+          logger::error("Storage: failed to write space {}"sv, name);
+          continue;
+        }
+        ++written;
+      }
+      logger::info("Storage: saved {} spaces"sv, written);
+    }
+
+    void load(SKSE::SerializationInterface* intfc)
+    {
+      spaces_.clear();
+
+      uint32_t type = 0;
+      uint32_t version = 0;
+      uint32_t length = 0;
+      while (intfc->GetNextRecordInfo(type, version, length)) {
+        if (type != record_type || (version != record_version && version != record_version_unframed)) {
+          logger::warn("Storage: skipping record {:08X} version {}"sv, type, version);
+          continue;
+        }
+
+        std::string name;
+        space s;
+        if (!read_string(intfc, length, name) || !read_string(intfc, length, s.blob)) {
+          logger::error("Storage: corrupted record"sv);
+          continue;
+        }
+
+        if (version == record_version_unframed) {
+          parse_unframed(s, intfc);
+          spaces_.insert_or_assign(std::move(name), std::move(s));
+          continue;
+        }
+
+        // FormID переназначаются сразу (порядок плагинов мог измениться), остальное разбирается лениво.
+        // Поврежденную запись отбросит parse
+        reader r{s.blob.data(), s.blob.data() + s.blob.size()};
+        uint64_t count = 0;
+        if (r.read_varint(count)) {
+          for (uint64_t i = 0; i < count; ++i) {
+            std::string_view key;
+            reader value{};
+            if (!r.read_entry(key, value)) break;
+            skip(value, 0, [&](char* data) { resolve_form(intfc, data); });
+          }
+        }
+
+        s.parsed = false;
+        spaces_.insert_or_assign(std::move(name), std::move(s));
+      }
+      logger::info("Storage: loaded {} spaces"sv, spaces_.size());
+    }
+
+    // Строка записи: uint32 длины и байты
+    static bool read_string(SKSE::SerializationInterface* intfc, const uint32_t record_length, std::string& out)
+    {
+      uint32_t size = 0;
+      if (intfc->ReadRecordData(&size, sizeof(size)) != sizeof(size) || size > record_length) return false;
+      out.resize(size);
+      return intfc->ReadRecordData(out.data(), size) == size;
+    }
+
+    std::map<std::string, space, std::less<>> spaces_;
+    std::string scratch_;
+  };
+}
+
+namespace wrenbind17::detail
+{
+  template<>
+  struct PopHelper<wren::wrappers::storage_value>
+  {
+    static wren::wrappers::storage_value f(WrenVM* vm, const int idx)
+    {
+      return {wren::wrappers::storage::get_singleton()->encode_argument(vm, idx)};
+    }
+  };
+
+  template<>
+  struct PopHelper<const wren::wrappers::storage_value&> : PopHelper<wren::wrappers::storage_value>
+  {
+  };
+
+  // Поддерживаемость значения проверяется при кодировании, ошибку возвращает Storage.set
+  template<>
+  struct ArgCheck<wren::wrappers::storage_value>
+  {
+    static constexpr bool exact = true;
+
+    static const char* f(WrenVM*, int) { return nullptr; }
+  };
+
+  template<>
+  struct PushHelper<wren::wrappers::storage_entry>
+  {
+    static void f(WrenVM* vm, const int idx, const wren::wrappers::storage_entry& value)
+    {
+      if (value.bytes) {
+        wren::wrappers::storage::decode(vm, idx, *value.bytes);
+      } else {
+        wrenSetSlotNull(vm, idx);
+      }
+    }
+  };
+}
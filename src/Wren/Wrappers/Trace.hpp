@@ -0,0 +1,47 @@
+#pragma once
+
+#include "pch.h"
+#include "Wren/Tracer.hpp"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Зоны скриптов на временной шкале трассировки (см. wren::tracing::tracer).
+   * Вне захвата методы ничего не делают.
+   */
+  class trace
+  {
+  public:
+    /**
+     * @brief Открывает зону.
+     * @param name Имя зоны.
+     */
+    static void begin(std::string_view name)
+    {
+      if (!tracing::tracer::capturing()) return;
+      tracing::tracer::get_singleton()->script_begin(name);
+    }
+
+    /**
+     * @brief Закрывает последнюю открытую зону.
+     */
+    static void end()
+    {
+      if (!tracing::tracer::capturing()) return;
+      tracing::tracer::get_singleton()->script_end();
+    }
+
+    /**
+     * @brief Проверяет, идет ли захват.
+     */
+    static bool is_capturing() { return tracing::tracer::capturing(); }
+
+    static void bind(wrenbind17::ForeignModule& module)
+    {
+      auto& cls = module.klass<trace>("Trace");
+      cls.funcStatic<&trace::begin>("begin");
+      cls.funcStatic<&trace::end>("end");
+      cls.funcStatic<&trace::is_capturing>("isCapturing");
+    }
+  };
+}
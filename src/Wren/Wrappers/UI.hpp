@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Wren/Wrappers/GFxValue.hpp"
+#include "Wren/Wrappers/MovieHandle.hpp"
 #include "pch.h"
 
 namespace wren::wrappers
@@ -17,7 +18,7 @@ namespace wren::wrappers
      * @param menu_name Имя меню (например, "InventoryMenu").
      * @return true, если меню открыто.
      */
-    static bool is_menu_open(const std::string& menu_name)
+    static bool is_menu_open(const char* menu_name)
     {
       auto ui = RE::UI::GetSingleton();
       return ui ? ui->IsMenuOpen(menu_name) : false;
@@ -28,67 +29,92 @@ namespace wren::wrappers
      * @param menu_name Имя меню.
      * @return Объект GFxValue, представляющий _root меню, или undefined, если меню не найдено.
      */
-    static gfx_value get_movie_view(const std::string& menu_name)
+    static gfx_value get_movie_view(const char* menu_name)
     {
-        auto ui = RE::UI::GetSingleton();
-        if (!ui) return gfx_value();
+      return movie_handle::get_variable(movie_of(menu_name), "_root");
+    }
+
+    /**
+     * @brief Получает хендл MovieView меню. Хендл кеширует MovieView до закрытия меню,
+     * поэтому его стоит сохранить и использовать вместо вызовов по имени меню.
+     * @param menu_name Имя меню.
+     * @return Хендл MovieView.
+     */
+    static movie_handle get_movie(const char* menu_name)
+    {
+      return movie_handle(movie_view_cache::get_singleton()->entry_of(menu_name));
+    }
 
-        auto movie = ui->GetMovieView(menu_name);
-        if (!movie) return gfx_value();
+    /**
+     * @brief Применяет пакет изменений к меню за один вызов.
+     * Список состоит из пар [путь, значение, путь, значение, ...] и разбирается прямо из слотов VM.
+     * Список в качестве значения вызывает функцию по пути с его элементами как аргументами
+     * (как invoke), любое другое значение устанавливается как переменная.
+     * @param movie Хендл MovieView.
+     * @param ops Пары путь/значение.
+     */
+    static auto apply(const movie_handle& movie, const gfx_input& ops) -> wrenbind17::Result<void>
+    {
+      // Пакет на каждую глубину вложенности, как аргументы в movie_handle::invoke_in
+      static std::deque<gfx_batch> batches;
+      static std::size_t depth = 0;
+      if (depth == batches.size()) batches.emplace_back();
+      auto& batch = batches[depth];
+
+      const auto view = movie.view();
+      if (const auto error = gfx_arena::get_singleton()->take_batch(view, ops, batch)) {
+        return wrenbind17::scriptError(error);
+      }
+
+      ++depth;
+      for (const auto& op : batch.ops) {
+        const auto path = batch.paths.data() + op.path;
+        if (op.call) view->Invoke(path, nullptr, batch.values.data() + op.first, op.count);
+        else view->SetVariable(path, batch.values[op.first]);
+      }
+      --depth;
+      batch.clear();
+      return {};
+    }
 
-        // Return the root of the movie view as a GFxValue
-        RE::GFxValue root;
-        movie->GetVariable(&root, "_root");
-        return gfx_value(root);
+    /**
+     * @brief Переводит GFxValue в значения Wren за один вызов: массивы становятся List,
+     * объекты — Map, вложенные значения переводятся рекурсивно.
+     * @param value Значение Scaleform.
+     * @return Значение Wren.
+     */
+    static gfx_output to_value(const gfx_value& value)
+    {
+      return {value.get()};
     }
 
     /**
      * @brief Вызывает функцию ActionScript в указанном меню.
      * @param menu_name Имя меню.
      * @param target Путь к функции (например, "_root.MyFunction").
-     * @param args Список аргументов для функции.
+     * @param args Список аргументов для функции (значения Wren или GFxValue).
      */
-    static void invoke(const std::string& menu_name, const std::string& target, const std::vector<gfx_value>& args)
+    static auto invoke(const char* menu_name, const char* target, const gfx_input& args) -> wrenbind17::Result<void>
     {
-        auto ui = RE::UI::GetSingleton();
-        if (!ui) return;
-
-        auto movie = ui->GetMovieView(menu_name);
-        if (!movie) return;
-
-        std::vector<RE::GFxValue> gfx_args;
-        gfx_args.reserve(args.size());
-        for (const auto& arg : args) {
-            gfx_args.push_back(arg.get());
-        }
-
-        movie->Invoke(target.c_str(), nullptr, gfx_args.data(), static_cast<uint32_t>(gfx_args.size()));
+      if (!args.ok) return movie_handle::input_error("UI.invoke");
+      movie_handle::invoke_in(movie_of(menu_name), target, args, nullptr);
+      return {};
     }
 
     /**
      * @brief Вызывает функцию ActionScript в указанном меню и возвращает результат.
      * @param menu_name Имя меню.
      * @param target Путь к функции.
-     * @param args Список аргументов.
+     * @param args Список аргументов (значения Wren или GFxValue).
      * @return Результат выполнения функции как GFxValue.
      */
-    static gfx_value invoke_result(const std::string& menu_name, const std::string& target, const std::vector<gfx_value>& args)
+    static auto invoke_result(const char* menu_name, const char* target, const gfx_input& args)
+      -> wrenbind17::Result<gfx_value>
     {
-        auto ui = RE::UI::GetSingleton();
-        if (!ui) return gfx_value();
-
-        auto movie = ui->GetMovieView(menu_name);
-        if (!movie) return gfx_value();
-
-        std::vector<RE::GFxValue> gfx_args;
-        gfx_args.reserve(args.size());
-        for (const auto& arg : args) {
-            gfx_args.push_back(arg.get());
-        }
-
-        RE::GFxValue result;
-        movie->Invoke(target.c_str(), &result, gfx_args.data(), static_cast<uint32_t>(gfx_args.size()));
-        return gfx_value(result);
+      if (!args.ok) return movie_handle::input_error("UI.invokeResult");
+      RE::GFxValue result;
+      movie_handle::invoke_in(movie_of(menu_name), target, args, &result);
+      return gfx_value(result);
     }
 
     /**
@@ -97,15 +123,9 @@ namespace wren::wrappers
      * @param target Путь к переменной.
      * @param value Значение.
      */
-    static void set_bool(const std::string& menu_name, const std::string& target, bool value)
+    static void set_bool(const char* menu_name, const char* target, bool value)
     {
-         auto ui = RE::UI::GetSingleton();
-        if (!ui) return;
-        auto movie = ui->GetMovieView(menu_name);
-        if (!movie) return;
-
-        RE::GFxValue val(value);
-        movie->SetVariable(target.c_str(), val);
+      movie_handle::set_variable(movie_of(menu_name), target, RE::GFxValue(value));
     }
 
     /**
@@ -114,15 +134,9 @@ namespace wren::wrappers
      * @param target Путь к переменной.
      * @param value Значение.
      */
-    static void set_number(const std::string& menu_name, const std::string& target, double value)
+    static void set_number(const char* menu_name, const char* target, double value)
     {
-         auto ui = RE::UI::GetSingleton();
-        if (!ui) return;
-        auto movie = ui->GetMovieView(menu_name);
-        if (!movie) return;
-
-        RE::GFxValue val(value);
-        movie->SetVariable(target.c_str(), val);
+      movie_handle::set_variable(movie_of(menu_name), target, RE::GFxValue(value));
     }
 
     /**
@@ -131,15 +145,9 @@ namespace wren::wrappers
      * @param target Путь к переменной.
      * @param value Значение.
      */
-    static void set_string(const std::string& menu_name, const std::string& target, const std::string& value)
+    static void set_string(const char* menu_name, const char* target, const char* value)
     {
-         auto ui = RE::UI::GetSingleton();
-        if (!ui) return;
-        auto movie = ui->GetMovieView(menu_name);
-        if (!movie) return;
-
-        RE::GFxValue val(value.c_str());
-        movie->SetVariable(target.c_str(), val);
+      movie_handle::set_variable(movie_of(menu_name), target, RE::GFxValue(value));
     }
 
     /**
@@ -148,18 +156,9 @@ namespace wren::wrappers
      * @param target Путь к переменной.
      * @return Значение переменной или false, если не найдена.
      */
-    static bool get_bool(const std::string& menu_name, const std::string& target)
+    static bool get_bool(const char* menu_name, const char* target)
     {
-        auto ui = RE::UI::GetSingleton();
-        if (!ui) return false;
-        auto movie = ui->GetMovieView(menu_name);
-        if (!movie) return false;
-
-        RE::GFxValue val;
-        if (movie->GetVariable(&val, target.c_str())) {
-            return val.GetBool();
-        }
-        return false;
+      return movie_handle::get_bool_in(movie_of(menu_name), target);
     }
 
     /**
@@ -168,18 +167,9 @@ namespace wren::wrappers
      * @param target Путь к переменной.
      * @return Значение переменной или 0.0.
      */
-    static double get_number(const std::string& menu_name, const std::string& target)
+    static double get_number(const char* menu_name, const char* target)
     {
-        auto ui = RE::UI::GetSingleton();
-        if (!ui) return 0.0;
-        auto movie = ui->GetMovieView(menu_name);
-        if (!movie) return 0.0;
-
-        RE::GFxValue val;
-        if (movie->GetVariable(&val, target.c_str())) {
-            return val.GetNumber();
-        }
-        return 0.0;
+      return movie_handle::get_number_in(movie_of(menu_name), target);
     }
 
     /**
@@ -188,27 +178,20 @@ namespace wren::wrappers
      * @param target Путь к переменной.
      * @return Значение переменной или пустая строка.
      */
-    static std::string get_string(const std::string& menu_name, const std::string& target)
+    static std::string get_string(const char* menu_name, const char* target)
     {
-        auto ui = RE::UI::GetSingleton();
-        if (!ui) return "";
-        auto movie = ui->GetMovieView(menu_name);
-        if (!movie) return "";
-
-        RE::GFxValue val;
-        if (movie->GetVariable(&val, target.c_str())) {
-            return val.GetString();
-        }
-        return "";
+      return movie_handle::get_string_in(movie_of(menu_name), target);
     }
 
-
     static void bind(wrenbind17::ForeignModule& module)
     {
       auto& cls = module.klass<ui>("UI");
       // Static methods only for UI singleton access
       cls.funcStatic<&ui::is_menu_open>("isMenuOpen");
       cls.funcStatic<&ui::get_movie_view>("getMovieView"); // Returns root GFxValue
+      cls.funcStatic<&ui::get_movie>("getMovie");
+      cls.funcStatic<&ui::apply>("apply");
+      cls.funcStatic<&ui::to_value>("toValue");
       cls.funcStatic<&ui::invoke>("invoke");
       cls.funcStatic<&ui::invoke_result>("invokeResult");
 
@@ -220,5 +203,11 @@ namespace wren::wrappers
       cls.funcStatic<&ui::get_number>("getNumber");
       cls.funcStatic<&ui::get_string>("getString");
     }
+
+  private:
+    static RE::GFxMovieView* movie_of(const char* menu_name)
+    {
+      return movie_view_cache::get_singleton()->get(menu_name);
+    }
   };
 }
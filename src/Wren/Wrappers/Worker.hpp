@@ -0,0 +1,110 @@
+#pragma once
+
+#include "pch.h"
+#include "Wren/Worker.hpp"
+
+namespace wren::wrappers
+{
+  /**
+   * @brief Воркер со стороны главной VM (см. wren::workers::pool).
+   * Ответы воркера приходят событиями OnWorkerMessage(worker, message) и
+   * OnWorkerError(worker, error) в начале кадра.
+   */
+  class worker
+  {
+  public:
+    worker(std::shared_ptr<workers::worker_state> state) : state_(std::move(state)) {}
+
+    /**
+     * @brief Конструктор по умолчанию. Создает невалидного воркера.
+     */
+    worker() = default;
+
+    /**
+     * @brief Создает воркера со скриптом из WrenMods/Workers.
+     * @param name Имя скрипта без расширения.
+     * @return Воркер или невалидный воркер (isRunning() == false), если скрипта нет.
+     * Ошибка скрипта, если потоки пула не удалось запустить.
+     */
+    static auto spawn(const std::string& name) -> wrenbind17::Result<worker>
+    {
+      auto state = workers::pool::get_singleton()->spawn(name);
+      if (!state) return wrenbind17::scriptError(state.error().message);
+      return worker(std::move(*state));
+    }
+
+    /**
+     * @brief Отправляет сообщение воркеру.
+     * @param message Num, Bool, String, null или List/Map из них.
+     */
+    auto post(const workers::message_value& message) const -> wrenbind17::Result<void>
+    {
+      if (!message.ok) {
+        return wrenbind17::scriptError("Worker.post: message must be Num, Bool, String, Null or a List/Map of them");
+      }
+      if (!is_running()) return wrenbind17::scriptError("Worker.post: worker is terminated");
+      if (!workers::pool::get_singleton()->post(state_, message.bytes)) {
+        return wrenbind17::scriptError("Worker.post: inbox is full");
+      }
+      return {};
+    }
+
+    /**
+     * @brief Останавливает воркера. Сообщения в очереди отбрасываются.
+     */
+    void terminate() const { workers::pool::get_singleton()->terminate(state_); }
+
+    /**
+     * @brief Воркер не остановлен. Скрипт загружается потоком пула с первой задачей,
+     * ошибка загрузки останавливает воркера.
+     */
+    [[nodiscard]] bool is_running() const
+    {
+      return state_ && !state_->terminated.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::string get_name() const { return state_ ? state_->name : std::string(); }
+
+    /**
+     * @brief Сообщений в очереди воркера.
+     */
+    [[nodiscard]] std::size_t get_pending() const
+    {
+      if (!state_) return 0;
+      std::scoped_lock lock(state_->lock);
+      return state_->inbox.size();
+    }
+
+    [[nodiscard]] std::uint32_t get_id() const { return state_ ? state_->id : 0; }
+
+    static void bind(wrenbind17::ForeignModule& module)
+    {
+      auto& cls = module.klass<worker>("Worker");
+      cls.funcStatic<&worker::spawn>("spawn");
+      cls.func<&worker::post>("post");
+      cls.func<&worker::terminate>("terminate_");
+      cls.func<&worker::is_running>("isRunning");
+      cls.func<&worker::get_name>("getName");
+      cls.func<&worker::get_pending>("getPending");
+      cls.func<&worker::get_id>("getId");
+    }
+
+  private:
+    std::shared_ptr<workers::worker_state> state_;
+  };
+}
+
+namespace wrenbind17
+{
+  template<>
+  struct ForeignInline<wren::wrappers::worker> : std::true_type
+  {
+  };
+
+  // Событие приносит тот же объект Worker, что вернул spawn: его можно сравнить через ==
+  template<>
+  struct ForeignIdentity<wren::wrappers::worker> : std::true_type
+  {
+    static std::uint64_t key(const wren::wrappers::worker& w) { return w.get_id(); }
+  };
+}
@@ -1,15 +1,29 @@
 #pragma once
 
 #include "Wren/Wrappers/ActiveEffect.hpp"
+#include "Wren/Wrappers/ActiveEffectIndex.hpp"
 #include "Wren/Wrappers/Actor.hpp"
+#include "Wren/Wrappers/ActorArray.hpp"
+#include "Wren/Wrappers/ActorGrid.hpp"
+#include "Wren/Wrappers/ActorHandleCache.hpp"
+#include "Wren/Wrappers/ActorValueBuffer.hpp"
+#include "Wren/Wrappers/ActorValueTable.hpp"
 #include "Wren/Wrappers/AlchemyItem.hpp"
 #include "Wren/Wrappers/Armor.hpp"
+#include "Wren/Wrappers/Commands.hpp"
 #include "Wren/Wrappers/Effect.hpp"
+#include "Wren/Wrappers/Form.hpp"
 #include "Wren/Wrappers/Game.hpp"
+#include "Wren/Wrappers/GFxConvert.hpp"
 #include "Wren/Wrappers/GFxValue.hpp"
 #include "Wren/Wrappers/HitData.hpp"
 #include "Wren/Wrappers/Keyword.hpp"
+#include "Wren/Wrappers/KeywordBitsets.hpp"
+#include "Wren/Wrappers/MovieHandle.hpp"
 #include "Wren/Wrappers/Setting.hpp"
 #include "Wren/Wrappers/Spell.hpp"
+#include "Wren/Wrappers/Storage.hpp"
+#include "Wren/Wrappers/Trace.hpp"
 #include "Wren/Wrappers/UI.hpp"
 #include "Wren/Wrappers/Weapon.hpp"
+#include "Wren/Wrappers/Worker.hpp"
@@ -4,6 +4,7 @@
 #include <stdarg.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // The Wren semantic version number components.
 #define WREN_VERSION_MAJOR 0
@@ -130,6 +131,38 @@ typedef void (*WrenErrorFn)(
     WrenVM* vm, WrenErrorType type, const char* module, int line,
     const char* message);
 
+// Called by the interpreter while sampling is enabled by [wrenSetSampling()].
+//
+// It runs on the thread that runs the VM, in the middle of executing code, so
+// it may only inspect the call stack with [wrenGetStackFrameCount()] and
+// [wrenGetStackFrame()]. It must not use slots or call into the VM.
+typedef void (*WrenSampleFn)(WrenVM* vm);
+
+// Called by [wrenGetModuleAllocations()] for each loaded module. [module] is
+// NULL for allocations made while no module code was executing.
+typedef void (*WrenModuleAllocationsFn)(void* userData, const char* module,
+                                        size_t bytes, size_t count);
+
+// Called by [wrenHeapSnapshot()] for each live object. [owner] is the root
+// group that first reached the object, [module] is the module whose code
+// created it (NULL if none was executing, module attribution was off, or it
+// was created by one of the modules loaded after the first 65534) and [type]
+// is the name of its class.
+typedef void (*WrenHeapVisitFn)(void* userData, const char* owner,
+                                const char* module, const char* type,
+                                size_t bytes);
+
+typedef enum
+{
+  WREN_GC_BEGIN,
+  WREN_GC_END
+} WrenGCPhase;
+
+// Reports a garbage collection. It is called with `WREN_GC_BEGIN` and the
+// number of bytes allocated before the collection starts, then with
+// `WREN_GC_END` and the number of bytes still in use once it is done.
+typedef void (*WrenGCFn)(WrenVM* vm, WrenGCPhase phase, size_t bytesAllocated);
+
 typedef struct
 {
   // The callback invoked when the foreign object is created.
@@ -232,6 +265,12 @@ typedef struct
   // errors.
   WrenErrorFn errorFn;
 
+  // The callback Wren uses to report the start and end of each garbage
+  // collection.
+  //
+  // If this is `NULL`, collections are not reported.
+  WrenGCFn gcFn;
+
   // The number of bytes Wren will allocate before triggering the first garbage
   // collection.
   //
@@ -324,6 +363,24 @@ WREN_API void wrenCollectGarbage(WrenVM* vm);
 WREN_API WrenInterpretResult wrenInterpret(WrenVM* vm, const char* module,
                                   const char* source);
 
+// Compiles [source] in the context of [module] without running it, creating
+// the module if it isn't loaded yet, and returns a handle to the compiled
+// function. Invoke it with a "call()" handle and [wrenCall], as many times as
+// needed.
+//
+// If [isExpression] is true, [source] must be a single expression and the
+// function returns its value. Otherwise it is a sequence of statements, the
+// function returns null, and top-level variables it defines stay in [module].
+//
+// Returns NULL on a compile error, which is passed to the error callback if
+// [reportErrors] is true.
+//
+// When you are done with this handle, it must be released using
+// [wrenReleaseHandle].
+WREN_API WrenHandle* wrenCompileInModule(WrenVM* vm, const char* module,
+                                         const char* source, bool isExpression,
+                                         bool reportErrors);
+
 // Creates a handle that can be used to invoke a method with [signature] on
 // using a receiver and arguments that are set up on the stack.
 //
@@ -445,6 +502,78 @@ WREN_API const char* wrenGetSlotString(WrenVM* vm, int slot);
 // until the handle is released by calling [wrenReleaseHandle()].
 WREN_API WrenHandle* wrenGetSlotHandle(WrenVM* vm, int slot);
 
+// Returns an opaque pointer to the object stored in [slot], or NULL if the
+// slot does not hold an object.
+//
+// Unlike [wrenGetSlotHandle()] this does not keep the object alive. It is meant
+// for weak caches that forget the pointer from the object's finalizer.
+WREN_API void* wrenGetSlotObject(WrenVM* vm, int slot);
+
+// Looks up where the function stored in [slot] was defined.
+//
+// Returns false if the slot does not hold a function. Otherwise stores the
+// resolved name of its module in [module] and the line of its first
+// instruction in [line]. The module name is owned by the VM and stays valid
+// for as long as the module is loaded.
+WREN_API bool wrenGetSlotFnSource(WrenVM* vm, int slot, const char** module, int* line);
+
+// Enables sampling: the interpreter counts method calls and loop iterations
+// and calls [sampleFn] every [interval] of them. An [interval] of zero turns
+// sampling off, which leaves a single branch on those paths.
+//
+// Must be called from the thread that runs the VM.
+WREN_API void wrenSetSampling(WrenVM* vm, uint32_t interval, WrenSampleFn sampleFn);
+
+// Turns attribution of allocations to modules on or off. It's off by default,
+// since it walks the call frames each time an object is created. While it's
+// off, [wrenGetModuleAllocations()] totals don't grow and objects created are
+// reported by [wrenHeapSnapshot()] with a NULL module. Enable it before
+// loading the modules to be measured.
+WREN_API void wrenSetModuleAttribution(WrenVM* vm, bool enabled);
+
+// Reports the memory each module has allocated since attribution was enabled
+// (see [wrenSetModuleAttribution()]). Each new object is attributed to the
+// module of the function executing when it was created, along with the bytes
+// requested since the previous object, so growth of existing buffers goes to
+// the module that creates the next object. Freed memory is not subtracted,
+// so this is allocation volume, not live size; use [wrenHeapSnapshot()] for
+// the latter.
+WREN_API void wrenGetModuleAllocations(WrenVM* vm, WrenModuleAllocationsFn fn,
+                                       void* userData);
+
+// Collects garbage, then walks every live object from the GC roots and calls
+// [fn] for each one. Roots are walked in groups, and an object is reported
+// under the first group that reaches it:
+//
+// - "core", then each other module by name, for top-level variables.
+// - "<handles>" for objects held by the host through [WrenHandle]s.
+// - "<fiber>" for the current fiber.
+// - "<vm>" for everything else the VM keeps alive internally.
+//
+// Reachability says what keeps an object alive, while [module] says who
+// created it: a mod's event listeners are reached through the "Events" module
+// but created by the mod.
+//
+// Sizes match what the garbage collector counts. Foreign object payloads are
+// not included since the VM doesn't know their size.
+//
+// Must not be called while the VM is running code.
+WREN_API void wrenHeapSnapshot(WrenVM* vm, WrenHeapVisitFn fn, void* userData);
+
+// Returns the number of call frames in the current fiber, or zero if no fiber
+// is running.
+WREN_API int wrenGetStackFrameCount(WrenVM* vm);
+
+// Looks up call frame [index] of the current fiber, where zero is the
+// innermost frame.
+//
+// Returns false for frames that do not belong to a module (stubs used to call
+// methods from the C API). Otherwise stores the module name ("core" for the
+// built-in module), the function name and the line being executed. The
+// strings are owned by the VM.
+WREN_API bool wrenGetStackFrame(WrenVM* vm, int index, const char** module,
+                                const char** function, int* line);
+
 // Stores the boolean [value] in [slot].
 WREN_API void wrenSetSlotBool(WrenVM* vm, int slot, bool value);
 
@@ -490,6 +619,11 @@ WREN_API void wrenSetSlotString(WrenVM* vm, int slot, const char* text);
 // This does not release the handle for the value.
 WREN_API void wrenSetSlotHandle(WrenVM* vm, int slot, WrenHandle* handle);
 
+// Stores an object previously returned by [wrenGetSlotObject()] in [slot].
+//
+// It is an error to call this after the object has been garbage collected.
+WREN_API void wrenSetSlotObject(WrenVM* vm, int slot, void* object);
+
 // Returns the number of elements in the list stored in [slot].
 WREN_API int wrenGetListCount(WrenVM* vm, int slot);
 
@@ -518,6 +652,15 @@ WREN_API bool wrenGetMapContainsKey(WrenVM* vm, int mapSlot, int keySlot);
 // stores it in [valueSlot].
 WREN_API void wrenGetMapValue(WrenVM* vm, int mapSlot, int keySlot, int valueSlot);
 
+// Iterates the entries of the map in [mapSlot]. Pass -1 as [cursor] to start
+// from the first entry.
+//
+// Stores the key and value of the next entry in [keySlot] and [valueSlot] and
+// returns the cursor to pass to the following call, or -1 if there are no
+// more entries. The map must not be modified during the iteration.
+WREN_API int wrenGetMapNextEntry(WrenVM* vm, int mapSlot, int cursor,
+                                 int keySlot, int valueSlot);
+
 // Takes the value stored at [valueSlot] and inserts it into the map stored
 // at [mapSlot] with key [keySlot].
 WREN_API void wrenSetMapValue(WrenVM* vm, int mapSlot, int keySlot, int valueSlot);
@@ -3843,7 +3843,18 @@ ObjFn* wrenCompile(WrenVM* vm, ObjModule* module, const char* source,
     }
   }
   
-  return endCompiler(&compiler, "(script)", 8);
+  ObjFn* fn = endCompiler(&compiler, "(script)", 8);
+
+  // If compiling failed, drop the variables it declared so the module is left
+  // as it was. Otherwise a later compile into the same module (a REPL, for
+  // example) would see implicitly declared names as defined.
+  if (fn == NULL)
+  {
+    parser.module->variables.count = numExistingVariables;
+    parser.module->variableNames.count = numExistingVariables;
+  }
+
+  return fn;
 }
 
 void wrenBindMethodCode(ObjClass* classObj, ObjFn* fn)
@@ -38,6 +38,27 @@ static void initObj(WrenVM* vm, Obj* obj, ObjType type, ObjClass* classObj)
 {
   obj->type = type;
   obj->isDark = false;
+
+  obj->module = 0;
+  if (vm->attributeModules)
+  {
+    // Charge the object, and any buffer growth since the last one, to the
+    // module whose code is executing.
+    ObjModule* module = wrenAllocatingModule(vm);
+    if (module != NULL)
+    {
+      obj->module = module->id;
+      module->allocatedBytes += vm->pendingAllocatedBytes;
+      module->allocationCount++;
+    }
+    else
+    {
+      vm->hostAllocatedBytes += vm->pendingAllocatedBytes;
+      vm->hostAllocationCount++;
+    }
+    vm->pendingAllocatedBytes = 0;
+  }
+
   obj->classObj = classObj;
   obj->next = vm->first;
   vm->first = obj;
@@ -419,6 +440,11 @@ static uint32_t hashObject(Obj* object)
     case OBJ_STRING:
       return ((ObjString*)object)->hash;
 
+    // Foreign instances compare by identity, so hash the object address. Hosts
+    // that want value semantics hand out one instance per native object.
+    case OBJ_FOREIGN:
+      return hashBits((uint64_t)(uintptr_t)object);
+
     default:
       ASSERT(false, "Only immutable objects can be hashed.");
       return 0;
@@ -426,7 +452,8 @@ static uint32_t hashObject(Obj* object)
 }
 
 // Generates a hash code for [value], which must be one of the built-in
-// immutable types: null, bool, class, num, range, or string.
+// immutable types: null, bool, class, num, range, or string, or a foreign
+// instance.
 static uint32_t hashValue(Value value)
 {
   // TODO: We'll probably want to randomize this at some point.
@@ -655,6 +682,10 @@ ObjModule* wrenNewModule(WrenVM* vm, ObjString* name)
   wrenValueBufferInit(&module->variables);
 
   module->name = name;
+  module->id = vm->lastModuleId < UINT16_MAX - 1 ? ++vm->lastModuleId
+                                                 : UINT16_MAX;
+  module->allocatedBytes = 0;
+  module->allocationCount = 0;
 
   wrenPopRoot(vm);
   return module;
@@ -1226,6 +1257,22 @@ void wrenBlackenObjects(WrenVM* vm)
   }
 }
 
+void wrenBlackenObjectsVisit(WrenVM* vm,
+                             void (*visit)(WrenVM* vm, Obj* obj, size_t bytes,
+                                           void* userData),
+                             void* userData)
+{
+  while (vm->grayCount > 0)
+  {
+    Obj* obj = vm->gray[--vm->grayCount];
+
+    // Blackening adds the object's size to the running total.
+    size_t before = vm->bytesAllocated;
+    blackenObject(vm, obj);
+    visit(vm, obj, vm->bytesAllocated - before, userData);
+  }
+}
+
 void wrenFreeObj(WrenVM* vm, Obj* obj)
 {
 #if WREN_DEBUG_TRACE_MEMORY
@@ -111,6 +111,11 @@ struct sObj
   ObjType type;
   bool isDark;
 
+  // The [ObjModule.id] of the module whose code was executing when the object
+  // was created, or zero if none was or [WrenVM.attributeModules] was off.
+  // Fits in padding, so it's free.
+  uint16_t module;
+
   // The object's class.
   ObjClass* classObj;
 
@@ -234,6 +239,18 @@ typedef struct
 
   // The name of the module.
   ObjString* name;
+
+  // Identifies the module in [Obj.module]. Unique within a VM, starting at 1.
+  // Once the ids run out, later modules all get UINT16_MAX, which is never
+  // handed out as a unique id and has no name in heap snapshots.
+  uint16_t id;
+
+  // Bytes requested from wrenReallocate() (new objects and growth of existing
+  // buffers) charged to this module when it created an object, and the number
+  // of objects it created. Only counted while [WrenVM.attributeModules] is set.
+  // Freed memory is not subtracted.
+  size_t allocatedBytes;
+  size_t allocationCount;
 } ObjModule;
 
 // A function object. It wraps and owns the bytecode and other debug information
@@ -787,6 +804,13 @@ void wrenGrayBuffer(WrenVM* vm, ValueBuffer* buffer);
 // (in use and fully traversed).
 void wrenBlackenObjects(WrenVM* vm);
 
+// Like [wrenBlackenObjects], but calls [visit] for each processed object with
+// the number of bytes it was counted as while marking.
+void wrenBlackenObjectsVisit(WrenVM* vm,
+                             void (*visit)(WrenVM* vm, Obj* obj, size_t bytes,
+                                           void* userData),
+                             void* userData);
+
 // Releases all memory owned by [obj], including [obj] itself.
 void wrenFreeObj(WrenVM* vm, Obj* obj);
 
@@ -884,7 +908,8 @@ static inline bool wrenMapIsValidKey(Value arg)
       || IS_NULL(arg)
       || IS_NUM(arg)
       || IS_RANGE(arg)
-      || IS_STRING(arg);
+      || IS_STRING(arg)
+      || IS_FOREIGN(arg);
 }
 
 #endif
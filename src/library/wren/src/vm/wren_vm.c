@@ -50,6 +50,7 @@ void wrenInitConfiguration(WrenConfiguration* config)
   config->bindForeignClassFn = NULL;
   config->writeFn = NULL;
   config->errorFn = NULL;
+  config->gcFn = NULL;
   config->initialHeapSize = 1024 * 1024 * 10;
   config->minHeapSize = 1024 * 1024;
   config->heapGrowthPercent = 50;
@@ -131,6 +132,11 @@ void wrenCollectGarbage(WrenVM* vm)
   double startTime = (double)clock() / CLOCKS_PER_SEC;
 #endif
 
+  if (vm->config.gcFn != NULL)
+  {
+    vm->config.gcFn(vm, WREN_GC_BEGIN, vm->bytesAllocated);
+  }
+
   // Mark all reachable objects.
 
   // Reset this. As we mark objects, their size will be counted again so that
@@ -197,6 +203,11 @@ void wrenCollectGarbage(WrenVM* vm)
   vm->nextGC = vm->bytesAllocated + ((vm->bytesAllocated * vm->config.heapGrowthPercent) / 100);
   if (vm->nextGC < vm->config.minHeapSize) vm->nextGC = vm->config.minHeapSize;
 
+  if (vm->config.gcFn != NULL)
+  {
+    vm->config.gcFn(vm, WREN_GC_END, vm->bytesAllocated);
+  }
+
 #if WREN_DEBUG_TRACE_MEMORY || WREN_DEBUG_TRACE_GC
   double elapsed = ((double)clock() / CLOCKS_PER_SEC) - startTime;
   // Explicit cast because size_t has different sizes on 32-bit and 64-bit and
@@ -210,6 +221,22 @@ void wrenCollectGarbage(WrenVM* vm)
 #endif
 }
 
+ObjModule* wrenAllocatingModule(WrenVM* vm)
+{
+  ObjFiber* fiber = vm->fiber;
+  if (fiber == NULL) return NULL;
+
+  ObjModule* core = NULL;
+  for (int i = fiber->numFrames - 1; i >= 0; i--)
+  {
+    ObjModule* module = fiber->frames[i].closure->fn->module;
+    if (module == NULL || module->name != NULL) return module != NULL ? module : core;
+    core = module;
+  }
+
+  return core;
+}
+
 void* wrenReallocate(WrenVM* vm, void* memory, size_t oldSize, size_t newSize)
 {
 #if WREN_DEBUG_TRACE_MEMORY
@@ -225,6 +252,13 @@ void* wrenReallocate(WrenVM* vm, void* memory, size_t oldSize, size_t newSize)
   // during the next GC.
   vm->bytesAllocated += newSize - oldSize;
 
+  // New bytes are attributed to a module when the next object is created (see
+  // initObj()), so the call frames are walked once per object, not here.
+  if (vm->attributeModules && newSize > oldSize)
+  {
+    vm->pendingAllocatedBytes += newSize - oldSize;
+  }
+
 #if WREN_DEBUG_GC_STRESS
   // Since collecting calls this function to free things, make sure we don't
   // recurse.
@@ -672,8 +706,14 @@ static void createForeign(WrenVM* vm, ObjFiber* fiber, Value* stack)
   ASSERT(vm->apiStack == NULL, "Cannot already be in foreign call.");
   vm->apiStack = stack;
 
+  // The allocator may grow the slots (and move the stack) to read its
+  // arguments. Discard those temporaries so the constructor body sees the
+  // same stack as before, like callForeign() does.
+  int top = (int)(fiber->stackTop - fiber->stack);
+
   method->as.foreign(vm);
 
+  fiber->stackTop = fiber->stack + top;
   vm->apiStack = NULL;
 }
 
@@ -875,6 +915,19 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
         DISPATCH();                                                            \
       } while (false)
 
+  // Counts method calls and loop iterations down to the next profiler sample.
+  // The countdown stays at zero while sampling is off.
+  #define SAMPLE_POINT()                                                       \
+      do                                                                       \
+      {                                                                        \
+        if (vm->sampleCountdown != 0 && --vm->sampleCountdown == 0)            \
+        {                                                                      \
+          STORE_FRAME();                                                       \
+          vm->sampleCountdown = vm->sampleInterval;                            \
+          vm->sampleFn(vm);                                                    \
+        }                                                                      \
+      } while (false)
+
   #if WREN_DEBUG_TRACE_INSTRUCTIONS
     // Prints the stack and instruction before each instruction is executed.
     #define DEBUG_TRACE_INSTRUCTIONS()                                         \
@@ -1034,6 +1087,8 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
       goto completeCall;
 
     completeCall:
+      SAMPLE_POINT();
+
       // If the class's method table doesn't include the symbol, bail.
       if (symbol >= classObj->methods.count ||
           (method = &classObj->methods.data[symbol])->type == METHOD_NONE)
@@ -1075,6 +1130,10 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
 
         case METHOD_FOREIGN:
           callForeign(vm, fiber, method->as.foreign, numArgs);
+
+          // The method may have grown its slots with wrenEnsureSlots() and
+          // moved the stack. The frame was updated, the cached pointer wasn't.
+          stackStart = frame->stackStart;
           if (wrenHasError(fiber)) RUNTIME_ERROR();
           break;
 
@@ -1158,6 +1217,7 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
       // Jump back to the top of the loop.
       uint16_t offset = READ_SHORT();
       ip -= offset;
+      SAMPLE_POINT();
       DISPATCH();
     }
 
@@ -1263,7 +1323,9 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
 
     CASE_CODE(FOREIGN_CONSTRUCT):
       ASSERT(IS_CLASS(stackStart[0]), "'this' should be a class.");
+      STORE_FRAME();
       createForeign(vm, fiber, stackStart);
+      LOAD_FRAME();
       if (wrenHasError(fiber)) RUNTIME_ERROR();
       DISPATCH();
 
@@ -1542,6 +1604,20 @@ ObjClosure* wrenCompileSource(WrenVM* vm, const char* module, const char* source
   return closure;
 }
 
+WrenHandle* wrenCompileInModule(WrenVM* vm, const char* module,
+                                const char* source, bool isExpression,
+                                bool reportErrors)
+{
+  ObjClosure* closure = wrenCompileSource(vm, module, source, isExpression,
+                                          reportErrors);
+  if (closure == NULL) return NULL;
+
+  wrenPushRoot(vm, (Obj*)closure);
+  WrenHandle* handle = wrenMakeHandle(vm, OBJ_VAL(closure));
+  wrenPopRoot(vm); // closure.
+  return handle;
+}
+
 Value wrenGetModuleVariable(WrenVM* vm, Value moduleName, Value variableName)
 {
   ObjModule* module = getModule(vm, moduleName);
@@ -1723,6 +1799,217 @@ WrenHandle* wrenGetSlotHandle(WrenVM* vm, int slot)
   return wrenMakeHandle(vm, vm->apiStack[slot]);
 }
 
+void* wrenGetSlotObject(WrenVM* vm, int slot)
+{
+  validateApiSlot(vm, slot);
+  Value value = vm->apiStack[slot];
+  return IS_OBJ(value) ? AS_OBJ(value) : NULL;
+}
+
+bool wrenGetSlotFnSource(WrenVM* vm, int slot, const char** module, int* line)
+{
+  validateApiSlot(vm, slot);
+  Value value = vm->apiStack[slot];
+  if (!IS_CLOSURE(value)) return false;
+
+  ObjFn* fn = AS_CLOSURE(value)->fn;
+  *module = fn->module->name != NULL ? fn->module->name->value : "core";
+  *line = fn->debug->sourceLines.count > 0 ? fn->debug->sourceLines.data[0] : 0;
+  return true;
+}
+
+void wrenGetModuleAllocations(WrenVM* vm, WrenModuleAllocationsFn fn,
+                              void* userData)
+{
+  // Bytes no object has been charged with yet count as the host's.
+  fn(userData, NULL, vm->hostAllocatedBytes + vm->pendingAllocatedBytes,
+     vm->hostAllocationCount);
+
+  ObjMap* modules = vm->modules;
+  for (uint32_t i = 0; i < modules->capacity; i++)
+  {
+    MapEntry* entry = &modules->entries[i];
+    if (IS_UNDEFINED(entry->key)) continue;
+
+    ObjModule* module = AS_MODULE(entry->value);
+    fn(userData, module->name != NULL ? module->name->value : "core",
+       module->allocatedBytes, module->allocationCount);
+  }
+}
+
+typedef struct
+{
+  WrenHeapVisitFn fn;
+  void* userData;
+  const char* owner;
+
+  // Module names indexed by [ObjModule.id], [numModuleNames] entries.
+  const char** moduleNames;
+  uint32_t numModuleNames;
+} HeapSnapshot;
+
+static const char* heapTypeName(Obj* obj)
+{
+  switch (obj->type)
+  {
+    case OBJ_CLASS:   return "Class";
+    case OBJ_CLOSURE: return "Closure";
+    case OBJ_FIBER:   return "Fiber";
+    case OBJ_FN:      return "Fn";
+    case OBJ_LIST:    return "List";
+    case OBJ_MAP:     return "Map";
+    case OBJ_MODULE:  return "Module";
+    case OBJ_RANGE:   return "Range";
+    case OBJ_STRING:  return "String";
+    case OBJ_UPVALUE: return "Upvalue";
+
+    case OBJ_FOREIGN:
+    case OBJ_INSTANCE:
+      return obj->classObj->name->value;
+  }
+
+  UNREACHABLE();
+  return NULL;
+}
+
+static void visitHeapObject(WrenVM* vm, Obj* obj, size_t bytes, void* userData)
+{
+  HeapSnapshot* snapshot = (HeapSnapshot*)userData;
+  const char* module = obj->module < snapshot->numModuleNames
+                     ? snapshot->moduleNames[obj->module] : NULL;
+  snapshot->fn(snapshot->userData, snapshot->owner, module, heapTypeName(obj),
+               bytes);
+}
+
+// Reports everything reachable from the grayed objects that was not reached
+// by an earlier group.
+static void walkHeapGroup(WrenVM* vm, HeapSnapshot* snapshot,
+                          const char* owner)
+{
+  snapshot->owner = owner;
+  wrenBlackenObjectsVisit(vm, visitHeapObject, snapshot);
+}
+
+void wrenHeapSnapshot(WrenVM* vm, WrenHeapVisitFn fn, void* userData)
+{
+  ASSERT(vm->grayCount == 0, "Cannot take a heap snapshot during GC.");
+
+  // Only live objects are interesting, and after a collection every object is
+  // unmarked, so the mark bits can be borrowed for the walk.
+  wrenCollectGarbage(vm);
+
+  // Marking re-counts the size of everything it reaches.
+  size_t bytesAllocated = vm->bytesAllocated;
+
+  HeapSnapshot snapshot;
+  snapshot.fn = fn;
+  snapshot.userData = userData;
+
+  // Not allocated through wrenReallocate() so it can't trigger a GC.
+  ObjMap* modules = vm->modules;
+  snapshot.numModuleNames = (uint32_t)vm->lastModuleId + 1;
+  size_t namesSize = sizeof(const char*) * snapshot.numModuleNames;
+  snapshot.moduleNames = (const char**)vm->config.reallocateFn(NULL, namesSize,
+                                                              vm->config.userData);
+  memset(snapshot.moduleNames, 0, namesSize);
+  for (uint32_t i = 0; i < modules->capacity; i++)
+  {
+    MapEntry* entry = &modules->entries[i];
+    if (IS_UNDEFINED(entry->key)) continue;
+
+    // Modules past the id limit share UINT16_MAX and stay unnamed.
+    ObjModule* module = AS_MODULE(entry->value);
+    if (module->id >= snapshot.numModuleNames) continue;
+    snapshot.moduleNames[module->id] =
+        module->name != NULL ? module->name->value : "core";
+  }
+
+  // The core module goes first so that the built-in classes shared by every
+  // module are attributed to it.
+  Value coreModule = wrenMapGet(modules, NULL_VAL);
+  if (!IS_UNDEFINED(coreModule))
+  {
+    wrenGrayValue(vm, coreModule);
+    walkHeapGroup(vm, &snapshot, "core");
+  }
+
+  for (uint32_t i = 0; i < modules->capacity; i++)
+  {
+    MapEntry* entry = &modules->entries[i];
+    if (IS_UNDEFINED(entry->key) || IS_NULL(entry->key)) continue;
+
+    wrenGrayValue(vm, entry->value);
+    walkHeapGroup(vm, &snapshot, AS_CSTRING(entry->key));
+  }
+
+  for (WrenHandle* handle = vm->handles; handle != NULL; handle = handle->next)
+  {
+    wrenGrayValue(vm, handle->value);
+  }
+  walkHeapGroup(vm, &snapshot, "<handles>");
+
+  wrenGrayObj(vm, (Obj*)vm->fiber);
+  walkHeapGroup(vm, &snapshot, "<fiber>");
+
+  // The same roots as wrenCollectGarbage().
+  wrenGrayObj(vm, (Obj*)vm->modules);
+  for (int i = 0; i < vm->numTempRoots; i++)
+  {
+    wrenGrayObj(vm, vm->tempRoots[i]);
+  }
+  if (vm->compiler != NULL) wrenMarkCompiler(vm, vm->compiler);
+  wrenBlackenSymbolTable(vm, &vm->methodNames);
+  walkHeapGroup(vm, &snapshot, "<vm>");
+
+  // Unmark everything for the next GC.
+  for (Obj* obj = vm->first; obj != NULL; obj = obj->next)
+  {
+    obj->isDark = false;
+  }
+
+  vm->bytesAllocated = bytesAllocated;
+  vm->config.reallocateFn(snapshot.moduleNames, 0, vm->config.userData);
+}
+
+void wrenSetModuleAttribution(WrenVM* vm, bool enabled)
+{
+  vm->attributeModules = enabled;
+  vm->pendingAllocatedBytes = 0;
+}
+
+void wrenSetSampling(WrenVM* vm, uint32_t interval, WrenSampleFn sampleFn)
+{
+  ASSERT(interval == 0 || sampleFn != NULL, "Sampling needs a callback.");
+  vm->sampleInterval = interval;
+  vm->sampleCountdown = interval;
+  vm->sampleFn = sampleFn;
+}
+
+int wrenGetStackFrameCount(WrenVM* vm)
+{
+  return vm->fiber != NULL ? vm->fiber->numFrames : 0;
+}
+
+bool wrenGetStackFrame(WrenVM* vm, int index, const char** module,
+                       const char** function, int* line)
+{
+  ASSERT(vm->fiber != NULL, "No fiber is running.");
+  ASSERT(index >= 0 && index < vm->fiber->numFrames, "Frame index out of bounds.");
+
+  CallFrame* frame = &vm->fiber->frames[vm->fiber->numFrames - 1 - index];
+  ObjFn* fn = frame->closure->fn;
+  if (fn->module == NULL) return false;
+
+  *module = fn->module->name != NULL ? fn->module->name->value : "core";
+  *function = fn->debug->name;
+
+  // -1 because IP has advanced past the instruction that it just executed.
+  int offset = (int)(frame->ip - fn->code.data - 1);
+  if (offset < 0) offset = 0;
+  *line = offset < fn->debug->sourceLines.count ? fn->debug->sourceLines.data[offset] : 0;
+  return true;
+}
+
 // Stores [value] in [slot] in the foreign call stack.
 static void setSlot(WrenVM* vm, int slot, Value value)
 {
@@ -1790,6 +2077,13 @@ void wrenSetSlotHandle(WrenVM* vm, int slot, WrenHandle* handle)
   setSlot(vm, slot, handle->value);
 }
 
+void wrenSetSlotObject(WrenVM* vm, int slot, void* object)
+{
+  ASSERT(object != NULL, "Object cannot be NULL.");
+
+  setSlot(vm, slot, OBJ_VAL(object));
+}
+
 int wrenGetListCount(WrenVM* vm, int slot)
 {
   validateApiSlot(vm, slot);
@@ -1885,6 +2179,31 @@ void wrenGetMapValue(WrenVM* vm, int mapSlot, int keySlot, int valueSlot)
   vm->apiStack[valueSlot] = value;
 }
 
+int wrenGetMapNextEntry(WrenVM* vm, int mapSlot, int cursor,
+                        int keySlot, int valueSlot)
+{
+  validateApiSlot(vm, mapSlot);
+  validateApiSlot(vm, keySlot);
+  validateApiSlot(vm, valueSlot);
+  ASSERT(IS_MAP(vm->apiStack[mapSlot]), "Slot must hold a map.");
+
+  ObjMap* map = AS_MAP(vm->apiStack[mapSlot]);
+
+  // Same walk as Map.iterate(_): the cursor is the index of the next entry.
+  for (uint32_t index = cursor < 0 ? 0 : (uint32_t)cursor;
+       index < map->capacity; index++)
+  {
+    MapEntry* entry = &map->entries[index];
+    if (IS_UNDEFINED(entry->key)) continue;
+
+    vm->apiStack[keySlot] = entry->key;
+    vm->apiStack[valueSlot] = entry->value;
+    return (int)(index + 1);
+  }
+
+  return -1;
+}
+
 void wrenSetMapValue(WrenVM* vm, int mapSlot, int keySlot, int valueSlot)
 {
   validateApiSlot(vm, mapSlot);
@@ -67,6 +67,20 @@ struct WrenVM
   // The number of total allocated bytes that will trigger the next GC.
   size_t nextGC;
 
+  // Like [ObjModule.allocatedBytes], for allocations made while no module
+  // code was executing (compiling, or called from the host).
+  size_t hostAllocatedBytes;
+  size_t hostAllocationCount;
+
+  // Whether allocations are attributed to modules (see
+  // [wrenSetModuleAttribution()]), and the bytes requested since the last
+  // object was created, which the next one is charged with.
+  bool attributeModules;
+  size_t pendingAllocatedBytes;
+
+  // The last unique [ObjModule.id] handed out. Never reaches UINT16_MAX.
+  uint16_t lastModuleId;
+
   // The first object in the linked list of all currently allocated objects.
   Obj* first;
 
@@ -100,6 +114,12 @@ struct WrenVM
   Value* apiStack;
 
   WrenConfiguration config;
+
+  // Sampling profiler (see wrenSetSampling()). [sampleCountdown] is zero while
+  // sampling is off.
+  uint32_t sampleCountdown;
+  uint32_t sampleInterval;
+  WrenSampleFn sampleFn;
   
   // Compiler and debugger data:
 
@@ -201,6 +221,15 @@ void wrenPushRoot(WrenVM* vm, Obj* obj);
 // Removes the most recently pushed temporary root.
 void wrenPopRoot(WrenVM* vm);
 
+// Returns the module that memory allocated now is attributed to: the module of
+// the innermost executing function, skipping core methods written in Wren since
+// they allocate on behalf of their caller unless it's the host. Returns NULL if
+// no module code is executing.
+//
+// Walks the call frames, so it's only called once per new object, and only
+// while [attributeModules] is set.
+ObjModule* wrenAllocatingModule(WrenVM* vm);
+
 // Returns the class of [value].
 //
 // Defined here instead of in wren_value.h because it's critical that this be
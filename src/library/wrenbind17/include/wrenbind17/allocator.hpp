@@ -2,8 +2,10 @@
 
 #include <wren.hpp>
 
+#include <memory>
 #include <string>
 
+#include "caller.hpp"
 #include "index.hpp"
 #include "pop.hpp"
 #include "push.hpp"
@@ -21,23 +23,28 @@ namespace wrenbind17 {
                 return new T(std::forward<Args>(args)...);
             }
             template <size_t... Is> static T* ctorFrom(WrenVM* vm, detail::index_list<Is...>) {
+                (void)vm;
                 return ctor(PopHelper<Args>::f(vm, Is + 1)...);
             }
+            template <size_t... Is>
+            static void emplaceFrom(ForeignObjectInline<T>* wrapper, WrenVM* vm, detail::index_list<Is...>) {
+                (void)vm;
+                wrapper->emplace(PopHelper<Args>::f(vm, Is + 1)...);
+            }
             static void allocate(WrenVM* vm) {
-                auto* memory = wrenSetSlotNewForeign(vm, 0, 0, sizeof(ForeignObject<T>));
-                new (memory) ForeignObject<T>();
-                auto* wrapper = reinterpret_cast<ForeignObject<T>*>(memory);
-                try {
-                    wrapper->ptr.reset(ctorFrom(vm, detail::index_range<0, sizeof...(Args)>()));
-                } catch (std::exception& e) {
-                    wrenEnsureSlots(vm, 1);
-                    wrenSetSlotString(vm, 0, e.what());
-                    wrenAbortFiber(vm, 0);
-                }
+                auto* memory = wrenSetSlotNewForeign(vm, 0, 0, sizeof(ForeignObjectFor<T>));
+                auto* wrapper = new (memory) ForeignObjectFor<T>();
+                invokeForeign<1, Args...>(vm, [wrapper](WrenVM* vm) {
+                    if constexpr (ForeignInline<T>::value) {
+                        emplaceFrom(wrapper, vm, detail::index_range<0, sizeof...(Args)>());
+                    } else {
+                        wrapper->ptr.reset(ctorFrom(vm, detail::index_range<0, sizeof...(Args)>()));
+                    }
+                });
             }
             static void finalize(void* memory) {
-                auto* wrapper = reinterpret_cast<ForeignObject<T>*>(memory);
-                wrapper->~ForeignObject<T>();
+                auto* wrapper = reinterpret_cast<ForeignObjectFor<T>*>(memory);
+                std::destroy_at(wrapper);
             }
         };
     } // namespace detail
@@ -216,11 +216,26 @@ namespace wrenbind17 {
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
     template <> inline Any detail::getSlot(WrenVM* vm, const int idx) {
-        const auto type = wrenGetSlotType(vm, 0);
+        const auto type = wrenGetSlotType(vm, idx);
         if (type == WREN_TYPE_NULL) {
             return Any();
         }
         return Any(type, Handle(getSharedVm(vm), wrenGetSlotHandle(vm, idx)));
     }
+
+    template <> struct detail::PopHelper<const Any&> {
+        static inline Any f(WrenVM* vm, const int idx) {
+            return getSlot<Any>(vm, idx);
+        }
+    };
+
+    // Any value is accepted
+    template <> struct detail::ArgCheck<Any> {
+        static constexpr bool exact = true;
+
+        static inline const char* f(WrenVM*, int) {
+            return nullptr;
+        }
+    };
 #endif
 } // namespace wrenbind17
@@ -83,6 +83,65 @@ namespace wrenbind17 {
             PushHelper<std::string&>::f(vm, index, ret);
         }
 
+#ifdef __cpp_lib_expected
+        template <typename R> struct ForeginMethodReturnHelper<std::expected<R, ScriptError>> {
+            static inline void push(WrenVM* vm, int index, std::expected<R, ScriptError> ret) {
+                if (!ret) {
+                    abortFiber(vm, ret.error().message.c_str());
+                    return;
+                }
+                ForeginMethodReturnHelper<R>::push(vm, index, std::move(*ret));
+            }
+        };
+
+        template <> struct ForeginMethodReturnHelper<std::expected<void, ScriptError>> {
+            static inline void push(WrenVM* vm, int index, std::expected<void, ScriptError> ret) {
+                (void)index;
+                if (!ret)
+                    abortFiber(vm, ret.error().message.c_str());
+            }
+        };
+#endif
+
+        template <typename... Args> struct ForeignArgs {
+            static constexpr bool exact =
+                (ArgCheck<typename std::remove_cv<typename std::remove_reference<Args>::type>::type>::exact && ...);
+
+            template <size_t... Is> static const char* check(WrenVM* vm, const int first, detail::index_list<Is...>) {
+                (void)vm;
+                const char* error = nullptr;
+                ((error = error ? error
+                                : ArgCheck<typename std::remove_cv<typename std::remove_reference<Args>::type>::type>::f(
+                                      vm, first + static_cast<int>(Is))),
+                 ...);
+                return error;
+            }
+        };
+
+        // Runs the body of a trampoline, Args are the slots starting at First. By default any exception
+        // aborts the fiber. With WRENBIND17_NO_EXCEPTIONS the arguments are checked up front instead and
+        // the try/catch is only kept when a check can't cover everything PopHelper does. Bound functions
+        // must not throw in that mode, return Result<T> to report a script error.
+        template <int First, typename... Args, typename Fn> inline void invokeForeign(WrenVM* vm, const Fn& fn) {
+#ifdef WRENBIND17_NO_EXCEPTIONS
+            if (const auto error = ForeignArgs<Args...>::check(vm, First, detail::index_range<0, sizeof...(Args)>())) {
+                abortFiber(vm, error);
+                return;
+            }
+            if constexpr (ForeignArgs<Args...>::exact) {
+                fn(vm);
+                return;
+            } else
+#endif
+            {
+                try {
+                    fn(vm);
+                } catch (...) {
+                    exceptionHandler(vm, std::current_exception());
+                }
+            }
+        }
+
         template <typename R, typename T, typename... Args> struct ForeignMethodCaller {
             template <R (T::*Fn)(Args...), size_t... Is> static void callFrom(WrenVM* vm, detail::index_list<Is...>) {
                 auto self = PopHelper<T*>::f(vm, 0);
@@ -93,11 +152,8 @@ namespace wrenbind17 {
             }
 
             template <R (T::*Fn)(Args...)> static void call(WrenVM* vm) {
-                try {
-                    callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>());
-                } catch (...) {
-                    exceptionHandler(vm, std::current_exception());
-                }
+                invokeForeign<0, T*, Args...>(
+                    vm, [](WrenVM* vm) { callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>()); });
             }
 
             template <R (T::*Fn)(Args...) const, size_t... Is>
@@ -110,11 +166,8 @@ namespace wrenbind17 {
             }
 
             template <R (T::*Fn)(Args...) const> static void call(WrenVM* vm) {
-                try {
-                    callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>());
-                } catch (...) {
-                    exceptionHandler(vm, std::current_exception());
-                }
+                invokeForeign<0, T*, Args...>(
+                    vm, [](WrenVM* vm) { callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>()); });
             }
         };
 
@@ -126,11 +179,8 @@ namespace wrenbind17 {
             }
 
             template <void (T::*Fn)(Args...)> static void call(WrenVM* vm) {
-                try {
-                    callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>());
-                } catch (...) {
-                    exceptionHandler(vm, std::current_exception());
-                }
+                invokeForeign<0, T*, Args...>(
+                    vm, [](WrenVM* vm) { callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>()); });
             }
 
             template <void (T::*Fn)(Args...) const, size_t... Is>
@@ -140,11 +190,8 @@ namespace wrenbind17 {
             }
 
             template <void (T::*Fn)(Args...) const> static void call(WrenVM* vm) {
-                try {
-                    callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>());
-                } catch (...) {
-                    exceptionHandler(vm, std::current_exception());
-                }
+                invokeForeign<0, T*, Args...>(
+                    vm, [](WrenVM* vm) { callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>()); });
             }
         };
 
@@ -158,11 +205,8 @@ namespace wrenbind17 {
             }
 
             template <R (*Fn)(T&, Args...)> static void call(WrenVM* vm) {
-                try {
-                    callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>());
-                } catch (...) {
-                    exceptionHandler(vm, std::current_exception());
-                }
+                invokeForeign<0, T*, Args...>(
+                    vm, [](WrenVM* vm) { callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>()); });
             }
         };
 
@@ -174,11 +218,8 @@ namespace wrenbind17 {
             }
 
             template <void (*Fn)(T&, Args...)> static void call(WrenVM* vm) {
-                try {
-                    callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>());
-                } catch (...) {
-                    exceptionHandler(vm, std::current_exception());
-                }
+                invokeForeign<0, T*, Args...>(
+                    vm, [](WrenVM* vm) { callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>()); });
             }
         };
 
@@ -191,25 +232,20 @@ namespace wrenbind17 {
             }
 
             template <R (*Fn)(Args...)> static void call(WrenVM* vm) {
-                try {
-                    callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>());
-                } catch (...) {
-                    exceptionHandler(vm, std::current_exception());
-                }
+                invokeForeign<1, Args...>(
+                    vm, [](WrenVM* vm) { callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>()); });
             }
         };
 
         template <typename... Args> struct ForeignFunctionCaller<void, Args...> {
             template <void (*Fn)(Args...), size_t... Is> static void callFrom(WrenVM* vm, detail::index_list<Is...>) {
+                (void)vm;
                 (*Fn)(PopHelper<typename std::remove_const<Args>::type>::f(vm, Is + 1)...);
             }
 
             template <void (*Fn)(Args...)> static void call(WrenVM* vm) {
-                try {
-                    callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>());
-                } catch (...) {
-                    exceptionHandler(vm, std::current_exception());
-                }
+                invokeForeign<1, Args...>(
+                    vm, [](WrenVM* vm) { callFrom<Fn>(vm, detail::index_range<0, sizeof...(Args)>()); });
             }
         };
 
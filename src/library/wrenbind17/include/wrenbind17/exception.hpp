@@ -3,6 +3,10 @@
 #include <stdexcept>
 #include <memory>
 #include <string>
+#include <version>
+#ifdef __cpp_lib_expected
+#include <expected>
+#endif
 
 /**
  * @ingroup wrenbind17
@@ -64,4 +68,30 @@ namespace wrenbind17 {
         explicit CompileError(std::string msg) : Exception(std::move(msg)) {
         }
     };
+
+#ifdef __cpp_lib_expected
+    /**
+     * @ingroup wrenbind17
+     * @brief Error returned by a foreign function instead of throwing
+     * @details A bound function returning wrenbind17::Result<T> either pushes the value or
+     * aborts the calling fiber with the message. Works the same with or without
+     * WRENBIND17_NO_EXCEPTIONS, so wrappers can report script errors without throwing.
+     */
+    struct ScriptError {
+        std::string message;
+    };
+
+    /**
+     * @ingroup wrenbind17
+     */
+    template <typename T> using Result = std::expected<T, ScriptError>;
+
+    /**
+     * @ingroup wrenbind17
+     * @brief Shorthand for returning an error from a function returning Result<T>
+     */
+    inline std::unexpected<ScriptError> scriptError(std::string message) {
+        return std::unexpected<ScriptError>(ScriptError{std::move(message)});
+    }
+#endif
 } // namespace wrenbind17
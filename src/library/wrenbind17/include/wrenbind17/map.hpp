@@ -126,6 +126,20 @@ namespace wrenbind17 {
         return Map(std::make_shared<Handle>(getSharedVm(vm), wrenGetSlotHandle(vm, idx)));
     }
 
+    template <> struct detail::PopHelper<const Map&> {
+        static inline Map f(WrenVM* vm, const int idx) {
+            return getSlot<Map>(vm, idx);
+        }
+    };
+
+    template <> struct detail::ArgCheck<Map> {
+        static constexpr bool exact = true;
+
+        static inline const char* f(WrenVM* vm, const int idx) {
+            return checkSlotType(vm, idx, WrenType::WREN_TYPE_MAP);
+        }
+    };
+
     template <> inline bool detail::is<Map>(WrenVM* vm, const int idx) {
         return wrenGetSlotType(vm, idx) == WREN_TYPE_MAP;
     }
@@ -13,8 +13,9 @@
  * @ingroup wrenbind17
  */
 namespace wrenbind17 {
-    void addClassType(WrenVM* vm, const std::string& module, const std::string& name, size_t hash);
-    void addClassCast(WrenVM* vm, std::shared_ptr<detail::ForeignPtrConvertor> convertor, size_t hash, size_t other);
+    void addClassType(WrenVM* vm, const std::string& module, const std::string& name, detail::TypeId id);
+    void addClassCast(WrenVM* vm, std::shared_ptr<detail::ForeignPtrConvertor> convertor, detail::TypeId from,
+                      detail::TypeId to);
 
     /**
      * @ingroup wrenbind17
@@ -46,7 +47,7 @@ namespace wrenbind17 {
             insertKlassCast<T, Others...>();
             auto ptr = std::make_unique<ForeignKlassImpl<T>>(std::move(name));
             auto ret = ptr.get();
-            addClassType(vm, this->name, ptr->getName(), typeid(T).hash_code());
+            addClassType(vm, this->name, ptr->getName(), detail::typeIdOf<T>);
             klasses.insert(std::make_pair(ptr->getName(), std::move(ptr)));
             return *ret;
         }
@@ -87,8 +88,8 @@ namespace wrenbind17 {
         void insertKlassCast() {
             addClassCast(vm,
                          std::make_shared<detail::ForeignObjectSharedPtrConvertor<T, Other>>(),
-                         typeid(T).hash_code(),
-                         typeid(Other).hash_code()
+                         detail::typeIdOf<T>,
+                         detail::typeIdOf<Other>
                         );
             insertKlassCast<T, Others...>();
         }
@@ -2,35 +2,71 @@
 
 #include <wren.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
+#include <new>
 #include <string>
-#include <typeinfo>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 
 #include "exception.hpp"
 #include "handle.hpp"
 
+#ifndef WRENBIND17_INLINE_FOREIGN_SIZE
+#define WRENBIND17_INLINE_FOREIGN_SIZE 16
+#endif
+
 /**
  * @ingroup wrenbind17
  */
 namespace wrenbind17 {
+    /**
+     * @ingroup wrenbind17
+     * @brief Selects inline storage for a foreign class
+     * @details When true, instances of T pushed into Wren are stored by value directly
+     * inside the Wren foreign object instead of behind a std::shared_ptr. This avoids a heap
+     * allocation and refcounting for small handle-like types. Defaults to small trivially
+     * copyable types, specialize it to opt a type in or out.
+     * @note Inline types have value semantics: pushing a T* or a T& copies the value.
+     */
+    template <typename T>
+    struct ForeignInline
+        : std::bool_constant<std::is_trivially_copyable<T>::value && sizeof(T) <= WRENBIND17_INLINE_FOREIGN_SIZE &&
+                             alignof(T) <= alignof(void*)> {};
+
+    /**
+     * @ingroup wrenbind17
+     * @brief Gives a foreign class a stable identity in Wren
+     * @details Specialize as std::true_type with a static std::uint64_t key(const T&) to make
+     * every push of a value with the same non-zero key return the same Wren object for as
+     * long as that object is alive. The object is not kept alive by the cache, it is dropped
+     * in the finalizer. Only supported for ForeignInline types.
+     * @note Objects created by a Wren constructor are never cached.
+     */
+    template <typename T> struct ForeignIdentity : std::false_type {};
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
     std::string getLastError(WrenVM* vm);
 
+    inline void abortFiber(WrenVM* vm, const char* message) {
+        wrenEnsureSlots(vm, 1);
+        wrenSetSlotString(vm, 0, message);
+        wrenAbortFiber(vm, 0);
+    }
+
     inline void exceptionHandler(WrenVM* vm, const std::exception_ptr& eptr) {
         try {
             if (eptr) {
                 std::rethrow_exception(eptr);
             } else {
-                wrenEnsureSlots(vm, 1);
-                wrenSetSlotString(vm, 0, "Unknown error");
-                wrenAbortFiber(vm, 0);
+                abortFiber(vm, "Unknown error");
             }
         } catch (std::exception& e) {
-            wrenEnsureSlots(vm, 1);
-            wrenSetSlotString(vm, 0, e.what());
-            wrenAbortFiber(vm, 0);
+            abortFiber(vm, e.what());
         }
     }
 
@@ -38,35 +74,50 @@ namespace wrenbind17 {
     template <class T> struct is_shared_ptr<std::shared_ptr<T>> : std::true_type {};
 
     namespace detail {
+        /**
+         * @brief Dense per-process identifier of a C++ type bound to Wren
+         * @details Ids start at 1 and are handed out in instantiation order during static
+         * initialization, so they can index the per-VM class and cast tables directly.
+         * Zero is never a valid id.
+         */
+        using TypeId = std::uint32_t;
+
+        inline TypeId nextTypeId() {
+            static std::atomic<TypeId> counter{0};
+            return ++counter;
+        }
+
+        template <typename T> inline const TypeId typeIdOf = nextTypeId();
+
+        struct ClassType {
+            std::string module;
+            std::string name;
+        };
+
+        // Common header of every foreign object stored by Wren. Kept non-polymorphic,
+        // the type check on the hot path is a single integer compare on typeId.
         class Foreign {
         public:
-            Foreign() = default;
-            virtual ~Foreign() = 0;
-            virtual void* get() const = 0;
-            virtual size_t hash() const = 0;
-        };
+            explicit Foreign(const TypeId typeId) : typeId(typeId) {
+            }
 
-        inline Foreign::~Foreign() {
-        }
+            TypeId typeId;
+        };
 
         template <typename T> class ForeignObject : public Foreign {
         public:
-            ForeignObject() {
+            ForeignObject() : Foreign(typeIdOf<T>) {
             }
 
-            ForeignObject(std::shared_ptr<T> ptr) : ptr(std::move(ptr)) {
+            ForeignObject(std::shared_ptr<T> ptr) : Foreign(typeIdOf<T>), ptr(std::move(ptr)) {
             }
 
-            virtual ~ForeignObject() = default;
+            ~ForeignObject() = default;
 
-            void* get() const override {
+            void* get() const {
                 return ptr.get();
             }
 
-            size_t hash() const override {
-                return typeid(T).hash_code();
-            }
-
             const std::shared_ptr<T>& shared() const {
                 return ptr;
             }
@@ -74,6 +125,122 @@ namespace wrenbind17 {
             std::shared_ptr<T> ptr;
         };
 
+        template <typename T> class ForeignObjectInline : public Foreign {
+        public:
+            ForeignObjectInline() : Foreign(typeIdOf<T>) {
+            }
+
+            template <typename... Args>
+            explicit ForeignObjectInline(std::in_place_t, Args&&... args) : Foreign(typeIdOf<T>) {
+                emplace(std::forward<Args>(args)...);
+            }
+
+            ForeignObjectInline(const ForeignObjectInline& other) = delete;
+
+            ~ForeignObjectInline() {
+                reset();
+            }
+
+            void* get() const {
+                return engaged ? value() : nullptr;
+            }
+
+            template <typename... Args> void emplace(Args&&... args) {
+                reset();
+                new (storage) T(std::forward<Args>(args)...);
+                engaged = true;
+            }
+
+            void reset() {
+                if (engaged) {
+                    value()->~T();
+                    engaged = false;
+                }
+            }
+
+            // The Wren object owns the value: there is no shared() for inline storage
+            T* value() const {
+                return std::launder(reinterpret_cast<T*>(const_cast<unsigned char*>(storage)));
+            }
+
+        private:
+            alignas(T) unsigned char storage[sizeof(T)];
+            bool engaged{false};
+        };
+
+        // Weak map from (type, key) to the Wren object currently representing it
+        class IdentityCache {
+        public:
+            void* find(const TypeId type, const std::uint64_t key) const {
+                const auto it = objects.find(Key{type, key});
+                return it != objects.end() ? it->second : nullptr;
+            }
+
+            void insert(const TypeId type, const std::uint64_t key, void* object) {
+                objects[Key{type, key}] = object;
+            }
+
+            void erase(const TypeId type, const std::uint64_t key) {
+                objects.erase(Key{type, key});
+            }
+
+            size_t size() const {
+                return objects.size();
+            }
+
+        private:
+            struct Key {
+                TypeId type;
+                std::uint64_t key;
+
+                bool operator==(const Key& other) const {
+                    return type == other.type && key == other.key;
+                }
+            };
+
+            struct KeyHash {
+                size_t operator()(const Key& k) const {
+                    return std::hash<std::uint64_t>{}(k.key ^ (static_cast<std::uint64_t>(k.type) << 48));
+                }
+            };
+
+            std::unordered_map<Key, void*, KeyHash> objects;
+        };
+
+        template <typename T> class ForeignObjectIdentity : public ForeignObjectInline<T> {
+        public:
+            static_assert(ForeignInline<T>::value, "ForeignIdentity requires a ForeignInline type");
+
+            using ForeignObjectInline<T>::ForeignObjectInline;
+
+            ~ForeignObjectIdentity() {
+                if (cache)
+                    cache->erase(typeIdOf<T>, key);
+            }
+
+            void track(IdentityCache* identities, const std::uint64_t identity) {
+                cache = identities;
+                key = identity;
+            }
+
+        private:
+            IdentityCache* cache{nullptr};
+            std::uint64_t key{0};
+        };
+
+        template <typename T>
+        using ForeignObjectFor = typename std::conditional<
+            ForeignIdentity<T>::value, ForeignObjectIdentity<T>,
+            typename std::conditional<ForeignInline<T>::value, ForeignObjectInline<T>, ForeignObject<T>>::type>::type;
+
+        template <typename T, typename V> inline void newForeignValue(void* memory, V&& value) {
+            if constexpr (ForeignInline<T>::value) {
+                new (memory) ForeignObjectFor<T>(std::in_place, std::forward<V>(value));
+            } else {
+                new (memory) ForeignObject<T>(std::make_shared<T>(std::forward<V>(value)));
+            }
+        }
+
         class ForeignPtrConvertor {
         public:
             ForeignPtrConvertor() = default;
@@ -86,6 +253,8 @@ namespace wrenbind17 {
             virtual ~ForeignSharedPtrConvertor() = default;
 
             virtual std::shared_ptr<T> cast(Foreign* foreign) const = 0;
+            // Borrowed pointer, valid while the Wren object is alive
+            virtual T* get(Foreign* foreign) const = 0;
         };
 
         template <typename From, typename To>
@@ -97,10 +266,31 @@ namespace wrenbind17 {
             inline std::shared_ptr<To> cast(Foreign* foreign) const override {
                 if (!foreign)
                     throw Exception("Cannot upcast foreign pointer is null and this should not happen");
-                auto* ptr = dynamic_cast<ForeignObject<From>*>(foreign);
-                if (!ptr)
+                if (foreign->typeId != typeIdOf<From>)
+                    throw BadCast("Bad cast while upcasting to a base type");
+                if constexpr (ForeignInline<From>::value) {
+                    throw BadCast("Bad cast an inline foreign value cannot be shared");
+                } else {
+                    auto* ptr = static_cast<ForeignObject<From>*>(foreign);
+                    if constexpr (std::is_base_of<To, From>::value) {
+                        return ptr->shared();
+                    } else {
+                        return std::dynamic_pointer_cast<To>(ptr->shared());
+                    }
+                }
+            }
+
+            inline To* get(Foreign* foreign) const override {
+                if (!foreign)
+                    throw Exception("Cannot upcast foreign pointer is null and this should not happen");
+                if (foreign->typeId != typeIdOf<From>)
                     throw BadCast("Bad cast while upcasting to a base type");
-                return std::dynamic_pointer_cast<To>(ptr->shared());
+                auto* ptr = static_cast<From*>(static_cast<ForeignObjectFor<From>*>(foreign)->get());
+                if constexpr (std::is_base_of<To, From>::value) {
+                    return ptr;
+                } else {
+                    return dynamic_cast<To*>(ptr);
+                }
             }
         };
 
@@ -3,13 +3,14 @@
 #include <wren.hpp>
 
 #include <string>
+#include <string_view>
 #include <memory>
 
 #include "object.hpp"
 
 namespace wrenbind17 {
-    void getClassType(WrenVM* vm, std::string& module, std::string& name, size_t hash);
-    detail::ForeignPtrConvertor* getClassCast(WrenVM* vm, size_t hash, size_t other);
+    bool hasClassCast(WrenVM* vm, detail::TypeId from, detail::TypeId to);
+    detail::ForeignPtrConvertor* getClassCast(WrenVM* vm, detail::TypeId from, detail::TypeId to);
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
     namespace detail {
@@ -43,7 +44,7 @@ namespace wrenbind17 {
 
             auto slot = wrenGetSlotForeign(vm, idx);
             const auto foreign = reinterpret_cast<Foreign*>(slot);
-            return foreign->hash() == typeid(T).hash_code();
+            return foreign->typeId == typeIdOf<T>;
         }
 
         template <> inline bool is<bool>(WrenVM* vm, const int idx) {
@@ -54,6 +55,10 @@ namespace wrenbind17 {
             return wrenGetSlotType(vm, idx) == WrenType::WREN_TYPE_STRING;
         }
 
+        template <> inline bool is<std::string_view>(WrenVM* vm, const int idx) {
+            return wrenGetSlotType(vm, idx) == WrenType::WREN_TYPE_STRING;
+        }
+
         template <> inline bool is<std::nullptr_t>(WrenVM* vm, const int idx) {
             return wrenGetSlotType(vm, idx) == WrenType::WREN_TYPE_NULL;
         }
@@ -152,6 +157,12 @@ namespace wrenbind17 {
             }
         };
 
+        template <> struct CheckSlot<const char*> {
+            static bool f(WrenVM* vm, const int idx) {
+                return is<std::string>(vm, idx);
+            }
+        };
+
         // ============================================================================================================
         //                                       BASIC TYPES
         // ============================================================================================================
@@ -162,27 +173,32 @@ namespace wrenbind17 {
                               " expected " + std::string(wrenSlotTypeToStr(Type)));
         }
 
+        template <typename T> ForeignSharedPtrConvertor<T>* getSlotConvertor(WrenVM* vm, const Foreign* foreign) {
+            try {
+                auto base = getClassCast(vm, foreign->typeId, typeIdOf<T>);
+                auto derived = reinterpret_cast<ForeignSharedPtrConvertor<T>*>(base);
+                if (!derived) {
+                    throw BadCast("Bad cast the value cannot be upcast to the expected type");
+                }
+                return derived;
+            } catch (std::out_of_range& e) {
+                (void)e;
+                throw BadCast("Bad cast the value is not the expected type");
+            }
+        }
+
         template <typename T> std::shared_ptr<T> getSlotForeign(WrenVM* vm, void* slot) {
             using Type = typename std::remove_const<typename std::remove_pointer<T>::type>::type;
-            using ForeignTypeConvertor = ForeignSharedPtrConvertor<Type>;
+            // A shared_ptr to inline storage would dangle once the Wren object is collected
+            static_assert(!ForeignInline<Type>::value,
+                          "ForeignInline types are owned by the Wren object, take T&, const T& or T* instead");
 
             const auto foreign = reinterpret_cast<Foreign*>(slot);
-            if (foreign->hash() != typeid(Type).hash_code()) {
-                try {
-                    auto base = getClassCast(vm, foreign->hash(), typeid(Type).hash_code());
-                    auto derived = reinterpret_cast<ForeignTypeConvertor*>(base);
-                    if (!derived) {
-                        throw BadCast("Bad cast the value cannot be upcast to the expected type");
-                    }
-                    return derived->cast(foreign);
-                } catch (std::out_of_range& e) {
-                    (void)e;
-                    throw BadCast("Bad cast the value is not the expected type");
-                }
+            if (foreign->typeId != typeIdOf<Type>) {
+                return getSlotConvertor<Type>(vm, foreign)->cast(foreign);
             }
 
-            auto ptr = reinterpret_cast<ForeignObject<Type>*>(foreign);
-            return ptr->shared();
+            return static_cast<ForeignObject<Type>*>(foreign)->shared();
         }
 
         template <typename T> const std::shared_ptr<T> getSlotForeign(WrenVM* vm, const int idx) {
@@ -190,14 +206,38 @@ namespace wrenbind17 {
             return getSlotForeign<T>(vm, wrenGetSlotForeign(vm, idx));
         }
 
+        // Raw pointer into the foreign object, valid while the object stays in its slot.
+        // Exact type matches are read directly, without copying the shared_ptr.
+        template <typename T> T* getSlotForeignPtr(WrenVM* vm, const int idx) {
+            using Type = typename std::remove_const<T>::type;
+
+            validate<WrenType::WREN_TYPE_FOREIGN>(vm, idx);
+            const auto foreign = reinterpret_cast<Foreign*>(wrenGetSlotForeign(vm, idx));
+            if (foreign->typeId == typeIdOf<Type>) {
+                if constexpr (ForeignInline<Type>::value) {
+                    return static_cast<ForeignObjectInline<Type>*>(foreign)->value();
+                } else {
+                    return static_cast<ForeignObject<Type>*>(foreign)->ptr.get();
+                }
+            }
+            return getSlotConvertor<Type>(vm, foreign)->get(foreign);
+        }
+
         template <typename T> T getSlot(WrenVM* vm, int idx) {
             static_assert(!std::is_same<std::string, T>(), "type can't be std::string");
             static_assert(!is_shared_ptr<T>::value, "type can't be shared_ptr<T>");
-            validate<WrenType::WREN_TYPE_FOREIGN>(vm, idx);
-            return *getSlotForeign<typename std::remove_reference<T>::type>(vm, idx).get();
+            if constexpr (std::is_enum<T>::value) {
+                validate<WrenType::WREN_TYPE_NUM>(vm, idx);
+                return static_cast<T>(static_cast<typename std::underlying_type<T>::type>(wrenGetSlotDouble(vm, idx)));
+            } else {
+                return *getSlotForeignPtr<typename std::remove_reference<T>::type>(vm, idx);
+            }
         }
 
         template <typename T> struct PopHelper {
+            // Reads the slot through getSlot: a bound foreign class unless getSlot is specialized
+            static constexpr bool foreignSlot = true;
+
             static inline T f(WrenVM* vm, int idx) {
                 return getSlot<T>(vm, idx);
             }
@@ -210,16 +250,22 @@ namespace wrenbind17 {
                     return nullptr;
                 else if (type != WrenType::WREN_TYPE_FOREIGN)
                     throw BadCast("Bad cast when getting value from Wren");
-                return getSlotForeign<typename std::remove_const<T>::type>(vm, idx).get();
+                return getSlotForeignPtr<typename std::remove_const<T>::type>(vm, idx);
             }
         };
 
         template <typename T> struct PopHelper<const T&> {
-            static inline const T& f(WrenVM* vm, int idx) {
+            using Result = typename std::conditional<std::is_enum<T>::value, T, const T&>::type;
+
+            static inline Result f(WrenVM* vm, int idx) {
                 static_assert(!std::is_same<std::string, T>(), "type can't be std::string");
                 static_assert(!std::is_same<std::nullptr_t, T>(), "type can't be std::nullptr_t");
                 static_assert(!is_shared_ptr<T>::value, "type can't be shared_ptr<T>");
-                return *getSlotForeign<T>(vm, idx).get();
+                if constexpr (std::is_enum<T>::value) {
+                    return getSlot<T>(vm, idx);
+                } else {
+                    return *getSlotForeignPtr<T>(vm, idx);
+                }
             }
         };
 
@@ -252,7 +298,17 @@ namespace wrenbind17 {
 
         template <> inline std::string getSlot(WrenVM* vm, int idx) {
             validate<WrenType::WREN_TYPE_STRING>(vm, idx);
-            return std::string(wrenGetSlotString(vm, idx));
+            int length = 0;
+            const char* bytes = wrenGetSlotBytes(vm, idx, &length);
+            return std::string(bytes, static_cast<size_t>(length));
+        }
+
+        // Points into the ObjString held by the slot, valid for the duration of the foreign call
+        template <> inline std::string_view getSlot(WrenVM* vm, int idx) {
+            validate<WrenType::WREN_TYPE_STRING>(vm, idx);
+            int length = 0;
+            const char* bytes = wrenGetSlotBytes(vm, idx, &length);
+            return std::string_view(bytes, static_cast<size_t>(length));
         }
 
         template <> inline std::nullptr_t getSlot(WrenVM* vm, int idx) {
@@ -338,6 +394,7 @@ namespace wrenbind17 {
     };
 
         WRENBIND17_POP_HELPER(std::string)
+        WRENBIND17_POP_HELPER(std::string_view)
         WRENBIND17_POP_HELPER(std::nullptr_t)
         WRENBIND17_POP_HELPER(bool)
         WRENBIND17_POP_HELPER(int8_t)
@@ -353,6 +410,112 @@ namespace wrenbind17 {
         WRENBIND17_POP_HELPER(unsigned char)
         WRENBIND17_POP_HELPER(float)
         WRENBIND17_POP_HELPER(double)
+
+        // Same lifetime as std::string_view above, Wren strings are always null terminated
+        template <> struct PopHelper<const char*> {
+            static inline const char* f(WrenVM* vm, int idx) {
+                validate<WrenType::WREN_TYPE_STRING>(vm, idx);
+                return wrenGetSlotString(vm, idx);
+            }
+        };
+
+        // ============================================================================================================
+        //                                       NON-THROWING ARGUMENT CHECKS
+        // ============================================================================================================
+        // Used by the exception-free calling convention (WRENBIND17_NO_EXCEPTIONS). f() returns nullptr when
+        // PopHelper can read the slot, otherwise the error message. exact is false when PopHelper may still
+        // fail after a successful check (list elements are not inspected), such calls keep the try/catch.
+        inline const char* checkSlotType(WrenVM* vm, const int idx, const WrenType expected) {
+            if (wrenGetSlotType(vm, idx) == expected)
+                return nullptr;
+            switch (expected) {
+                case WREN_TYPE_BOOL:
+                    return "Bad cast when getting value from Wren expected bool";
+                case WREN_TYPE_NUM:
+                    return "Bad cast when getting value from Wren expected number";
+                case WREN_TYPE_STRING:
+                    return "Bad cast when getting value from Wren expected string";
+                case WREN_TYPE_NULL:
+                    return "Bad cast when getting value from Wren expected null";
+                case WREN_TYPE_LIST:
+                    return "Bad cast when getting value from Wren expected list";
+                case WREN_TYPE_MAP:
+                    return "Bad cast when getting value from Wren expected map";
+                case WREN_TYPE_FOREIGN:
+                    return "Bad cast when getting value from Wren expected instance";
+                case WREN_TYPE_UNKNOWN:
+                    return "Bad cast when getting value from Wren expected class, function, fiber or range";
+                default:
+                    return "Bad cast when getting value from Wren";
+            }
+        }
+
+        template <typename T> inline const char* checkSlotForeign(WrenVM* vm, const int idx) {
+            using Type = typename std::remove_cv<T>::type;
+            if (const auto error = checkSlotType(vm, idx, WrenType::WREN_TYPE_FOREIGN))
+                return error;
+            const auto foreign = reinterpret_cast<Foreign*>(wrenGetSlotForeign(vm, idx));
+            if (foreign->typeId != typeIdOf<Type> && !hasClassCast(vm, foreign->typeId, typeIdOf<Type>))
+                return "Bad cast the value is not the expected type";
+            return nullptr;
+        }
+
+        template <typename T>
+        inline constexpr bool isStringLike = std::is_same<T, std::string>::value ||
+                                             std::is_same<T, std::string_view>::value ||
+                                             std::is_same<T, const char*>::value;
+
+        template <typename T>
+        inline constexpr bool isListLike = !isStringLike<T> && requires {
+            typename T::value_type;
+            typename T::iterator;
+        };
+
+        // Class types PopHelper reads as a bound foreign class, the rest have their own PopHelper
+        template <typename T>
+        inline constexpr bool isForeignSlot = std::is_class<T>::value && !isStringLike<T> && !isListLike<T> &&
+                                              !std::is_same<T, Handle>::value && !is_shared_ptr<T>::value &&
+                                              requires { PopHelper<T>::foreignSlot; };
+
+        template <typename T> struct ArgCheck {
+            // Without a check of its own a type is left to PopHelper and keeps the try/catch
+            static constexpr bool exact =
+                !isListLike<T> && (!std::is_class<T>::value || isStringLike<T> || std::is_same<T, Handle>::value ||
+                                   is_shared_ptr<T>::value || isForeignSlot<T>);
+
+            static inline const char* f(WrenVM* vm, const int idx) {
+                if constexpr (std::is_same<T, bool>::value) {
+                    return checkSlotType(vm, idx, WrenType::WREN_TYPE_BOOL);
+                } else if constexpr (std::is_arithmetic<T>::value || std::is_enum<T>::value) {
+                    return checkSlotType(vm, idx, WrenType::WREN_TYPE_NUM);
+                } else if constexpr (isStringLike<T>) {
+                    return checkSlotType(vm, idx, WrenType::WREN_TYPE_STRING);
+                } else if constexpr (std::is_same<T, std::nullptr_t>::value) {
+                    return checkSlotType(vm, idx, WrenType::WREN_TYPE_NULL);
+                } else if constexpr (std::is_same<T, Handle>::value) {
+                    // Same as getSlot<Handle>
+                    return checkSlotType(vm, idx, WrenType::WREN_TYPE_UNKNOWN);
+                } else if constexpr (std::is_pointer<T>::value) {
+                    if (wrenGetSlotType(vm, idx) == WrenType::WREN_TYPE_NULL)
+                        return nullptr;
+                    return checkSlotForeign<typename std::remove_pointer<T>::type>(vm, idx);
+                } else if constexpr (is_shared_ptr<T>::value) {
+                    if (wrenGetSlotType(vm, idx) == WrenType::WREN_TYPE_NULL)
+                        return nullptr;
+                    return checkSlotForeign<typename T::element_type>(vm, idx);
+                } else if constexpr (isListLike<T>) {
+                    if (wrenGetSlotType(vm, idx) == WrenType::WREN_TYPE_LIST)
+                        return nullptr;
+                    return checkSlotForeign<T>(vm, idx);
+                } else if constexpr (isForeignSlot<T>) {
+                    return checkSlotForeign<T>(vm, idx);
+                } else {
+                    (void)vm;
+                    (void)idx;
+                    return nullptr;
+                }
+            }
+        };
     } // namespace detail
 #endif
 } // namespace wrenbind17
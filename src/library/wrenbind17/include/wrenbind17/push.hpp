@@ -9,75 +9,103 @@
 
 namespace wrenbind17 {
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
-    void getClassType(WrenVM* vm, std::string& module, std::string& name, size_t hash);
-    bool isClassRegistered(WrenVM* vm, const size_t hash);
-    detail::ForeignPtrConvertor* getClassCast(WrenVM* vm, size_t hash, size_t other);
+    const detail::ClassType& getClassType(WrenVM* vm, detail::TypeId id);
+    bool isClassRegistered(WrenVM* vm, detail::TypeId id);
+    detail::IdentityCache& getIdentityCache(WrenVM* vm);
 
     namespace detail {
         template <typename T> struct PushHelper;
 
+        // Loads the Wren class bound to T into the slot. Returns false after aborting the fiber
+        // when the class is not registered and exceptions are disabled.
+        template <typename T> inline bool pushClass(WrenVM* vm, int idx) {
+            if (!isClassRegistered(vm, typeIdOf<T>)) {
+#ifdef WRENBIND17_NO_EXCEPTIONS
+                abortFiber(vm, "Class type not registered in Wren VM");
+                return false;
+#else
+                throw BadCast("Class type not registered in Wren VM");
+#endif
+            }
+            const auto& type = getClassType(vm, typeIdOf<T>);
+            wrenEnsureSlots(vm, idx + 1);
+            wrenGetVariable(vm, type.module.c_str(), type.name.c_str(), idx);
+            return true;
+        }
+
+        // Pushes the cached Wren object for the value's identity key, creating and caching it
+        // on a miss. A zero key is never cached.
+        template <typename T, typename V> void pushIdentity(WrenVM* vm, int idx, V&& value) {
+            auto& cache = getIdentityCache(vm);
+            const std::uint64_t key = ForeignIdentity<T>::key(value);
+            if (key != 0) {
+                if (auto* object = cache.find(typeIdOf<T>, key)) {
+                    wrenEnsureSlots(vm, idx + 1);
+                    wrenSetSlotObject(vm, idx, object);
+                    return;
+                }
+            }
+            if (!pushClass<T>(vm, idx))
+                return;
+
+            auto memory = wrenSetSlotNewForeign(vm, idx, idx, sizeof(ForeignObjectIdentity<T>));
+            auto* foreign = new (memory) ForeignObjectIdentity<T>(std::in_place, std::forward<V>(value));
+            if (key != 0) {
+                cache.insert(typeIdOf<T>, key, wrenGetSlotObject(vm, idx));
+                foreign->track(&cache, key);
+            }
+        }
+
         template <typename T> void pushAsConstRef(WrenVM* vm, int idx, const T& value) {
             static_assert(!std::is_same<int, typename std::remove_const<T>::type>(), "type can't be int");
             static_assert(!std::is_same<std::string, typename std::remove_const<T>::type>(),
                           "type can't be std::string");
             static_assert(!is_shared_ptr<T>::value, "type can't be shared_ptr<T>");
-            try {
-                std::string module;
-                std::string klass;
-                getClassType(vm, module, klass, typeid(T).hash_code());
-
-                wrenEnsureSlots(vm, idx + 1);
-                wrenGetVariable(vm, module.c_str(), klass.c_str(), idx);
-
-                auto memory = wrenSetSlotNewForeign(vm, idx, idx, sizeof(ForeignObject<T>));
-                auto* foreign = new (memory) ForeignObject<T>(std::make_shared<T>(value));
-                (void)foreign;
-            } catch (std::out_of_range& e) {
-                (void)e;
-                throw BadCast("Class type not registered in Wren VM");
+            if constexpr (ForeignIdentity<T>::value) {
+                pushIdentity<T>(vm, idx, value);
+                return;
             }
+            if (!pushClass<T>(vm, idx))
+                return;
+
+            auto memory = wrenSetSlotNewForeign(vm, idx, idx, sizeof(ForeignObjectFor<T>));
+            newForeignValue<T>(memory, value);
         }
 
         template <typename T> void pushAsMove(WrenVM* vm, int idx, T&& value) {
             static_assert(!std::is_same<int, T>(), "type can't be int");
             static_assert(!std::is_same<std::string, T>(), "type can't be std::string");
             static_assert(!is_shared_ptr<T>::value, "type can't be shared_ptr<T>");
-            try {
-                std::string module;
-                std::string klass;
-                getClassType(vm, module, klass, typeid(T).hash_code());
-
-                wrenEnsureSlots(vm, idx + 1);
-                wrenGetVariable(vm, module.c_str(), klass.c_str(), idx);
-
-                auto memory = wrenSetSlotNewForeign(vm, idx, idx, sizeof(ForeignObject<T>));
-                auto* foreign = new (memory) ForeignObject<T>(std::make_shared<T>(std::move(value)));
-                (void)foreign;
-            } catch (std::out_of_range& e) {
-                (void)e;
-                throw BadCast("Class type not registered in Wren VM");
+            if constexpr (ForeignIdentity<T>::value) {
+                pushIdentity<T>(vm, idx, std::move(value));
+                return;
             }
+            if (!pushClass<T>(vm, idx))
+                return;
+
+            auto memory = wrenSetSlotNewForeign(vm, idx, idx, sizeof(ForeignObjectFor<T>));
+            newForeignValue<T>(memory, std::move(value));
         }
 
         template <typename T> void pushAsPtr(WrenVM* vm, int idx, T* value) {
             static_assert(!std::is_same<int, T>(), "type can't be int");
             static_assert(!std::is_same<std::string, T>(), "type can't be std::string");
             static_assert(!is_shared_ptr<T>::value, "type can't be shared_ptr<T>");
-            try {
-                std::string module;
-                std::string klass;
-                getClassType(vm, module, klass, typeid(T).hash_code());
-
-                wrenEnsureSlots(vm, idx + 1);
-                wrenGetVariable(vm, module.c_str(), klass.c_str(), idx);
-
-                auto memory = wrenSetSlotNewForeign(vm, idx, idx, sizeof(ForeignObject<T>));
-                auto* foreign = new (memory) ForeignObject<T>(std::shared_ptr<T>(value, [](T* t) {}));
-                (void)foreign;
-            } catch (std::out_of_range& e) {
-                (void)e;
-                throw BadCast("Class type not registered in Wren VM");
+            if constexpr (ForeignInline<T>::value) {
+                // Inline types are values, there is nothing to reference
+                if (!value) {
+                    wrenSetSlotNull(vm, idx);
+                    return;
+                }
+                pushAsConstRef<T>(vm, idx, *value);
+                return;
             }
+            if (!pushClass<T>(vm, idx))
+                return;
+
+            auto memory = wrenSetSlotNewForeign(vm, idx, idx, sizeof(ForeignObject<T>));
+            auto* foreign = new (memory) ForeignObject<T>(std::shared_ptr<T>(value, [](T* t) {}));
+            (void)foreign;
         }
 
         template <typename T> struct PushHelper {
@@ -233,21 +261,20 @@ namespace wrenbind17 {
             static inline void f(WrenVM* vm, int idx, std::shared_ptr<T> value) {
                 static_assert(!std::is_same<std::string, T>(), "type can't be std::string");
                 static_assert(!is_shared_ptr<T>::value, "type can't be shared_ptr<T>");
-                try {
-                    std::string module;
-                    std::string klass;
-                    getClassType(vm, module, klass, typeid(T).hash_code());
-
-                    wrenEnsureSlots(vm, idx + 1);
-                    wrenGetVariable(vm, module.c_str(), klass.c_str(), idx);
-
-                    auto memory = wrenSetSlotNewForeign(vm, idx, idx, sizeof(ForeignObject<T>));
-                    auto* foreign = new (memory) ForeignObject<T>(value);
-                    (void)foreign;
-                } catch (std::out_of_range& e) {
-                    (void)e;
-                    throw BadCast("Class type not registered in Wren VM");
+                if constexpr (ForeignInline<T>::value) {
+                    if (!value) {
+                        wrenSetSlotNull(vm, idx);
+                        return;
+                    }
+                    pushAsConstRef<T>(vm, idx, *value);
+                    return;
                 }
+                if (!pushClass<T>(vm, idx))
+                    return;
+
+                auto memory = wrenSetSlotNewForeign(vm, idx, idx, sizeof(ForeignObject<T>));
+                auto* foreign = new (memory) ForeignObject<T>(value);
+                (void)foreign;
             }
         };
 
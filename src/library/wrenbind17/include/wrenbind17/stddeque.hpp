@@ -12,7 +12,7 @@ namespace wrenbind17 {
     namespace detail {
         template <typename T> struct PushHelper<std::deque<T>> {
             static inline void f(WrenVM* vm, int idx, std::deque<T> value) {
-                if (isClassRegistered(vm, typeid(std::deque<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::deque<T>>)) {
                     pushAsMove<std::deque<T>>(vm, idx, std::move(value));
                 } else {
                     loopAndPushIterable(vm, idx, value.begin(), value.end());
@@ -22,7 +22,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<std::deque<T>*> {
             static inline void f(WrenVM* vm, int idx, std::deque<T>* value) {
-                if (isClassRegistered(vm, typeid(std::deque<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::deque<T>>)) {
                     pushAsPtr<std::deque<T>>(vm, idx, value);
                 } else {
                     loopAndPushIterable(vm, idx, value->begin(), value->end());
@@ -32,7 +32,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<const std::deque<T>&> {
             static inline void f(WrenVM* vm, int idx, const std::deque<T>& value) {
-                if (isClassRegistered(vm, typeid(std::deque<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::deque<T>>)) {
                     pushAsConstRef<std::deque<T>>(vm, idx, value);
                 } else {
                     loopAndPushIterable(vm, idx, value.begin(), value.end());
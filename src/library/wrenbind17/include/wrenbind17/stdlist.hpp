@@ -12,7 +12,7 @@ namespace wrenbind17 {
     namespace detail {
         template <typename T> struct PushHelper<std::list<T>> {
             static inline void f(WrenVM* vm, int idx, std::list<T> value) {
-                if (isClassRegistered(vm, typeid(std::list<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::list<T>>)) {
                     pushAsMove<std::list<T>>(vm, idx, std::move(value));
                 } else {
                     loopAndPushIterable(vm, idx, value.begin(), value.end());
@@ -22,7 +22,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<std::list<T>*> {
             static inline void f(WrenVM* vm, int idx, std::list<T>* value) {
-                if (isClassRegistered(vm, typeid(std::list<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::list<T>>)) {
                     pushAsPtr<std::list<T>>(vm, idx, value);
                 } else {
                     loopAndPushIterable(vm, idx, value->begin(), value->end());
@@ -32,7 +32,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<const std::list<T>&> {
             static inline void f(WrenVM* vm, int idx, const std::list<T>& value) {
-                if (isClassRegistered(vm, typeid(std::list<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::list<T>>)) {
                     pushAsConstRef<std::list<T>>(vm, idx, value);
                 } else {
                     loopAndPushIterable(vm, idx, value.begin(), value.end());
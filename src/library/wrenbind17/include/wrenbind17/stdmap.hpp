@@ -13,7 +13,7 @@ namespace wrenbind17 {
     namespace detail {
         template <typename T> struct PushHelper<std::map<std::string, T>> {
             static inline void f(WrenVM* vm, int idx, std::map<std::string, T> value) {
-                if (isClassRegistered(vm, typeid(std::map<std::string, T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::map<std::string, T>>)) {
                     pushAsMove<std::map<std::string, T>>(vm, idx, std::move(value));
                 } else {
                     loopAndPushKeyPair(vm, idx, value.begin(), value.end());
@@ -23,7 +23,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<std::map<std::string, T>*> {
             static inline void f(WrenVM* vm, int idx, std::map<std::string, T>* value) {
-                if (isClassRegistered(vm, typeid(std::map<std::string, T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::map<std::string, T>>)) {
                     pushAsPtr<std::map<std::string, T>>(vm, idx, value);
                 } else {
                     loopAndPushKeyPair(vm, idx, value->begin(), value->end());
@@ -33,7 +33,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<const std::map<std::string, T>&> {
             static inline void f(WrenVM* vm, int idx, const std::map<std::string, T>& value) {
-                if (isClassRegistered(vm, typeid(std::map<std::string, T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::map<std::string, T>>)) {
                     pushAsConstRef<std::map<std::string, T>>(vm, idx, value);
                 } else {
                     loopAndPushKeyPair(vm, idx, value.begin(), value.end());
@@ -43,7 +43,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<std::unordered_map<std::string, T>> {
             static inline void f(WrenVM* vm, int idx, std::unordered_map<std::string, T> value) {
-                if (isClassRegistered(vm, typeid(std::unordered_map<std::string, T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::unordered_map<std::string, T>>)) {
                     pushAsMove<std::unordered_map<std::string, T>>(vm, idx, std::move(value));
                 } else {
                     loopAndPushKeyPair(vm, idx, value.begin(), value.end());
@@ -53,7 +53,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<std::unordered_map<std::string, T>*> {
             static inline void f(WrenVM* vm, int idx, std::unordered_map<std::string, T>* value) {
-                if (isClassRegistered(vm, typeid(std::unordered_map<std::string, T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::unordered_map<std::string, T>>)) {
                     pushAsPtr<std::unordered_map<std::string, T>>(vm, idx, value);
                 } else {
                     loopAndPushKeyPair(vm, idx, value->begin(), value->end());
@@ -63,7 +63,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<const std::unordered_map<std::string, T>&> {
             static inline void f(WrenVM* vm, int idx, const std::unordered_map<std::string, T>& value) {
-                if (isClassRegistered(vm, typeid(std::unordered_map<std::string, T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::unordered_map<std::string, T>>)) {
                     pushAsConstRef<std::unordered_map<std::string, T>>(vm, idx, value);
                 } else {
                     loopAndPushKeyPair(vm, idx, value.begin(), value.end());
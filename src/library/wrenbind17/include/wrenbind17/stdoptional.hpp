@@ -53,6 +53,16 @@ namespace wrenbind17 {
                 return PopHelper<std::optional<T>>::f(vm, idx);
             }
         };
+
+        template <typename T> struct ArgCheck<std::optional<T>> {
+            static constexpr bool exact = ArgCheck<T>::exact;
+
+            static inline const char* f(WrenVM* vm, const int idx) {
+                if (is<std::nullptr_t>(vm, idx))
+                    return nullptr;
+                return ArgCheck<T>::f(vm, idx);
+            }
+        };
     } // namespace detail
 #endif
 } // namespace wrenbind17
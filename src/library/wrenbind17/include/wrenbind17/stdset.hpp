@@ -13,7 +13,7 @@ namespace wrenbind17 {
     namespace detail {
         template <typename T> struct PushHelper<std::set<T>> {
             static inline void f(WrenVM* vm, int idx, std::set<T> value) {
-                if (isClassRegistered(vm, typeid(std::set<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::set<T>>)) {
                     pushAsMove<std::vector<T>>(vm, idx, std::move(value));
                 } else {
                     loopAndPushIterable(vm, idx, value.begin(), value.end());
@@ -23,7 +23,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<std::set<T>*> {
             static inline void f(WrenVM* vm, int idx, std::set<T>* value) {
-                if (isClassRegistered(vm, typeid(std::set<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::set<T>>)) {
                     pushAsPtr<std::set<T>>(vm, idx, value);
                 } else {
                     loopAndPushIterable(vm, idx, value->begin(), value->end());
@@ -33,7 +33,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<const std::set<T>&> {
             static inline void f(WrenVM* vm, int idx, const std::set<T>& value) {
-                if (isClassRegistered(vm, typeid(std::set<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::set<T>>)) {
                     pushAsConstRef<std::set<T>>(vm, idx, value);
                 } else {
                     loopAndPushIterable(vm, idx, value.begin(), value.end());
@@ -70,7 +70,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<std::unordered_set<T>> {
             static inline void f(WrenVM* vm, int idx, std::unordered_set<T> value) {
-                if (isClassRegistered(vm, typeid(std::unordered_set<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::unordered_set<T>>)) {
                     pushAsMove<std::vector<T>>(vm, idx, std::move(value));
                 } else {
                     loopAndPushIterable(vm, idx, value.begin(), value.end());
@@ -80,7 +80,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<std::unordered_set<T>*> {
             static inline void f(WrenVM* vm, int idx, std::unordered_set<T>* value) {
-                if (isClassRegistered(vm, typeid(std::unordered_set<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::unordered_set<T>>)) {
                     pushAsPtr<std::set<T>>(vm, idx, value);
                 } else {
                     loopAndPushIterable(vm, idx, value->begin(), value->end());
@@ -90,7 +90,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<const std::unordered_set<T>&> {
             static inline void f(WrenVM* vm, int idx, const std::unordered_set<T>& value) {
-                if (isClassRegistered(vm, typeid(std::unordered_set<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::unordered_set<T>>)) {
                     pushAsConstRef<std::set<T>>(vm, idx, value);
                 } else {
                     loopAndPushIterable(vm, idx, value.begin(), value.end());
@@ -73,6 +73,17 @@ namespace wrenbind17 {
                 return loopAndFindVariant<VariantType, Ts...>(vm, idx);
             }
         };
+
+        template <typename... Ts> struct ArgCheck<std::variant<Ts...>> {
+            // The alternative is picked by CheckSlot, same as loopAndFindVariant
+            static constexpr bool exact = true;
+
+            static inline const char* f(WrenVM* vm, const int idx) {
+                if ((CheckSlot<Ts>::f(vm, idx) || ...))
+                    return nullptr;
+                return "Bad cast when getting variant from Wren";
+            }
+        };
     } // namespace detail
 #endif
 } // namespace wrenbind17
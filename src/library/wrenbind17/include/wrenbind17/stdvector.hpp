@@ -12,7 +12,7 @@ namespace wrenbind17 {
     namespace detail {
         template <typename T> struct PushHelper<std::vector<T>> {
             static inline void f(WrenVM* vm, int idx, std::vector<T> value) {
-                if (isClassRegistered(vm, typeid(std::vector<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::vector<T>>)) {
                     pushAsMove<std::vector<T>>(vm, idx, std::move(value));
                 } else {
                     loopAndPushIterable(vm, idx, value.begin(), value.end());
@@ -22,7 +22,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<std::vector<T>*> {
             static inline void f(WrenVM* vm, int idx, std::vector<T>* value) {
-                if (isClassRegistered(vm, typeid(std::vector<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::vector<T>>)) {
                     pushAsPtr<std::vector<T>>(vm, idx, value);
                 } else {
                     loopAndPushIterable(vm, idx, value->begin(), value->end());
@@ -32,7 +32,7 @@ namespace wrenbind17 {
 
         template <typename T> struct PushHelper<const std::vector<T>&> {
             static inline void f(WrenVM* vm, int idx, const std::vector<T>& value) {
-                if (isClassRegistered(vm, typeid(std::vector<T>).hash_code())) {
+                if (isClassRegistered(vm, typeIdOf<std::vector<T>>)) {
                     pushAsConstRef<std::vector<T>>(vm, idx, value);
                 } else {
                     loopAndPushIterable(vm, idx, value.begin(), value.end());
@@ -51,7 +51,8 @@ namespace wrenbind17 {
 
                 std::vector<T> res;
                 const auto size = wrenGetListCount(vm, idx);
-                wrenEnsureSlots(vm, 1);
+                // Elements are read into the next slot, nested lists go one slot further
+                wrenEnsureSlots(vm, idx + 2);
                 res.reserve(size);
                 for (size_t i = 0; i < size; i++) {
                     wrenGetListElement(vm, idx, static_cast<int>(i), idx + 1);
@@ -66,6 +67,13 @@ namespace wrenbind17 {
                 return PopHelper<const std::vector<T>&>::f(vm, idx);
             }
         };
+
+        // A Wren list is accepted wherever a std::vector is, e.g. as a std::variant alternative
+        template <typename T> struct CheckSlot<std::vector<T>> {
+            static bool f(WrenVM* vm, const int idx) {
+                return wrenGetSlotType(vm, idx) == WrenType::WREN_TYPE_LIST || is<std::vector<T>>(vm, idx);
+            }
+        };
     } // namespace detail
 #endif
 } // namespace wrenbind17
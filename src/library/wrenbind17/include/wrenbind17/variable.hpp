@@ -76,6 +76,20 @@ namespace wrenbind17 {
         return Variable(std::make_shared<Handle>(getSharedVm(vm), wrenGetSlotHandle(vm, idx)));
     }
 
+    template <> struct detail::PopHelper<const Variable&> {
+        static inline Variable f(WrenVM* vm, const int idx) {
+            return getSlot<Variable>(vm, idx);
+        }
+    };
+
+    template <> struct detail::ArgCheck<Variable> {
+        static constexpr bool exact = true;
+
+        static inline const char* f(WrenVM* vm, const int idx) {
+            return checkSlotType(vm, idx, WrenType::WREN_TYPE_UNKNOWN);
+        }
+    };
+
     template <> inline bool detail::is<Variable>(WrenVM* vm, const int idx) {
         return wrenGetSlotType(vm, idx) == WREN_TYPE_UNKNOWN;
     }
@@ -18,17 +18,6 @@
 #include "module.hpp"
 #include "variable.hpp"
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-namespace std {
-    template <> struct hash<std::pair<size_t, size_t>> {
-        inline size_t operator()(const std::pair<size_t, size_t>& v) const {
-            const std::hash<size_t> hasher;
-            return hasher(v.first) ^ hasher(v.second);
-        }
-    };
-} // namespace std
-#endif
-
 /**
  * @ingroup wrenbind17
  */
@@ -82,6 +71,12 @@ namespace wrenbind17 {
                                       const std::string& name)>
         PathResolveFn;
 
+    /**
+     * @ingroup wrenbind17
+     * @brief Called at the start and the end of each garbage collection with the heap size in bytes
+     */
+    typedef std::function<void(WrenGCPhase phase, size_t bytesAllocated)> GcFn;
+
     /**
      * @ingroup wrenbind17
      * @brief Holds the entire Wren VM from which all of the magic happens
@@ -234,8 +229,14 @@ namespace wrenbind17 {
                 }
                 self.lastError += ss.str();
             };
+            data->config.gcFn = [](WrenVM* vm, WrenGCPhase phase, size_t bytesAllocated) {
+                auto& self = *reinterpret_cast<VM::Data*>(wrenGetUserData(vm));
+                if (self.gcFn)
+                    self.gcFn(phase, bytesAllocated);
+            };
 
-            data->vm = std::shared_ptr<WrenVM>(wrenNewVM(&data->config), [](WrenVM* ptr) { wrenFreeVM(ptr); });
+            data->vm = std::shared_ptr<WrenVM>(wrenNewVM(&data->config),
+                                               [identities = data->identities](WrenVM* ptr) { wrenFreeVM(ptr); });
         }
 
         inline VM(const VM& other) = delete;
@@ -332,25 +333,25 @@ namespace wrenbind17 {
             return it->second;
         }
 
-        inline void addClassType(const std::string& module, const std::string& name, const size_t hash) {
-            data->addClassType(module, name, hash);
+        inline void addClassType(const std::string& module, const std::string& name, const detail::TypeId id) {
+            data->addClassType(module, name, id);
         }
 
-        inline void getClassType(std::string& module, std::string& name, const size_t hash) {
-            data->getClassType(module, name, hash);
+        inline const detail::ClassType& getClassType(const detail::TypeId id) const {
+            return data->getClassType(id);
         }
 
-        inline bool isClassRegistered(const size_t hash) const {
-            return data->isClassRegistered(hash);
+        inline bool isClassRegistered(const detail::TypeId id) const {
+            return data->isClassRegistered(id);
         }
 
-        inline void addClassCast(std::shared_ptr<detail::ForeignPtrConvertor> convertor, const size_t hash,
-                                 const size_t other) {
-            data->addClassCast(std::move(convertor), hash, other);
+        inline void addClassCast(std::shared_ptr<detail::ForeignPtrConvertor> convertor, const detail::TypeId from,
+                                 const detail::TypeId to) {
+            data->addClassCast(std::move(convertor), from, to);
         }
 
-        inline detail::ForeignPtrConvertor* getClassCast(const size_t hash, const size_t other) {
-            return data->getClassCast(hash, other);
+        inline detail::ForeignPtrConvertor* getClassCast(const detail::TypeId from, const detail::TypeId to) const {
+            return data->getClassCast(from, to);
         }
 
         inline std::string getLastError() {
@@ -395,6 +396,14 @@ namespace wrenbind17 {
             data->pathResolveFn = fn;
         }
 
+        /*!
+         * @brief Set a function that is notified about garbage collections
+         * @see GcFn
+         */
+        inline void setGcFunc(const GcFn& fn) {
+            data->gcFn = fn;
+        }
+
         /*!
          * @brief Runs the garbage collector
          */
@@ -402,42 +411,67 @@ namespace wrenbind17 {
             wrenCollectGarbage(data->vm.get());
         }
 
+        /*!
+         * @brief Returns the raw WrenVM, for code that talks to the Wren C API directly
+         */
+        inline WrenVM* getVm() const {
+            return data->vm.get();
+        }
+
         class Data {
         public:
             std::shared_ptr<WrenVM> vm;
             WrenConfiguration config;
             std::vector<std::string> paths;
             std::unordered_map<std::string, ForeignModule> modules;
-            std::unordered_map<size_t, std::string> classToModule;
-            std::unordered_map<size_t, std::string> classToName;
-            std::unordered_map<std::pair<size_t, size_t>, std::shared_ptr<detail::ForeignPtrConvertor>> classCasting;
+            // Both tables are indexed by detail::TypeId, classCasting as [from][to]
+            std::vector<detail::ClassType> classTypes;
+            std::vector<std::vector<std::shared_ptr<detail::ForeignPtrConvertor>>> classCasting;
+            // Shared with the WrenVM deleter, finalizers still reach it while the VM is freed
+            std::shared_ptr<detail::IdentityCache> identities{std::make_shared<detail::IdentityCache>()};
             std::string lastError;
             std::string nextError;
             PrintFn printFn;
             LoadFileFn loadFileFn;
             PathResolveFn pathResolveFn;
+            GcFn gcFn;
+
+            inline void addClassType(const std::string& module, const std::string& name, const detail::TypeId id) {
+                if (id >= classTypes.size())
+                    classTypes.resize(id + 1);
+                if (classTypes[id].name.empty())
+                    classTypes[id] = detail::ClassType{module, name};
+            }
 
-            inline void addClassType(const std::string& module, const std::string& name, const size_t hash) {
-                classToModule.insert(std::make_pair(hash, module));
-                classToName.insert(std::make_pair(hash, name));
+            inline const detail::ClassType& getClassType(const detail::TypeId id) const {
+                if (!isClassRegistered(id))
+                    throw std::out_of_range("Class type not registered");
+                return classTypes[id];
             }
 
-            inline void getClassType(std::string& module, std::string& name, const size_t hash) {
-                module = classToModule.at(hash);
-                name = classToName.at(hash);
+            inline bool isClassRegistered(const detail::TypeId id) const {
+                return id < classTypes.size() && !classTypes[id].name.empty();
             }
 
-            inline bool isClassRegistered(const size_t hash) const {
-                return classToModule.find(hash) != classToModule.end();
+            inline void addClassCast(std::shared_ptr<detail::ForeignPtrConvertor> convertor, const detail::TypeId from,
+                                     const detail::TypeId to) {
+                if (from >= classCasting.size())
+                    classCasting.resize(from + 1);
+                auto& row = classCasting[from];
+                if (to >= row.size())
+                    row.resize(to + 1);
+                if (!row[to])
+                    row[to] = std::move(convertor);
             }
 
-            inline void addClassCast(std::shared_ptr<detail::ForeignPtrConvertor> convertor, const size_t hash,
-                                     const size_t other) {
-                classCasting.insert(std::make_pair(std::make_pair(hash, other), std::move(convertor)));
+            inline bool hasClassCast(const detail::TypeId from, const detail::TypeId to) const {
+                return from < classCasting.size() && to < classCasting[from].size() && classCasting[from][to];
             }
 
-            inline detail::ForeignPtrConvertor* getClassCast(const size_t hash, const size_t other) {
-                return classCasting.at(std::pair(hash, other)).get();
+            inline detail::ForeignPtrConvertor* getClassCast(const detail::TypeId from, const detail::TypeId to) const {
+                if (!hasClassCast(from, to))
+                    throw std::out_of_range("Class cast not registered");
+                return classCasting[from][to].get();
             }
 
             inline std::string getLastError() {
@@ -462,31 +496,42 @@ namespace wrenbind17 {
         assert(self->vm);
         return self->vm;
     }
-    inline void addClassType(WrenVM* vm, const std::string& module, const std::string& name, const size_t hash) {
+    inline void addClassType(WrenVM* vm, const std::string& module, const std::string& name,
+                             const detail::TypeId id) {
+        assert(vm);
+        auto self = reinterpret_cast<VM::Data*>(wrenGetUserData(vm));
+        self->addClassType(module, name, id);
+    }
+    inline const detail::ClassType& getClassType(WrenVM* vm, const detail::TypeId id) {
+        assert(vm);
+        auto self = reinterpret_cast<VM::Data*>(wrenGetUserData(vm));
+        return self->getClassType(id);
+    }
+    inline bool isClassRegistered(WrenVM* vm, const detail::TypeId id) {
         assert(vm);
         auto self = reinterpret_cast<VM::Data*>(wrenGetUserData(vm));
-        self->addClassType(module, name, hash);
+        return self->isClassRegistered(id);
     }
-    inline void getClassType(WrenVM* vm, std::string& module, std::string& name, const size_t hash) {
+    inline void addClassCast(WrenVM* vm, std::shared_ptr<detail::ForeignPtrConvertor> convertor,
+                             const detail::TypeId from, const detail::TypeId to) {
         assert(vm);
         auto self = reinterpret_cast<VM::Data*>(wrenGetUserData(vm));
-        self->getClassType(module, name, hash);
+        self->addClassCast(std::move(convertor), from, to);
     }
-    inline bool isClassRegistered(WrenVM* vm, const size_t hash) {
+    inline bool hasClassCast(WrenVM* vm, const detail::TypeId from, const detail::TypeId to) {
         assert(vm);
         auto self = reinterpret_cast<VM::Data*>(wrenGetUserData(vm));
-        return self->isClassRegistered(hash);
+        return self->hasClassCast(from, to);
     }
-    inline void addClassCast(WrenVM* vm, std::shared_ptr<detail::ForeignPtrConvertor> convertor, const size_t hash,
-                             const size_t other) {
+    inline detail::ForeignPtrConvertor* getClassCast(WrenVM* vm, const detail::TypeId from, const detail::TypeId to) {
         assert(vm);
         auto self = reinterpret_cast<VM::Data*>(wrenGetUserData(vm));
-        self->addClassCast(std::move(convertor), hash, other);
+        return self->getClassCast(from, to);
     }
-    inline detail::ForeignPtrConvertor* getClassCast(WrenVM* vm, const size_t hash, const size_t other) {
+    inline detail::IdentityCache& getIdentityCache(WrenVM* vm) {
         assert(vm);
         auto self = reinterpret_cast<VM::Data*>(wrenGetUserData(vm));
-        return self->getClassCast(hash, other);
+        return *self->identities;
     }
     inline std::string getLastError(WrenVM* vm) {
         assert(vm);
@@ -1,4 +1,9 @@
 #include "pch.h"
+#include "Wren/Wrappers/ActiveEffectIndex.hpp"
+#include "Wren/Wrappers/ActorHandleCache.hpp"
+#include "Wren/Wrappers/Commands.hpp"
+#include "Wren/Wrappers/KeywordBitsets.hpp"
+#include "Wren/Wrappers/Storage.hpp"
 
 import WrenRim.Core.LoggerSetup;
 import WrenRim.UI.SKSEMenu;
@@ -22,6 +27,7 @@ auto skse_message_handle(SKSE::MessagingInterface::Message* message) -> void
   case SKSE::MessagingInterface::kDataLoaded: {
     // 1. Load Config
     config::manager::get_singleton()->load();
+    core::logger_setup::apply_config();
 
     // 2. Init Script Engine
     wren::script_engine::engine::get_singleton()->initialize();
@@ -34,7 +40,17 @@ auto skse_message_handle(SKSE::MessagingInterface::Message* message) -> void
     break;
   }
   case SKSE::MessagingInterface::kNewGame:
-  case SKSE::MessagingInterface::kPreLoadGame:
+  case SKSE::MessagingInterface::kPreLoadGame: {
+    // Указатели на эффекты из прошлой сессии больше не действительны
+    wren::wrappers::active_effect_index::get_singleton()->clear();
+    // Отложенные изменения относятся к актерам прошлой сессии
+    wren::wrappers::command_buffer::get_singleton()->clear();
+    // Формы прошлой сессии могли быть удалены
+    wren::wrappers::keyword_bitsets::get_singleton()->clear();
+    // Хендлы и удерживаемые актеры прошлой сессии
+    wren::wrappers::actor_handle_cache::get_singleton()->clear();
+    break;
+  }
   case SKSE::MessagingInterface::kPostLoadGame:
   case SKSE::MessagingInterface::kSaveGame:
   case SKSE::MessagingInterface::kDeleteGame:
@@ -62,6 +78,11 @@ SKSEPluginLoad(const SKSE::LoadInterface* skse)
     return false;
   }
 
+  serialization->SetUniqueID(wren::wrappers::storage::unique_id);
+  serialization->SetSaveCallback(wren::wrappers::storage::on_save);
+  serialization->SetLoadCallback(wren::wrappers::storage::on_load);
+  serialization->SetRevertCallback(wren::wrappers::storage::on_revert);
+
   logger::info("{} has finished loading.", plugin->GetName());
 
   return true;
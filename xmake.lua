@@ -3,7 +3,10 @@ set_xmakever("3.0.5")
 
 -- includes
 -- Убедитесь, что переменная окружения CommonLibSSE-NG установлена
-includes(os.getenv("CommonLibSSE-NG"))
+-- (нужна только плагину; wrenrim-host собирается без нее)
+if is_plat("windows") then
+    includes(os.getenv("CommonLibSSE-NG"))
+end
 
 -- set project
 set_project("WrenRim")
@@ -29,6 +32,9 @@ add_rules("plugin.vsxmake.autoupdate")
 
 -- add requirements
 add_requires("spdlog", "fmt")
+if not is_plat("windows") then
+    add_requires("benchmark")
+end
 
 -- set configs
 set_config("skyrim_vr", true)
@@ -36,6 +42,16 @@ set_config("skyrim_ae", true)
 set_config("skyrim_se", true)
 set_config("skse_xbyak", true)
 
+-- Options
+-- Биндинги wrenbind17 без try/catch: аргументы проверяются заранее,
+-- ошибки скриптов возвращаются через wrenbind17::Result
+option("wrenbind17_no_exceptions")
+set_default(true)
+set_showmenu(true)
+set_description("Exception-free calling convention for Wren foreign bindings")
+add_defines("WRENBIND17_NO_EXCEPTIONS")
+option_end()
+
 -- Custom rules
 rule("whren_scripts")
 set_extensions(".wren")
@@ -44,11 +60,14 @@ rule("papyrus_source")
 set_extensions(".psc")
 
 -- TARGET
+if is_plat("windows") then
 target("zzWrenRim")
 
 -- add dependencies to target
 add_deps("commonlibsse-ng")
 
+add_options("wrenbind17_no_exceptions")
+
 -- CommonLibSSE-NG plugin info
 add_rules("commonlibsse-ng.plugin", {
     name = "WrenRim",
@@ -158,3 +177,54 @@ after_build(function(target)
         print("WARNING: Source directory 'src/WrenRim' not found!")
     end
 end)
+target_end()
+end
+
+-- Headless host: Std и моды без игры, против заглушек RE из host/stub
+-- xmake f -p linux && xmake build wrenrim-host && xmake run wrenrim-host --frames 600
+target("wrenrim-host-common")
+set_kind("static")
+set_default(false)
+add_packages("spdlog", "fmt", { public = true })
+add_defines("SPDLOG_FMT_EXTERNAL", { public = true })
+
+add_options("wrenbind17_no_exceptions")
+
+-- host/stub раньше src: pch.h и заголовки RE/SKSE берутся из заглушек
+add_includedirs("host", "host/stub", { public = true })
+add_includedirs("src", { public = true })
+add_includedirs("src/library/", { public = true })
+add_includedirs("src/library/wren/src/vm", { public = true })
+add_includedirs("src/library/wren/src/include", { public = true })
+add_includedirs("src/library/wren/src/optional", { public = true })
+add_includedirs("src/library/wrenbind17/include/", { public = true })
+
+add_headerfiles("host/**.h")
+-- Модули движка скриптов, общие с плагином; public — их импортируют host и bench
+add_files("src/Wren/BindingManager.cpp", "src/Wren/ScriptRuntime.cpp", { public = true })
+add_files("src/library/wren/src/vm/*.c", "src/library/wren/src/optional/*.c", {
+    warnings = "none",
+    defines = { "WREN_OPT_META", "WREN_NAN_TAGGING=1" }
+})
+target_end()
+
+target("wrenrim-host")
+set_kind("binary")
+set_default(false)
+add_deps("wrenrim-host-common")
+add_options("wrenbind17_no_exceptions")
+add_files("host/main.cpp")
+set_rundir("$(projectdir)")
+target_end()
+
+-- Микробенчмарки (google-benchmark), JSON в stdout:
+-- xmake build wrenrim-bench && xmake run wrenrim-bench --benchmark_out=bench.json
+target("wrenrim-bench")
+set_kind("binary")
+set_default(false)
+add_deps("wrenrim-host-common")
+add_options("wrenbind17_no_exceptions")
+add_packages("benchmark")
+add_files("host/Bench.cpp")
+set_rundir("$(projectdir)")
+target_end()